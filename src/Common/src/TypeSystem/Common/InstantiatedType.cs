@@ -277,6 +277,14 @@ namespace Internal.TypeSystem
             }
         }
 
+        public override bool IsAbstract
+        {
+            get
+            {
+                return _typeDef.IsAbstract;
+            }
+        }
+
         public override bool IsModuleType
         {
             get
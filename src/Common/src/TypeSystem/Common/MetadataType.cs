@@ -80,6 +80,11 @@ namespace Internal.TypeSystem
         /// </summary>
         public abstract bool IsSealed { get; }
 
+        /// <summary>
+        /// If true, the type cannot be instantiated.
+        /// </summary>
+        public abstract bool IsAbstract { get; }
+
         /// <summary>
         /// Returns true if the type has given custom attribute.
         /// </summary>
@@ -315,7 +315,7 @@ namespace Internal.TypeSystem
         // This function looks for the base type method that defines the slot for a method
         // This is either the newslot method most derived that is in the parent hierarchy of method
         // or the least derived method that isn't newslot that matches by name and sig.
-        private static MethodDesc FindSlotDefiningMethodForVirtualMethod(MethodDesc method)
+        public static MethodDesc FindSlotDefiningMethodForVirtualMethod(MethodDesc method)
         {
             if (method == null)
                 return method;
@@ -560,6 +560,24 @@ namespace Internal.TypeSystem
             }
         }
 
+        /// <summary>
+        /// Resolve an interface method call on an object of the given type
+        /// </summary>
+        /// <returns>The method that should be called, or null if the type doesn't implement the interface method</returns>
+        public static MethodDesc ResolveInterfaceMethodTargetOnObjectType(MethodDesc interfaceMethod, MetadataType objectType)
+        {
+            // Find the type in the hierarchy that maps the interface method to a virtual slot, then resolve the
+            // slot on the object type since a more derived type may have overriden it.
+            for (MetadataType currentType = objectType; currentType != null; currentType = currentType.MetadataBaseType)
+            {
+                MethodDesc slotMethod = ResolveInterfaceMethodToVirtualMethodOnType(interfaceMethod, currentType);
+                if (slotMethod != null)
+                    return FindVirtualFunctionTargetMethodOnObjectType(slotMethod, objectType);
+            }
+
+            return null;
+        }
+
         // Enumerate all possible virtual slots of a type
         public static IEnumerable<MethodDesc> EnumAllVirtualSlots(MetadataType type)
         {
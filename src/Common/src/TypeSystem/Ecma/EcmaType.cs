@@ -497,5 +497,13 @@ namespace Internal.TypeSystem.Ecma
                 return (_typeDefinition.Attributes & TypeAttributes.Sealed) != 0;
             }
         }
+
+        public override bool IsAbstract
+        {
+            get
+            {
+                return (_typeDefinition.Attributes & TypeAttributes.Abstract) != 0;
+            }
+        }
     }
 }
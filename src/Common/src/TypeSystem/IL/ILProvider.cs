@@ -43,6 +43,11 @@ namespace Internal.IL
                 // TODO: Replace with regular implementation once ref locals are available in C# (https://github.com/dotnet/roslyn/issues/118)
                 return InterlockedIntrinsic.EmitIL(method);
             }
+            else
+            if ((methodName == "Read" || methodName == "Write") && method.HasInstantiation && owningType.Name == "Volatile" && owningType.Namespace == "System.Threading")
+            {
+                return VolatileIntrinsic.EmitIL(method);
+            }
 
             return null;
         }
@@ -0,0 +1,47 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+using Internal.TypeSystem;
+
+using Debug = System.Diagnostics.Debug;
+
+namespace Internal.IL.Stubs
+{
+    /// <summary>
+    /// Provides method bodies for generic Volatile intrinsics. These intrinsics work around the lack of byref locals
+    /// in C#. The bodies are plain loads and stores with the volatile prefix, so they don't need an interlocked
+    /// operation, and stores get the regular GC write barrier.
+    /// </summary>
+    public static class VolatileIntrinsic
+    {
+        public static MethodIL EmitIL(MethodDesc target)
+        {
+            Debug.Assert(target.Name == "Read" || target.Name == "Write");
+
+            ILEmitter emitter = new ILEmitter();
+            var codeStream = emitter.NewCodeStream();
+
+            codeStream.EmitLdArg(0);
+
+            if (target.Name == "Read")
+            {
+                Debug.Assert(target.Signature.Length == 1);
+
+                codeStream.Emit(ILOpcode.volatile_);
+                codeStream.Emit(ILOpcode.ldind_ref);
+            }
+            else
+            {
+                Debug.Assert(target.Signature.Length == 2);
+
+                codeStream.EmitLdArg(1);
+                codeStream.Emit(ILOpcode.volatile_);
+                codeStream.Emit(ILOpcode.stind_ref);
+            }
+
+            codeStream.Emit(ILOpcode.ret);
+
+            return emitter.Link();
+        }
+    }
+}
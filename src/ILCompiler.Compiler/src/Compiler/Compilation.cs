@@ -3,8 +3,11 @@
 
 using System;
 using System.Collections.Generic;
+using System.Diagnostics;
 using System.Reflection.Metadata.Ecma335;
 using System.IO;
+using System.Threading;
+using System.Threading.Tasks;
 
 using Internal.TypeSystem;
 using Internal.TypeSystem.Ecma;
@@ -31,6 +34,8 @@ namespace ILCompiler
 
         public bool IsCppCodeGen;
         public bool NoLineNumbers;
+        public int CppUnitCount;
+        public int Parallelism;
         public string DgmlLog;
         public bool FullLog;
         public bool Verbose;
@@ -118,41 +123,51 @@ namespace ILCompiler
         }
 
         private ILProvider _methodILCache = new ILProvider();
+        private readonly object _methodILCacheLock = new object();
 
         public MethodIL GetMethodIL(MethodDesc method)
         {
-            // Flush the cache when it grows too big
-            if (_methodILCache.Count > 1000)
-                _methodILCache= new ILProvider();
+            // Called by RyuJIT, which may compile several methods at once
+            lock (_methodILCacheLock)
+            {
+                // Flush the cache when it grows too big
+                if (_methodILCache.Count > 1000)
+                    _methodILCache= new ILProvider();
 
-            return _methodILCache.GetMethodIL(method);
+                return _methodILCache.GetMethodIL(method);
+            }
         }
 
         private CorInfoImpl _corInfo;
+        private ThreadLocal<CorInfoImpl> _corInfos;
 
         public void CompileSingleFile()
         {
             NodeFactory.NameMangler = NameMangler;
 
-            _nodeFactory = new NodeFactory(_typeSystemContext, _options.IsCppCodeGen);
+            // Nodes compute their dependencies, and RyuJIT compiles methods, on this many threads. The C++ backend
+            // generates code serially.
+            int degreeOfParallelism = Math.Max(_options.Parallelism, 1);
+
+            _nodeFactory = new NodeFactory(_typeSystemContext, _options.IsCppCodeGen, degreeOfParallelism > 1);
 
             // Choose which dependency graph implementation to use based on the amount of logging requested.
             if (_options.DgmlLog == null)
             {
                 // No log uses the NoLogStrategy
-                _dependencyGraph = new DependencyAnalyzer<NoLogStrategy<NodeFactory>, NodeFactory>(_nodeFactory, null);
+                _dependencyGraph = new DependencyAnalyzer<NoLogStrategy<NodeFactory>, NodeFactory>(_nodeFactory, null, degreeOfParallelism);
             }
             else
             {
                 if (_options.FullLog)
                 {
                     // Full log uses the full log strategy
-                    _dependencyGraph = new DependencyAnalyzer<FullGraphLogStrategy<NodeFactory>, NodeFactory>(_nodeFactory, null);
+                    _dependencyGraph = new DependencyAnalyzer<FullGraphLogStrategy<NodeFactory>, NodeFactory>(_nodeFactory, null, degreeOfParallelism);
                 }
                 else
                 {
                     // Otherwise, use the first mark strategy
-                    _dependencyGraph = new DependencyAnalyzer<FirstMarkLogStrategy<NodeFactory>, NodeFactory>(_nodeFactory, null);
+                    _dependencyGraph = new DependencyAnalyzer<FirstMarkLogStrategy<NodeFactory>, NodeFactory>(_nodeFactory, null, degreeOfParallelism);
                 }
             }
 
@@ -161,6 +176,8 @@ namespace ILCompiler
             AddWellKnownTypes();
             AddCompilationRoots();
 
+            Stopwatch stopwatch = Stopwatch.StartNew();
+
             if (_options.IsCppCodeGen)
             {
                 _cppWriter = new CppCodeGen.CppWriter(this);
@@ -169,16 +186,25 @@ namespace ILCompiler
 
                 var nodes = _dependencyGraph.MarkedNodeList;
 
+                Log.WriteLine("Dependency analysis and code generation took " + stopwatch.ElapsedMilliseconds +
+                    " ms with a degree of parallelism of " + degreeOfParallelism);
+
                 _cppWriter.OutputCode(nodes);
             }
             else
             {
-                _corInfo = new CorInfoImpl(this);
+                if (degreeOfParallelism > 1)
+                    _corInfos = new ThreadLocal<CorInfoImpl>(() => new CorInfoImpl(this));
+                else
+                    _corInfo = new CorInfoImpl(this);
 
                 _dependencyGraph.ComputeDependencyRoutine += ComputeDependencyNodeDependencies;
 
                 var nodes = _dependencyGraph.MarkedNodeList;
 
+                Log.WriteLine("Dependency analysis and code generation took " + stopwatch.ElapsedMilliseconds +
+                    " ms with a degree of parallelism of " + degreeOfParallelism);
+
                 ObjectWriter.EmitObject(_options.OutputFilePath, nodes, _nodeFactory);
             }
 
@@ -256,48 +282,93 @@ namespace ILCompiler
 
         private void ComputeDependencyNodeDependencies(List<DependencyNodeCore<NodeFactory>> obj)
         {
-            foreach (MethodCodeNode methodCodeNodeNeedingCode in obj)
+            if (_corInfos == null)
             {
-                MethodDesc method = methodCodeNodeNeedingCode.Method;
-                string methodName = method.ToString();
-                Log.WriteLine("Compiling " + methodName);
-
-                var methodIL = GetMethodIL(method);
-                if (methodIL == null)
-                    return;
+                foreach (MethodCodeNode methodCodeNodeNeedingCode in obj)
+                {
+                    CompileMethod(_corInfo, methodCodeNodeNeedingCode, Log);
+                }
+                return;
+            }
 
-                try
+            // Each thread compiles with its own CorInfoImpl, which holds the state of the method being compiled.
+            // The methods are independent of each other, so the order they finish in doesn't matter. What they
+            // log is kept aside and written out in batch order, so it reads the same as a serial run.
+            StringWriter[] logs = _options.Verbose ? new StringWriter[obj.Count] : null;
+            int nextIndex = -1;
+            Action worker = () =>
+            {
+                CorInfoImpl corInfo = _corInfos.Value;
+                int index;
+                while ((index = Interlocked.Increment(ref nextIndex)) < obj.Count)
                 {
-                    _corInfo.CompileMethod(methodCodeNodeNeedingCode);
+                    TextWriter log = TextWriter.Null;
+                    if (logs != null)
+                        log = logs[index] = new StringWriter();
+
+                    CompileMethod(corInfo, (MethodCodeNode)obj[index], log);
                 }
-                catch (Exception e)
+            };
+
+            Task[] workers = new Task[Math.Max(Math.Min(_options.Parallelism, obj.Count) - 1, 0)];
+            for (int i = 0; i < workers.Length; i++)
+            {
+                workers[i] = Task.Run(worker);
+            }
+
+            worker();
+            Task.WaitAll(workers);
+
+            if (logs != null)
+            {
+                foreach (StringWriter log in logs)
                 {
-                    Log.WriteLine("*** " + method + ": " + e.Message);
-
-                    // Call the __not_yet_implemented method
-                    DependencyAnalysis.X64.X64Emitter emit = new DependencyAnalysis.X64.X64Emitter(_nodeFactory);
-                    emit.Builder.RequireAlignment(_nodeFactory.Target.MinimumFunctionAlignment);
-                    emit.Builder.DefinedSymbols.Add(methodCodeNodeNeedingCode);
-
-                    emit.EmitLEAQ(emit.TargetRegister.Arg0, _nodeFactory.StringIndirection(method.ToString()));
-                    DependencyAnalysis.X64.AddrMode loadFromArg0 =
-                        new DependencyAnalysis.X64.AddrMode(emit.TargetRegister.Arg0, null, 0, 0, DependencyAnalysis.X64.AddrModeSize.Int64);
-                    emit.EmitMOV(emit.TargetRegister.Arg0, ref loadFromArg0);
-                    emit.EmitMOV(emit.TargetRegister.Arg0, ref loadFromArg0);
-
-                    emit.EmitLEAQ(emit.TargetRegister.Arg1, _nodeFactory.StringIndirection(e.Message));
-                    DependencyAnalysis.X64.AddrMode loadFromArg1 =
-                        new DependencyAnalysis.X64.AddrMode(emit.TargetRegister.Arg1, null, 0, 0, DependencyAnalysis.X64.AddrModeSize.Int64);
-                    emit.EmitMOV(emit.TargetRegister.Arg1, ref loadFromArg1);
-                    emit.EmitMOV(emit.TargetRegister.Arg1, ref loadFromArg1);
-
-                    emit.EmitJMP(_nodeFactory.ExternSymbol("__not_yet_implemented"));
-                    methodCodeNodeNeedingCode.SetCode(emit.Builder.ToObjectData());
-                    continue;
+                    Log.Write(log.ToString());
                 }
             }
         }
 
+        private void CompileMethod(CorInfoImpl corInfo, MethodCodeNode methodCodeNodeNeedingCode, TextWriter log)
+        {
+            MethodDesc method = methodCodeNodeNeedingCode.Method;
+            string methodName = method.ToString();
+            log.WriteLine("Compiling " + methodName);
+
+            var methodIL = GetMethodIL(method);
+            if (methodIL == null)
+                return;
+
+            try
+            {
+                corInfo.Log = log;
+                corInfo.CompileMethod(methodCodeNodeNeedingCode);
+            }
+            catch (Exception e)
+            {
+                log.WriteLine("*** " + method + ": " + e.Message);
+
+                // Call the __not_yet_implemented method
+                DependencyAnalysis.X64.X64Emitter emit = new DependencyAnalysis.X64.X64Emitter(_nodeFactory);
+                emit.Builder.RequireAlignment(_nodeFactory.Target.MinimumFunctionAlignment);
+                emit.Builder.DefinedSymbols.Add(methodCodeNodeNeedingCode);
+
+                emit.EmitLEAQ(emit.TargetRegister.Arg0, _nodeFactory.StringIndirection(method.ToString()));
+                DependencyAnalysis.X64.AddrMode loadFromArg0 =
+                    new DependencyAnalysis.X64.AddrMode(emit.TargetRegister.Arg0, null, 0, 0, DependencyAnalysis.X64.AddrModeSize.Int64);
+                emit.EmitMOV(emit.TargetRegister.Arg0, ref loadFromArg0);
+                emit.EmitMOV(emit.TargetRegister.Arg0, ref loadFromArg0);
+
+                emit.EmitLEAQ(emit.TargetRegister.Arg1, _nodeFactory.StringIndirection(e.Message));
+                DependencyAnalysis.X64.AddrMode loadFromArg1 =
+                    new DependencyAnalysis.X64.AddrMode(emit.TargetRegister.Arg1, null, 0, 0, DependencyAnalysis.X64.AddrModeSize.Int64);
+                emit.EmitMOV(emit.TargetRegister.Arg1, ref loadFromArg1);
+                emit.EmitMOV(emit.TargetRegister.Arg1, ref loadFromArg1);
+
+                emit.EmitJMP(_nodeFactory.ExternSymbol("__not_yet_implemented"));
+                methodCodeNodeNeedingCode.SetCode(emit.Builder.ToObjectData());
+            }
+        }
+
         private void CppCodeGenComputeDependencyNodeDependencies(List<DependencyNodeCore<NodeFactory>> obj)
         {
             foreach (CppMethodCodeNode methodCodeNodeNeedingCode in obj)
@@ -323,9 +394,13 @@ namespace ILCompiler
         {
             DelegateInfo info;
 
-            if (!_delegateInfos.TryGetValue(target, out info))
+            // Called by RyuJIT, which may compile several methods at once
+            lock (_delegateInfos)
             {
-                _delegateInfos.Add(target, info = new DelegateInfo(this, target));
+                if (!_delegateInfos.TryGetValue(target, out info))
+                {
+                    _delegateInfos.Add(target, info = new DelegateInfo(this, target));
+                }
             }
 
             return info;
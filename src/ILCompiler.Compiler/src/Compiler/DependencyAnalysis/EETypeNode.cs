@@ -179,7 +179,8 @@ namespace ILCompiler.DependencyAnalysis
                         return true;
                 }
 
-                return false;
+                // Interface methods may be implemented by base type methods
+                return _type.RuntimeInterfaces.Length != 0;
             }
         }
 
@@ -195,6 +196,21 @@ namespace ILCompiler.DependencyAnalysis
                         yield return new DependencyNodeCore<NodeFactory>.CombinedDependencyListEntry(factory.MethodEntrypoint(impl), factory.VirtualMethodUse(decl), "Virtual method");
                     }
                 }
+
+                foreach (DefType itf in _type.RuntimeInterfaces)
+                {
+                    foreach (MethodDesc decl in itf.GetMethods())
+                    {
+                        if (!decl.IsVirtual || decl.HasInstantiation)
+                            continue;
+
+                        MethodDesc impl = VirtualFunctionResolution.ResolveInterfaceMethodTargetOnObjectType(decl, (MetadataType)_type);
+                        if (impl != null && !impl.IsAbstract)
+                        {
+                            yield return new DependencyNodeCore<NodeFactory>.CombinedDependencyListEntry(factory.MethodEntrypoint(impl), factory.VirtualMethodUse(decl), "Interface method");
+                        }
+                    }
+                }
             }
         }
 
@@ -17,11 +17,12 @@ namespace ILCompiler.DependencyAnalysis
         private CompilerTypeSystemContext _context;
         private bool _cppCodeGen;
 
-        public NodeFactory(CompilerTypeSystemContext context, bool cppCodeGen)
+        public NodeFactory(CompilerTypeSystemContext context, bool cppCodeGen, bool threadSafe)
         {
             _target = context.Target;
             _context = context;
             _cppCodeGen = cppCodeGen;
+            _threadSafe = threadSafe;
             CreateNodeCaches();
         }
 
@@ -33,24 +34,42 @@ namespace ILCompiler.DependencyAnalysis
             }
         }
 
+        // With a degree of parallelism greater than one, nodes compute their dependencies and methods are
+        // compiled on several threads at once, so the node caches have to be locked.
+        private bool _threadSafe;
+
         private struct NodeCache<TKey, TValue>
         {
             private Func<TKey, TValue> _creator;
             private Dictionary<TKey, TValue> _cache;
+            private bool _threadSafe;
 
-            public NodeCache(Func<TKey, TValue> creator, IEqualityComparer<TKey> comparer)
+            public NodeCache(bool threadSafe, Func<TKey, TValue> creator, IEqualityComparer<TKey> comparer)
             {
                 _creator = creator;
                 _cache = new Dictionary<TKey, TValue>(comparer);
+                _threadSafe = threadSafe;
             }
 
-            public NodeCache(Func<TKey, TValue> creator)
+            public NodeCache(bool threadSafe, Func<TKey, TValue> creator)
             {
                 _creator = creator;
                 _cache = new Dictionary<TKey, TValue>();
+                _threadSafe = threadSafe;
             }
 
             public TValue GetOrAdd(TKey key)
+            {
+                if (!_threadSafe)
+                    return GetOrAddUnsynchronized(key);
+
+                lock (_cache)
+                {
+                    return GetOrAddUnsynchronized(key);
+                }
+            }
+
+            private TValue GetOrAddUnsynchronized(TKey key)
             {
                 TValue result;
                 if (!_cache.TryGetValue(key, out result))
@@ -64,54 +83,54 @@ namespace ILCompiler.DependencyAnalysis
 
         private void CreateNodeCaches()
         {
-            _typeSymbols = new NodeCache<TypeDesc, EETypeNode>((TypeDesc type) =>
+            _typeSymbols = new NodeCache<TypeDesc, EETypeNode>(_threadSafe, (TypeDesc type) =>
             {
                 return new EETypeNode(type, false);
             });
 
-            _constructedTypeSymbols = new NodeCache<TypeDesc, EETypeNode>((TypeDesc type) =>
+            _constructedTypeSymbols = new NodeCache<TypeDesc, EETypeNode>(_threadSafe, (TypeDesc type) =>
             {
                 return new EETypeNode(type, true);
             });
 
 
-            _nonGCStatics = new NodeCache<MetadataType, NonGCStaticsNode>((MetadataType type) =>
+            _nonGCStatics = new NodeCache<MetadataType, NonGCStaticsNode>(_threadSafe, (MetadataType type) =>
             {
                 return new NonGCStaticsNode(type);
             });
 
-            _GCStatics = new NodeCache<MetadataType, GCStaticsNode>((MetadataType type) =>
+            _GCStatics = new NodeCache<MetadataType, GCStaticsNode>(_threadSafe, (MetadataType type) =>
             {
                 return new GCStaticsNode(type, this);
             });
 
-            _threadStatics = new NodeCache<MetadataType, ThreadStaticsNode>((MetadataType type) =>
+            _threadStatics = new NodeCache<MetadataType, ThreadStaticsNode>(_threadSafe, (MetadataType type) =>
             {
                 return new ThreadStaticsNode(type, this);
             });
 
-            _GCStaticEETypes = new NodeCache<bool[], GCStaticEETypeNode>((bool[] gcdesc) =>
+            _GCStaticEETypes = new NodeCache<bool[], GCStaticEETypeNode>(_threadSafe, (bool[] gcdesc) =>
             {
                 return new GCStaticEETypeNode(gcdesc, this);
             }, new BoolArrayEqualityComparer());
 
-            _readOnlyDataBlobs = new NodeCache<Tuple<string, byte[], int>, BlobNode>((Tuple<string, byte[], int> key) =>
+            _readOnlyDataBlobs = new NodeCache<Tuple<string, byte[], int>, BlobNode>(_threadSafe, (Tuple<string, byte[], int> key) =>
             {
                 return new BlobNode(key.Item1, "text", key.Item2, key.Item3);
             });
 
-            _externSymbols = new NodeCache<string, ExternSymbolNode>((string name) =>
+            _externSymbols = new NodeCache<string, ExternSymbolNode>(_threadSafe, (string name) =>
             {
                 return new ExternSymbolNode(name);
             });
 
-            _internalSymbols = new NodeCache<Tuple<ObjectNode, int, string>, ObjectAndOffsetSymbolNode>(
+            _internalSymbols = new NodeCache<Tuple<ObjectNode, int, string>, ObjectAndOffsetSymbolNode>(_threadSafe,
                 (Tuple<ObjectNode, int, string> key) =>
                 {
                     return new ObjectAndOffsetSymbolNode(key.Item1, key.Item2, key.Item3);
                 });
 
-            _methodCode = new NodeCache<MethodDesc, ISymbolNode>((MethodDesc method) =>
+            _methodCode = new NodeCache<MethodDesc, ISymbolNode>(_threadSafe, (MethodDesc method) =>
             {
                 if (_cppCodeGen)
                    return new CppMethodCodeNode(method);
@@ -119,32 +138,32 @@ namespace ILCompiler.DependencyAnalysis
                     return new MethodCodeNode(method);
             });
 
-            _jumpStubs = new NodeCache<ISymbolNode, JumpStubNode>((ISymbolNode node) =>
+            _jumpStubs = new NodeCache<ISymbolNode, JumpStubNode>(_threadSafe, (ISymbolNode node) =>
             {
                 return new JumpStubNode(node);
             });
 
-            _virtMethods = new NodeCache<MethodDesc, VirtualMethodUseNode>((MethodDesc method) =>
+            _virtMethods = new NodeCache<MethodDesc, VirtualMethodUseNode>(_threadSafe, (MethodDesc method) =>
             {
                 return new VirtualMethodUseNode(method);
             });
 
-            _readyToRunHelpers = new NodeCache<Tuple<ReadyToRunHelperId, Object>, ReadyToRunHelperNode>((Tuple < ReadyToRunHelperId, Object > helper) =>
+            _readyToRunHelpers = new NodeCache<Tuple<ReadyToRunHelperId, Object>, ReadyToRunHelperNode>(_threadSafe, (Tuple < ReadyToRunHelperId, Object > helper) =>
             {
                 return new ReadyToRunHelperNode(helper.Item1, helper.Item2);
             });
 
-            _stringDataNodes = new NodeCache<string, StringDataNode>((string data) =>
+            _stringDataNodes = new NodeCache<string, StringDataNode>(_threadSafe, (string data) =>
             {
                 return new StringDataNode(data);
             });
 
-            _stringIndirectionNodes = new NodeCache<string, StringIndirectionNode>((string data) =>
+            _stringIndirectionNodes = new NodeCache<string, StringIndirectionNode>(_threadSafe, (string data) =>
             {
                 return new StringIndirectionNode(data);
             });
 
-            _typeOptionalFields = new NodeCache<EETypeOptionalFieldsBuilder, EETypeOptionalFieldsNode>((EETypeOptionalFieldsBuilder fieldBuilder) =>
+            _typeOptionalFields = new NodeCache<EETypeOptionalFieldsBuilder, EETypeOptionalFieldsNode>(_threadSafe, (EETypeOptionalFieldsBuilder fieldBuilder) =>
             {
                 return new EETypeOptionalFieldsNode(fieldBuilder);
             });
@@ -0,0 +1,86 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+using System;
+using System.Globalization;
+using System.IO;
+
+namespace ILCompiler.CppCodeGen
+{
+    /// <summary>
+    /// Names and writes the files the C++ backend generates. With more than one translation unit, unit 0 goes to
+    /// the output file, unit N to the output file with N inserted before the extension, and the declarations they
+    /// share to a header next to them.
+    /// </summary>
+    public static class CppOutputFiles
+    {
+        private const string HeaderFirstLine = "#pragma once";
+
+        public static string GetUnitPath(string outputFilePath, int unitIndex)
+        {
+            if (unitIndex == 0)
+                return outputFilePath;
+
+            return Path.ChangeExtension(outputFilePath, unitIndex.ToString(CultureInfo.InvariantCulture) + Path.GetExtension(outputFilePath));
+        }
+
+        public static string GetHeaderPath(string outputFilePath)
+        {
+            return Path.ChangeExtension(outputFilePath, ".h");
+        }
+
+        /// <summary>
+        /// Starts the text of a header, in a way that DeleteStaleFiles can recognize.
+        /// </summary>
+        public static void BeginHeader(TextWriter header)
+        {
+            header.WriteLine(HeaderFirstLine);
+        }
+
+        /// <summary>
+        /// Writes a file unless it already has the given contents, so that the C++ compiler's incremental build
+        /// only recompiles what changed. Returns whether the file was written.
+        /// </summary>
+        public static bool WriteFileIfChanged(string path, string contents)
+        {
+            if (File.Exists(path) && File.ReadAllText(path) == contents)
+                return false;
+
+            File.WriteAllText(path, contents);
+            return true;
+        }
+
+        /// <summary>
+        /// Deletes what an earlier compilation into more translation units left behind: the units past the last
+        /// one, which would otherwise get compiled and linked along with the new ones, and the header if there
+        /// is only one unit now. Only a header that starts the way generated ones do is deleted.
+        /// </summary>
+        public static void DeleteStaleFiles(string outputFilePath, int unitCount)
+        {
+            for (int i = Math.Max(unitCount, 1); ; i++)
+            {
+                string unitPath = GetUnitPath(outputFilePath, i);
+                if (!File.Exists(unitPath))
+                    break;
+
+                File.Delete(unitPath);
+            }
+
+            if (unitCount <= 1)
+            {
+                string headerPath = GetHeaderPath(outputFilePath);
+                if (File.Exists(headerPath))
+                {
+                    string firstLine;
+                    using (StreamReader reader = File.OpenText(headerPath))
+                    {
+                        firstLine = reader.ReadLine();
+                    }
+
+                    if (firstLine == HeaderFirstLine)
+                        File.Delete(headerPath);
+                }
+            }
+        }
+    }
+}
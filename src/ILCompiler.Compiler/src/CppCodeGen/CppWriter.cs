@@ -36,8 +36,6 @@ namespace ILCompiler.CppCodeGen
         {
             _compilation = compilation;
 
-            _out = new StreamWriter(File.Create(compilation.Options.OutputFilePath));
-
             SetWellKnownTypeSignatureName(WellKnownType.Void, "void");
             SetWellKnownTypeSignatureName(WellKnownType.Boolean, "uint8_t");
             SetWellKnownTypeSignatureName(WellKnownType.Char, "uint16_t");
@@ -401,14 +399,25 @@ namespace ILCompiler.CppCodeGen
             }
         }
 
-        private StreamWriter _out;
+        private TextWriter _out;
 
         private Dictionary<TypeDesc, List<MethodDesc>> _methodLists;
 
+        // The fields of one of the structs that hold statics with GC references. The object references come
+        // first so that they can be reported as one series, then the value types with the paths of the
+        // references in them.
+        private class GCStaticsBuilder
+        {
+            public StringBuilder References = new StringBuilder();
+            public int ReferenceCount;
+            public StringBuilder ValueTypes = new StringBuilder();
+            public List<string> ValueTypeReferences = new List<string>();
+        }
+
         private StringBuilder _statics;
-        private StringBuilder _gcStatics;
+        private GCStaticsBuilder _gcStatics;
         private StringBuilder _threadStatics;
-        private StringBuilder _gcThreadStatics;
+        private GCStaticsBuilder _gcThreadStatics;
 
         // Base classes and valuetypes has to be emitted before they are used.
         private HashSet<TypeDesc> _emittedTypes;
@@ -475,9 +484,9 @@ namespace ILCompiler.CppCodeGen
             if (full)
             {
                 _statics = new StringBuilder();
-                _gcStatics = new StringBuilder();
+                _gcStatics = new GCStaticsBuilder();
                 _threadStatics = new StringBuilder();
-                _gcThreadStatics = new StringBuilder();
+                _gcThreadStatics = new GCStaticsBuilder();
             }
 
             _emittedTypes = new HashSet<TypeDesc>();
@@ -498,33 +507,39 @@ namespace ILCompiler.CppCodeGen
             if (full)
             {
                 Out.WriteLine();
-                Out.WriteLine("struct {");
+                Out.WriteLine("struct __Statics {");
                 Out.Write(_statics.ToString());
-                Out.WriteLine("} __statics;");
+                Out.WriteLine("};");
+                Out.WriteLine("extern __Statics __statics;");
 
-                // TODO: Register GC statics with GC
                 Out.WriteLine();
-                Out.WriteLine("struct {");
-                Out.Write(_gcStatics.ToString());
-                Out.WriteLine("} __gcStatics;");
+                Out.WriteLine("struct __GCStatics {");
+                Out.Write(_gcStatics.References.ToString());
+                Out.Write(_gcStatics.ValueTypes.ToString());
+                Out.WriteLine("};");
+                Out.WriteLine("extern __GCStatics __gcStatics;");
 
                 Out.WriteLine();
-                // @TODO_SDM: do for real - note: the 'extra' series are just testing the init syntax for 0-length arrays, they should be removed
-                // TODO: preinitialized 0-length arrays are not supported in CLang
-                Out.WriteLine("#ifdef _MSC_VER");
-                Out.WriteLine("StaticGcDesc __gcStaticsDescs = { 1, { { sizeof(__gcStatics), 0 }, { 123, 456 }, { 789, 101112 } } };");
-                Out.WriteLine("#else");
-                Out.WriteLine("StaticGcDesc __gcStaticsDescs;");
-                Out.WriteLine("#endif");
+                Out.WriteLine("struct __ThreadStatics {");
+                Out.Write(_threadStatics.ToString());
+                Out.WriteLine("};");
+                Out.WriteLine("extern thread_local __ThreadStatics __threadStatics;");
 
+                // The runtime finds this thread's block through tls_pSimpleModuleThreadStatics, which is set on
+                // first access so that threads that never touch the thread statics don't have to do anything.
                 Out.WriteLine();
-                Out.WriteLine("SimpleModuleHeader __module = { &__gcStatics, &__gcStaticsDescs };");
-
+                Out.WriteLine("struct __ThreadGCStatics {");
+                Out.Write(_gcThreadStatics.References.ToString());
+                Out.Write(_gcThreadStatics.ValueTypes.ToString());
+                Out.WriteLine("};");
+                Out.WriteLine("extern thread_local __ThreadGCStatics __threadGcStatics;");
+                Out.WriteLine("inline __ThreadGCStatics & __getThreadGcStatics() {");
+                Out.WriteLine("if (tls_pSimpleModuleThreadStatics == NULL) tls_pSimpleModuleThreadStatics = &__threadGcStatics;");
+                Out.WriteLine("return __threadGcStatics;");
+                Out.WriteLine("}");
 
                 _statics = null;
-                _gcStatics = null;
                 _threadStatics = null;
-                _gcThreadStatics = null;
             }
         }
 
@@ -597,7 +612,12 @@ namespace ILCompiler.CppCodeGen
 
                 List<MethodDesc> virtualSlots;
                 _compilation.NodeFactory.VirtualSlots.TryGetValue(t, out virtualSlots);
-                if (virtualSlots != null)
+                if (virtualSlots != null && t.IsInterface)
+                {
+                    foreach (MethodDesc interfaceMethod in virtualSlots)
+                        Out.WriteLine(GetCodeForInterfaceMethod(interfaceMethod));
+                }
+                else if (virtualSlots != null)
                 {
                     int baseSlots = 0;
                     var baseType = t.BaseType;
@@ -625,7 +645,7 @@ namespace ILCompiler.CppCodeGen
 
                 if (t.HasStaticConstructor)
                 {
-                    _statics.AppendLine("bool __cctor_" + GetCppTypeName(t).Replace("::", "__") + ";");
+                    _statics.AppendLine("volatile int32_t __cctor_" + GetCppTypeName(t).Replace("::", "__") + ";");
                 }
 
                 List<MethodDesc> methodList;
@@ -651,6 +671,72 @@ namespace ILCompiler.CppCodeGen
             Out.WriteLine();
         }
 
+        // Name of the struct that holds a static field. Statics that hold GC references, directly or in a value
+        // type, go to __gcStatics, or to this thread's __threadGcStatics for thread statics, which are reported
+        // to the GC. The rest go to __statics, or to the per-thread __threadStatics.
+        public string GetCppStaticsName(FieldDesc field)
+        {
+            TypeDesc fieldType = GetFieldTypeOrPlaceholder(field);
+
+            if (ContainsGCReferences(fieldType))
+                return field.IsThreadStatic ? "__getThreadGcStatics()" : "__gcStatics";
+
+            return field.IsThreadStatic ? "__threadStatics" : "__statics";
+        }
+
+        // Calls report with the path of each GC reference in a value of the given type stored at path, and whether
+        // it's a byref, which can point into the middle of an object or outside of the heap.
+        internal void EnumerateGCReferences(TypeDesc type, string path, Action<string, bool> report)
+        {
+            if (type.IsByRef)
+            {
+                report(path, true);
+            }
+            else
+            if (type.IsValueType)
+            {
+                if (type.IsPrimitive || type.IsEnum)
+                    return;
+
+                foreach (var field in type.GetFields())
+                {
+                    if (field.IsStatic)
+                        continue;
+
+                    EnumerateGCReferences(GetFieldTypeOrPlaceholder(field), path + "." + GetCppFieldName(field), report);
+                }
+            }
+            else
+            if (!type.IsPointer)
+            {
+                report(path, false);
+            }
+        }
+
+        internal bool ContainsGCReferences(TypeDesc type)
+        {
+            bool found = false;
+            EnumerateGCReferences(type, "", (path, interior) => found = true);
+            return found;
+        }
+
+        private void AppendGCStatic(GCStaticsBuilder builder, FieldDesc field)
+        {
+            TypeDesc fieldType = GetFieldTypeOrPlaceholder(field);
+            string fieldName = GetCppStaticFieldName(field);
+
+            if (fieldType.IsValueType)
+            {
+                builder.ValueTypes.AppendLine(GetCppSignatureTypeName(fieldType) + " " + fieldName + ";");
+                EnumerateGCReferences(fieldType, fieldName, (path, interior) => builder.ValueTypeReferences.Add(path));
+            }
+            else
+            {
+                builder.References.AppendLine(GetCppSignatureTypeName(fieldType) + " " + fieldName + ";");
+                builder.ReferenceCount++;
+            }
+        }
+
         private void OutputTypeFields(TypeDesc t)
         {
             bool explicitLayout = false;
@@ -679,19 +765,15 @@ namespace ILCompiler.CppCodeGen
                         continue;
 
                     TypeDesc fieldType = GetFieldTypeOrPlaceholder(field);
-                    StringBuilder builder;
-                    if (!fieldType.IsValueType)
+                    if (ContainsGCReferences(fieldType))
                     {
-                        _gcStatics.Append(GetCppSignatureTypeName(fieldType));
-                        builder = _gcStatics;
+                        AppendGCStatic(field.IsThreadStatic ? _gcThreadStatics : _gcStatics, field);
                     }
                     else
                     {
-                        // TODO: Valuetype statics with GC references
-                        _statics.Append(GetCppSignatureTypeName(fieldType));
-                        builder = _statics;
+                        StringBuilder builder = field.IsThreadStatic ? _threadStatics : _statics;
+                        builder.AppendLine(GetCppSignatureTypeName(fieldType) + " " + GetCppStaticFieldName(field) + ";");
                     }
-                    builder.AppendLine(" " + GetCppStaticFieldName(field) + ";");
                 }
                 else
                 {
@@ -807,6 +889,113 @@ namespace ILCompiler.CppCodeGen
             return sb.ToString();
         }
 
+        private String GetCodeForInterfaceMethod(MethodDesc method)
+        {
+            StringBuilder sb = new StringBuilder();
+
+            AppendSlotTypeDef(sb, method);
+
+            sb.Append("static const __InterfaceDispatchEntry * __resolve__");
+            sb.Append(GetCppMethodName(method));
+            sb.AppendLine("(void * pThis);");
+
+            return sb.ToString();
+        }
+
+        // Interface methods are resolved by comparing the MethodTable of the object against every constructed
+        // type that implements the method. There are no interface maps in the MethodTables to do better, so the
+        // result goes into an entry that the dispatch cell of the call site caches (see __interface_dispatch).
+        // Methods of value types expect an unboxed this, so boxed value types resolve to an unboxing thunk.
+        private String GetCodeForInterfaceResolvers(TypeDesc interfaceType, List<TypeDesc> constructedTypes)
+        {
+            StringBuilder thunks = new StringBuilder();
+            StringBuilder sb = new StringBuilder();
+
+            foreach (MethodDesc method in _compilation.NodeFactory.VirtualSlots[interfaceType])
+            {
+                string slotTypeName = GetCppTypeName(interfaceType) + "::__slot__" + GetCppMethodName(method);
+
+                sb.Append("const __InterfaceDispatchEntry * ");
+                sb.Append(GetCppTypeName(interfaceType));
+                sb.Append("::__resolve__");
+                sb.Append(GetCppMethodName(method));
+                sb.AppendLine("(void * pThis) {");
+                sb.AppendLine("MethodTable * pMT = *(MethodTable **)pThis;");
+
+                foreach (TypeDesc type in constructedTypes)
+                {
+                    MethodDesc implMethod = VirtualFunctionResolution.ResolveInterfaceMethodTargetOnObjectType(method, (MetadataType)type);
+                    if (implMethod == null || implMethod.IsAbstract)
+                        continue;
+
+                    sb.Append("if (pMT == ");
+                    sb.Append(GetCppTypeName(type));
+                    sb.Append("::__getMethodTable()) { static const __InterfaceDispatchEntry entry = { pMT, (void *)(");
+                    sb.Append(slotTypeName);
+                    sb.Append(")&");
+                    if (implMethod.OwningType.IsValueType)
+                    {
+                        string thunkName = "__unbox__" + (GetCppTypeName(interfaceType) + "__" + GetCppMethodName(method) + "__" +
+                            GetCppTypeName(type)).Replace("::", "__");
+                        AppendUnboxingThunk(thunks, thunkName, method, implMethod);
+                        sb.Append(thunkName);
+                    }
+                    else
+                    {
+                        sb.Append(GetCppTypeName(implMethod.OwningType));
+                        sb.Append("::");
+                        sb.Append(GetCppMethodName(implMethod));
+                    }
+                    sb.AppendLine(" }; return &entry; }");
+                }
+
+                sb.AppendLine("__fail_fast();");
+                sb.AppendLine("return NULL;");
+                sb.AppendLine("}");
+            }
+
+            return thunks.ToString() + sb.ToString();
+        }
+
+        // Takes a boxed value type as this, like the callers of the interface method, and calls implMethod with a
+        // pointer to the value inside the box.
+        private void AppendUnboxingThunk(StringBuilder sb, string thunkName, MethodDesc slotMethod, MethodDesc implMethod)
+        {
+            MethodSignature signature = slotMethod.Signature;
+
+            sb.Append("static ");
+            sb.Append(GetCppSignatureTypeName(signature.ReturnType));
+            sb.Append(" ");
+            sb.Append(thunkName);
+            sb.Append("(");
+            sb.Append(GetCppSignatureTypeName(slotMethod.OwningType));
+            sb.Append(" pThis");
+            for (int i = 0; i < signature.Length; i++)
+            {
+                sb.Append(", ");
+                sb.Append(GetCppSignatureTypeName(signature[i]));
+                sb.Append(" _a");
+                sb.Append((i + 1).ToString());
+            }
+            sb.Append(") { ");
+
+            if (!signature.ReturnType.IsVoid)
+                sb.Append("return ");
+
+            sb.Append(GetCppTypeName(implMethod.OwningType));
+            sb.Append("::");
+            sb.Append(GetCppMethodName(implMethod));
+            sb.Append("((");
+            sb.Append(GetCppSignatureTypeName(implMethod.OwningType.MakeByRefType()));
+            sb.Append(")((void **)pThis + 1)");
+            for (int i = 0; i < signature.Length; i++)
+            {
+                sb.Append(", _a");
+                sb.Append((i + 1).ToString());
+            }
+            sb.AppendLine("); }");
+        }
+
         private void AppendVirtualSlots(StringBuilder sb, TypeDesc implType, TypeDesc declType)
         {
             var baseType = declType.BaseType;
@@ -950,6 +1139,55 @@ namespace ILCompiler.CppCodeGen
             return sb.ToString();
         }
 
+        private void OutputStatics()
+        {
+            Out.WriteLine("__Statics __statics;");
+            Out.WriteLine("__GCStatics __gcStatics;");
+            Out.WriteLine("thread_local __ThreadStatics __threadStatics;");
+            Out.WriteLine("thread_local __ThreadGCStatics __threadGcStatics;");
+
+            Out.WriteLine();
+            OutputStaticGcDesc("__gcStaticsDescs", "__GCStatics", _gcStatics);
+            OutputStaticGcDesc("__threadGcStaticsDescs", "__ThreadGCStatics", _gcThreadStatics);
+
+            Out.WriteLine();
+            Out.WriteLine("SimpleModuleHeader __module = { &__gcStatics, (StaticGcDesc *)&__gcStaticsDescs, (StaticGcDesc *)&__threadGcStaticsDescs };");
+            Out.WriteLine();
+        }
+
+        // The object references at the start of the struct are reported to the GC as a single series, and each
+        // reference in a value type as a series of its own. StaticGcDesc ends in a 0-length array, which can't be
+        // initialized portably, so the descriptor is declared with the same layout and the number of series.
+        private void OutputStaticGcDesc(string name, string structName, GCStaticsBuilder builder)
+        {
+            var series = new List<string>();
+            if (builder.ReferenceCount != 0)
+                series.Add("{ " + builder.ReferenceCount.ToString(CultureInfo.InvariantCulture) + " * sizeof(void*), 0 }");
+            foreach (var path in builder.ValueTypeReferences)
+                series.Add("{ sizeof(void*), offsetof(" + structName + ", " + path + ") }");
+
+            Out.Write("struct { uint32_t m_numSeries; StaticGcDesc::GCSeries m_series[" +
+                Math.Max(series.Count, 1).ToString(CultureInfo.InvariantCulture) + "]; } " + name + " = { " +
+                series.Count.ToString(CultureInfo.InvariantCulture) + ", { ");
+            Out.Write(series.Count != 0 ? String.Join(", ", series) : "{ 0, 0 }");
+            Out.WriteLine(" } };");
+        }
+
+        // The code for a type and its methods goes to a translation unit picked from a hash of its name, so that
+        // the same type always lands in the same unit from one compilation to the next, regardless of what other
+        // types there are.
+        private int GetUnitIndex(TypeDesc type, int unitCount)
+        {
+            uint hash = 2166136261;
+            foreach (char c in GetCppTypeName(type))
+            {
+                hash ^= c;
+                hash *= 16777619;
+            }
+
+            return (int)(hash % (uint)unitCount);
+        }
+
         private void BuildMethodLists(IEnumerable<DependencyNode> nodes)
         {
             _methodLists = new Dictionary<TypeDesc, List<MethodDesc>>();
@@ -987,6 +1225,35 @@ namespace ILCompiler.CppCodeGen
 
             ExpandTypes();
 
+            // With more than one translation unit, the type declarations go to a header that every unit includes.
+            // Method bodies and MethodTables are spread over the units, and the first unit gets the statics and
+            // main. Otherwise everything goes to a single file.
+            string outputFilePath = _compilation.Options.OutputFilePath;
+            int unitCount = Math.Max(_compilation.Options.CppUnitCount, 1);
+
+            // The files are generated in memory and only written out when they changed, so that the C++ compiler's
+            // incremental build only recompiles the units whose types or methods changed. Units and the header left
+            // over from a compilation into more units are deleted.
+            StringWriter[] units = new StringWriter[unitCount];
+            for (int i = 0; i < unitCount; i++)
+                units[i] = new StringWriter(CultureInfo.InvariantCulture);
+
+            string headerFilePath = CppOutputFiles.GetHeaderPath(outputFilePath);
+            StringWriter header = null;
+            if (unitCount > 1)
+            {
+                header = new StringWriter(CultureInfo.InvariantCulture);
+                _out = header;
+                CppOutputFiles.BeginHeader(Out);
+
+                foreach (var unit in units)
+                    unit.WriteLine("#include \"" + Path.GetFileName(headerFilePath) + "\"");
+            }
+            else
+            {
+                _out = units[0];
+            }
+
             Out.WriteLine("#include \"common.h\"");
             Out.WriteLine();
 
@@ -995,14 +1262,22 @@ namespace ILCompiler.CppCodeGen
             OutputTypes(true);
             Out.WriteLine();
 
+            if (header != null)
+                CppOutputFiles.WriteFileIfChanged(headerFilePath, header.ToString());
+
+            _out = units[0];
+            OutputStatics();
+
             foreach (var t in _cppSignatureNames.Keys)
             {
+                if (t.IsPointer || t.IsByRef)
+                    continue;
+
+                _out = units[GetUnitIndex(t, unitCount)];
+
                 // TODO: Enable once the dependencies are tracked for arrays
                 // if (((DependencyNode)_compilation.NodeFactory.ConstructedTypeSymbol(t)).Marked)
-                if (!t.IsPointer && !t.IsByRef)
-                {
-                    Out.WriteLine(GetCodeForType(t));
-                }
+                Out.WriteLine(GetCodeForType(t));
 
                 List<MethodDesc> methodList;
                 if (_methodLists.TryGetValue(t, out methodList))
@@ -1034,6 +1309,24 @@ namespace ILCompiler.CppCodeGen
                 }
             }
 
+            List<TypeDesc> constructedTypes = new List<TypeDesc>();
+            foreach (var t in _cppSignatureNames.Keys)
+            {
+                if (t is MetadataType && !t.IsInterface && ((DependencyNode)_compilation.NodeFactory.ConstructedTypeSymbol(t)).Marked)
+                    constructedTypes.Add(t);
+            }
+
+            foreach (var t in _cppSignatureNames.Keys.ToArray())
+            {
+                if (t.IsInterface && _compilation.NodeFactory.VirtualSlots.ContainsKey(t))
+                {
+                    _out = units[GetUnitIndex(t, unitCount)];
+                    Out.WriteLine(GetCodeForInterfaceResolvers(t, constructedTypes));
+                }
+            }
+
+            _out = units[0];
+
             if (_compilation.MainMethod != null)
             {
                 var mainMethod = _compilation.MainMethod;
@@ -1068,7 +1361,10 @@ namespace ILCompiler.CppCodeGen
                 Out.WriteLine("}");
             }
 
-            Out.Dispose();
+            for (int i = 0; i < unitCount; i++)
+                CppOutputFiles.WriteFileIfChanged(CppOutputFiles.GetUnitPath(outputFilePath, i), units[i].ToString());
+            CppOutputFiles.DeleteStaleFiles(outputFilePath, unitCount);
+            _out = null;
         }
     }
 }
@@ -58,6 +58,21 @@ namespace Internal.IL
         };
         private List<SpillSlot> _spillSlots;
 
+        // A variable that holds GC references. These live in the method's shadow stack frame, which reports
+        // them to the GC, instead of in C++ locals.
+        private class GCRoot
+        {
+            public string Name;
+            public string TypeName;
+            public StackValueKind Kind;
+            public TypeDesc Type;
+            public bool Pinned;
+        };
+        private List<GCRoot> _gcRoots = new List<GCRoot>();
+
+        // Types whose beforefieldinit class constructors are triggered once on entry to the method
+        private List<TypeDesc> _beforeFieldInitTriggers;
+
         // TODO: Unify with verifier?
         [Flags]
         private enum Prefix
@@ -195,6 +210,11 @@ namespace Internal.IL
             public StackValueKind Kind;
             public TypeDesc Type;
             public Value Value;
+
+            // Type is a base of the type of every object the value can hold, unless the value came in through a
+            // spill slot. Those take their type from the predecessor that got imported first, and objects of
+            // another type can flow in from the others.
+            public bool TypeFromSpill;
         }
 
         private StackValueKind GetStackValueKind(TypeDesc type)
@@ -282,18 +302,60 @@ namespace Internal.IL
             return "_" + IntToString(_currentTemp++);
         }
 
+        // Each interface call site gets a cell that caches the target for the type of object it was last called
+        // on. The cells are statics of the method, declared by Compile.
+        private int _dispatchCellCount;
+        private string NewDispatchCellName()
+        {
+            return "__dispatchCell" + IntToString(_dispatchCellCount++);
+        }
+
         private void PushTemp(StackValueKind kind, TypeDesc type = null)
         {
             string temp = NewTempName();
 
             Push(kind, new Value(temp), type);
 
-            _builder.Append(GetStackValueKindCPPTypeName(kind, type));
-            _builder.Append(" ");
-            _builder.Append(temp);
+            AppendTempDeclaration(temp, kind, type);
             _builder.Append("=");
         }
 
+        private bool IsGCRoot(StackValueKind kind, TypeDesc type)
+        {
+            switch (kind)
+            {
+                case StackValueKind.ObjRef:
+                case StackValueKind.ByRef:
+                    return true;
+                case StackValueKind.ValueType:
+                    return _writer.ContainsGCReferences(type);
+                default:
+                    return false;
+            }
+        }
+
+        // Moves the variable to the shadow stack frame if it holds GC references. Returns false if it doesn't,
+        // and the caller has to declare it.
+        private bool TryAddGCRoot(string name, string typeName, StackValueKind kind, TypeDesc type, bool pinned = false)
+        {
+            if (!IsGCRoot(kind, type))
+                return false;
+
+            _gcRoots.Add(new GCRoot() { Name = name, TypeName = typeName, Kind = kind, Type = type, Pinned = pinned });
+            return true;
+        }
+
+        private void AppendTempDeclaration(string temp, StackValueKind kind, TypeDesc type)
+        {
+            string typeName = GetStackValueKindCPPTypeName(kind, type);
+            if (!TryAddGCRoot(temp, typeName, kind, type))
+            {
+                Append(typeName);
+                Append(" ");
+            }
+            Append(temp);
+        }
+
         private void AppendCastIfNecessary(TypeDesc destType, StackValueKind srcType)
         {
             if (destType.IsValueType)
@@ -442,9 +504,38 @@ namespace Internal.IL
 
             _builder.Append("{");
 
+            int argCount = _methodSignature.Length + ((_thisType != null) ? 1 : 0);
+            for (int i = 0; i < argCount; i++)
+            {
+                TypeDesc argType = GetVarType(i, true);
+                TryAddGCRoot(GetVarName(i, true), _writer.GetCppSignatureTypeName(argType), GetStackValueKind(argType), argType);
+            }
+
+            for (int i = 0; i < _locals.Length; i++)
+            {
+                TypeDesc localType = _locals[i].Type;
+                TryAddGCRoot(GetVarName(i, false), _writer.GetCppSignatureTypeName(localType), GetStackValueKind(localType), localType, _locals[i].IsPinned);
+            }
+
+            if (_spillSlots != null)
+            {
+                foreach (var spillSlot in _spillSlots)
+                    TryAddGCRoot(spillSlot.Name, GetStackValueKindCPPTypeName(spillSlot.Kind, spillSlot.Type), spillSlot.Kind, spillSlot.Type);
+            }
+
+            HashSet<string> gcRootNames = new HashSet<string>();
+            foreach (var root in _gcRoots)
+                gcRootNames.Add(root.Name);
+
+            if (_gcRoots.Count != 0)
+                AppendShadowStackFrame(argCount);
+
             bool initLocals = _methodIL.GetInitLocals();
             for (int i = 0; i < _locals.Length; i++)
             {
+                if (gcRootNames.Contains(GetVarName(i, false)))
+                    continue;
+
                 Append(_writer.GetCppSignatureTypeName(_locals[i].Type));
                 Append(" ");
                 Append(GetVarName(i, false));
@@ -473,6 +564,9 @@ namespace Internal.IL
                 for (int i = 0; i < _spillSlots.Count; i++)
                 {
                     SpillSlot spillSlot = _spillSlots[i];
+                    if (gcRootNames.Contains(spillSlot.Name))
+                        continue;
+
                     Append(GetStackValueKindCPPTypeName(spillSlot.Kind, spillSlot.Type));
                     Append(" ");
                     Append(spillSlot.Name);
@@ -480,6 +574,19 @@ namespace Internal.IL
                 }
             }
 
+            if (_beforeFieldInitTriggers != null)
+            {
+                foreach (var type in _beforeFieldInitTriggers)
+                    AppendCctorTrigger(type);
+            }
+
+            for (int i = 0; i < _dispatchCellCount; i++)
+            {
+                Append("static __InterfaceDispatchCell ");
+                Append("__dispatchCell" + IntToString(i));
+                Finish();
+            }
+
             for (int i = 0; i < _exceptionRegions.Length; i++)
             {
                 var r = _exceptionRegions[i];
@@ -517,11 +624,82 @@ namespace Internal.IL
                 }
             }
 
+            if (_gcRoots.Count != 0)
+                _builder.Append("} ");
+
             _builder.AppendLine("}");
 
             methodCodeNodeNeedingCode.SetCode(_builder.ToString(), _dependencies.ToArray());
         }
 
+        // Declares the struct that holds the GC references of the method and pushes it on the shadow stack. The
+        // arguments are copied in, and the rest of the method body goes in a nested block that refers to the
+        // struct's fields by the names of the variables, which is closed at the end of Compile.
+        private void AppendShadowStackFrame(int argCount)
+        {
+            Append("struct __Roots { ");
+            foreach (var root in _gcRoots)
+            {
+                Append(root.TypeName);
+                Append(" ");
+                Append(root.Name);
+                Finish();
+            }
+
+            Append("static void __EnumRoots(void * pRoots, __ReportRoot * pfnReport, void * pContext) { ");
+            Append("__Roots * roots = (__Roots *)pRoots; ");
+            foreach (var root in _gcRoots)
+            {
+                string pinnedFlag = root.Pinned ? "|SHADOW_ROOT_PINNED" : "";
+                Action<string, bool> report = (path, interior) =>
+                {
+                    Append("pfnReport((void **)&");
+                    Append(path);
+                    Append(", ");
+                    Append((interior ? "SHADOW_ROOT_INTERIOR" : "0") + pinnedFlag);
+                    Append(", pContext)");
+                    Finish();
+                };
+
+                if (root.Kind == StackValueKind.ObjRef || root.Kind == StackValueKind.ByRef)
+                    report("roots->" + root.Name, root.Kind == StackValueKind.ByRef);
+                else
+                    _writer.EnumerateGCReferences(root.Type, "roots->" + root.Name, report);
+            }
+            Append("} } __roots");
+            Finish();
+
+            Append("memset(&__roots, 0, sizeof(__roots))");
+            Finish();
+
+            for (int i = 0; i < argCount; i++)
+            {
+                string name = GetVarName(i, true);
+                if (_gcRoots.Exists(root => root.Name == name))
+                {
+                    Append("__roots.");
+                    Append(name);
+                    Append("=");
+                    Append(name);
+                    Finish();
+                }
+            }
+
+            Append("__ShadowFrame __frame(&__roots, &__Roots::__EnumRoots)");
+            Finish();
+
+            _builder.Append("{ ");
+            foreach (var root in _gcRoots)
+            {
+                Append(root.TypeName);
+                Append("& ");
+                Append(root.Name);
+                Append("=__roots.");
+                Append(root.Name);
+                Finish();
+            }
+        }
+
         private void StartImportingBasicBlock(BasicBlock basicBlock)
         {
         }
@@ -670,6 +848,41 @@ namespace Internal.IL
                         return true;
                     }
                     break;
+                case "CompareExchange":
+                    if (IsTypeName(method, "System.Threading", "Interlocked"))
+                    {
+                        // The overloads on primitive types become a single compare-exchange instead of a call to
+                        // the runtime helper. The object overloads keep the helper since they need a write barrier.
+                        StackValueKind kind = GetStackValueKind(method.Signature.ReturnType);
+                        if (kind != StackValueKind.Int32 && kind != StackValueKind.Int64 && kind != StackValueKind.NativeInt)
+                            break;
+
+                        string typeName = GetStackValueKindCPPTypeName(kind);
+
+                        var comparand = Pop();
+                        var value = Pop();
+                        var location = Pop();
+
+                        PushTemp(kind);
+
+                        Append("__interlocked_compare_exchange((");
+                        Append(typeName);
+                        Append("*)");
+                        Append(location.Value.Name);
+                        Append(", (");
+                        Append(typeName);
+                        Append(")");
+                        Append(value.Value.Name);
+                        Append(", (");
+                        Append(typeName);
+                        Append(")");
+                        Append(comparand.Value.Name);
+                        Append(")");
+
+                        Finish();
+                        return true;
+                    }
+                    break;
                 default:
                     break;
             }
@@ -679,6 +892,9 @@ namespace Internal.IL
         private void ImportCall(ILOpcode opcode, int token)
         {
             bool callViaSlot = false;
+            bool callViaInterfaceResolver = false;
+            MethodDesc guardedTarget = null;
+            TypeDesc guardedType = null;
             bool delegateInvoke = false;
             DelegateInfo delegateInfo = null;
             bool mdArrayCreate = false;
@@ -757,21 +973,48 @@ namespace Internal.IL
 
                 if (method.IsVirtual)
                 {
-                    // TODO: Full resolution of virtual methods
-                    if (!method.IsNewSlot)
-                        throw new NotImplementedException();
+                    StackValue thisValue = _stack[_stackTop - (method.Signature.Length + 1)];
+                    TypeDesc thisType = thisValue.Type;
+
+                    // The guess of GetLikelyTarget below is checked at runtime, but a devirtualized call isn't, so
+                    // it can only rely on the type if it's known to be right.
+                    MethodDesc directMethod = TryDevirtualize(method, thisValue.TypeFromSpill ? null : thisType);
+                    if (directMethod != null)
+                    {
+                        method = directMethod;
+                        owningType = method.OwningType;
+                    }
+                    else
+                    {
+                        if (method.OwningType.IsInterface)
+                        {
+                            // TODO: Generic virtual methods
+                            if (method.HasInstantiation)
+                                throw new NotImplementedException();
 
-                    // TODO: Interface calls
-                    if (method.OwningType.IsInterface)
-                        throw new NotImplementedException();
+                            callViaInterfaceResolver = true;
+                        }
+                        else
+                        {
+                            method = VirtualFunctionResolution.FindSlotDefiningMethodForVirtualMethod(method);
+                            owningType = method.OwningType;
+                            callViaSlot = true;
+                        }
 
-                    _dependencies.Add(_nodeFactory.VirtualMethodUse(method));
+                        _dependencies.Add(_nodeFactory.VirtualMethodUse(method));
 
-                    callViaSlot = true;
+                        guardedTarget = GetLikelyTarget(method, thisType);
+                        if (guardedTarget != null)
+                        {
+                            guardedType = thisType;
+                            AddMethodReference(guardedTarget);
+                            AddTypeReference(guardedType, false);
+                        }
+                    }
                 }
             }
 
-            if (!callViaSlot && !delegateInvoke && !mdArrayCreate)
+            if (!callViaSlot && !callViaInterfaceResolver && !delegateInvoke && !mdArrayCreate)
                 AddMethodReference(method);
 
             if (opcode == ILOpcode.newobj)
@@ -790,15 +1033,20 @@ namespace Internal.IL
                 retKind = GetStackValueKind(retType);
                 temp = NewTempName();
 
-                Append(GetStackValueKindCPPTypeName(retKind, retType));
-                Append(" ");
-                Append(temp);
                 if (retType.IsValueType && opcode == ILOpcode.newobj)
                 {
-                    Append(";");
+                    // Constructed in place by the call below
+                    if (!TryAddGCRoot(temp, GetStackValueKindCPPTypeName(retKind, retType), retKind, retType))
+                    {
+                        Append(GetStackValueKindCPPTypeName(retKind, retType));
+                        Append(" ");
+                        Append(temp);
+                        Append(";");
+                    }
                 }
                 else
                 {
+                    AppendTempDeclaration(temp, retKind, retType);
                     Append("=");
 
                     if (retType.IsPointer)
@@ -834,7 +1082,46 @@ namespace Internal.IL
                 }
             }
 
-            if (callViaSlot || delegateInvoke)
+            if (guardedTarget != null)
+            {
+                // Call the likely target directly so that the C++ compiler can inline it, and only go through the
+                // slot if the object turns out to be of another type.
+                string thisName = _stack[_stackTop - (methodSignature.Length + 1)].Value.Name;
+
+                Append("((*(MethodTable **)");
+                Append(thisName);
+                Append(" == ");
+                Append(_writer.GetCppTypeName(guardedType));
+                Append("::__getMethodTable()) ? ");
+                Append(_writer.GetCppTypeName(guardedTarget.OwningType));
+                Append("::");
+                Append(_writer.GetCppMethodName(guardedTarget));
+                Append("(");
+                int stackTop = _stackTop;
+                PassCallArguments(methodSignature, guardedTarget.OwningType);
+                _stackTop = stackTop;
+                Append(") : ");
+            }
+
+            if (callViaInterfaceResolver)
+            {
+                string cell = NewDispatchCellName();
+
+                Append("((");
+                Append(_writer.GetCppTypeName(method.OwningType));
+                Append("::__slot__");
+                Append(_writer.GetCppMethodName(method));
+                Append(")__interface_dispatch(&");
+                Append(cell);
+                Append(", ");
+                Append(_stack[_stackTop - (methodSignature.Length + 1)].Value.Name);
+                Append(", &");
+                Append(_writer.GetCppTypeName(method.OwningType));
+                Append("::__resolve__");
+                Append(_writer.GetCppMethodName(method));
+                Append("))");
+            }
+            else if (callViaSlot || delegateInvoke)
             {
                 Append("(*");
                 Append(_writer.GetCppTypeName(method.OwningType));
@@ -902,11 +1189,63 @@ namespace Internal.IL
             PassCallArguments(methodSignature, thisArgument);
             Append(")");
 
+            if (guardedTarget != null)
+                Append(")");
+
             if (temp != null)
                 Push(retKind, new Value(temp), retType);
             Finish();
         }
 
+        // Returns the method a virtual call always ends up in given the static type of the object, or null if
+        // that depends on the exact type of the object. thisType is null if the static type isn't known.
+        private MethodDesc TryDevirtualize(MethodDesc method, TypeDesc thisType)
+        {
+            if (!method.OwningType.IsInterface && !method.IsAbstract)
+            {
+                MetadataType owningType = method.OwningType as MetadataType;
+                if (method.IsFinal || (owningType != null && owningType.IsSealed))
+                    return method;
+            }
+
+            MetadataType objectType = thisType as MetadataType;
+            if (objectType == null || objectType.IsValueType || objectType.IsInterface || !objectType.IsSealed)
+                return null;
+
+            return ResolveVirtualCallOnType(method, objectType);
+        }
+
+        // Returns the method a virtual call ends up in if the object is exactly of its static type, which is the
+        // most common case when the static type isn't abstract. Null if there's no such type or method, or if the
+        // static type is the one that introduced the method, since that is meant to be overriden.
+        private MethodDesc GetLikelyTarget(MethodDesc method, TypeDesc thisType)
+        {
+            MetadataType objectType = thisType as MetadataType;
+            if (objectType == null || objectType.IsValueType || objectType.IsInterface || objectType.IsAbstract)
+                return null;
+
+            if (objectType == method.OwningType)
+                return null;
+
+            if (method.HasInstantiation || objectType.HasInstantiation)
+                return null;
+
+            return ResolveVirtualCallOnType(method, objectType);
+        }
+
+        private MethodDesc ResolveVirtualCallOnType(MethodDesc method, MetadataType objectType)
+        {
+            MethodDesc target = method.OwningType.IsInterface ?
+                VirtualFunctionResolution.ResolveInterfaceMethodTargetOnObjectType(method, objectType) :
+                VirtualFunctionResolution.FindVirtualFunctionTargetMethodOnObjectType(method, objectType);
+
+            // Methods of value types expect an unboxed this
+            if (target == null || target.IsAbstract || target.OwningType.IsValueType)
+                return null;
+
+            return target;
+        }
+
         private void PassCallArguments(MethodSignature methodSignature, TypeDesc thisArgument)
         {
             int signatureLength = methodSignature.Length;
@@ -957,9 +1296,7 @@ namespace Internal.IL
                 retKind = GetStackValueKind(retType);
                 temp = NewTempName();
 
-                Append(GetStackValueKindCPPTypeName(retKind, retType));
-                Append(" ");
-                Append(temp);
+                AppendTempDeclaration(temp, retKind, retType);
                 Append("=");
 
                 if (retType.IsPointer)
@@ -1086,6 +1423,7 @@ namespace Internal.IL
                 {
                     StackValue spilledValue = _stack[i];
                     spilledValue.Value = NewSpillSlot(spilledValue.Kind, spilledValue.Type);
+                    spilledValue.TypeFromSpill = true;
                     entryStack[i] = spilledValue;
                 }
 
@@ -1469,16 +1807,19 @@ namespace Internal.IL
             if (field.IsStatic)
                 TriggerCctor(field.OwningType);
 
+            bool isVolatile = ConsumeVolatilePrefix();
+
             StackValueKind kind = GetStackValueKind(fieldType);
             PushTemp(kind, fieldType);
             AppendCastIfNecessary(kind, fieldType);
 
+            if (isVolatile && (field.IsStatic || thisPtr.Kind != StackValueKind.ValueType))
+                AppendVolatileAccess(fieldType);
+
             if (field.IsStatic)
             {
-                if (!fieldType.IsValueType)
-                    Append("__gcStatics.");
-                else
-                    Append("__statics.");
+                Append(_writer.GetCppStaticsName(field));
+                Append(".");
                 Append(_writer.GetCppStaticFieldName(field));
             }
             else
@@ -1502,6 +1843,12 @@ namespace Internal.IL
             }
 
             Finish();
+
+            if (isVolatile)
+            {
+                Append("__acquire_fence()");
+                Finish();
+            }
         }
 
         private void ImportAddressOfField(int token, bool isStatic)
@@ -1531,10 +1878,8 @@ namespace Internal.IL
 
             if (field.IsStatic)
             {
-                if (!fieldType.IsValueType)
-                    Append("__gcStatics.");
-                else
-                    Append("__statics.");
+                Append(_writer.GetCppStaticsName(field));
+                Append(".");
                 Append(_writer.GetCppStaticFieldName(field));
             }
             else
@@ -1578,14 +1923,21 @@ namespace Internal.IL
             if (field.IsStatic)
                 TriggerCctor(field.OwningType);
 
+            if (ConsumeVolatilePrefix())
+            {
+                Append("__release_fence()");
+                Finish();
+
+                if (field.IsStatic || thisPtr.Kind != StackValueKind.ValueType)
+                    AppendVolatileAccess(fieldType);
+            }
+
             // TODO: Write barrier as necessary!!!
 
             if (field.IsStatic)
             {
-                if (!fieldType.IsValueType)
-                    Append("__gcStatics.");
-                else
-                    Append("__statics.");
+                Append(_writer.GetCppStaticsName(field));
+                Append(".");
                 Append(_writer.GetCppStaticFieldName(field));
             }
             else
@@ -1629,14 +1981,22 @@ namespace Internal.IL
 
             var addr = Pop();
 
+            bool isVolatile = ConsumeVolatilePrefix();
+
             PushTemp(GetStackValueKind(type), type);
 
             Append("*(");
             Append(_writer.GetCppSignatureTypeName(type));
-            Append("*)");
+            Append((isVolatile && CanAccessVolatile(type)) ? " volatile*)" : "*)");
             Append(addr.Value.Name);
 
             Finish();
+
+            if (isVolatile)
+            {
+                Append("__acquire_fence()");
+                Finish();
+            }
         }
 
         private void ImportStoreIndirect(int token)
@@ -1652,11 +2012,18 @@ namespace Internal.IL
             var value = Pop();
             var addr = Pop();
 
+            bool isVolatile = ConsumeVolatilePrefix();
+            if (isVolatile)
+            {
+                Append("__release_fence()");
+                Finish();
+            }
+
             // TODO: Write barrier as necessary!!!
 
             Append("*(");
             Append(_writer.GetCppSignatureTypeName(type));
-            Append("*)");
+            Append((isVolatile && CanAccessVolatile(type)) ? " volatile*)" : "*)");
             Append(addr.Value.Name);
             Append("=");
             AppendCastIfNecessary(type, value.Kind);
@@ -2157,8 +2524,34 @@ namespace Internal.IL
 
         private void ImportVolatilePrefix()
         {
-            // TODO:
-            // throw new NotImplementedException();
+            _pendingPrefix |= Prefix.Volatile;
+        }
+
+        private bool ConsumeVolatilePrefix()
+        {
+            bool isVolatile = (_pendingPrefix & Prefix.Volatile) != 0;
+            _pendingPrefix &= ~Prefix.Volatile;
+            return isVolatile;
+        }
+
+        /// <summary>
+        /// Whether loads and stores with the volatile. prefix can go through a volatile C++ pointer, so that the C++
+        /// compiler accesses the location exactly once. Structs are copied as usual, only the fences order them.
+        /// </summary>
+        private static bool CanAccessVolatile(TypeDesc type)
+        {
+            return !type.IsValueType || type.IsPrimitive || type.IsEnum;
+        }
+
+        private void AppendVolatileAccess(TypeDesc type)
+        {
+            if (!CanAccessVolatile(type))
+                return;
+
+            // Qualifies the location itself, which is a pointer for object references
+            Append("*(");
+            Append(_writer.GetCppSignatureTypeName(type));
+            Append(" volatile*)&");
         }
 
         private void ImportTailPrefix()
@@ -2185,22 +2578,42 @@ namespace Internal.IL
 
         private void TriggerCctor(TypeDesc type)
         {
-            // TODO: Before field init
-
             MethodDesc cctor = type.GetStaticConstructor();
             if (cctor == null)
                 return;
 
-            // TODO: Thread safety
+            // The class constructor is already running
+            if (_method.IsStaticConstructor && _method.OwningType == type)
+                return;
+
+            AddMethodReference(cctor);
 
-            string ctorHasRun = "__statics.__cctor_" + _writer.GetCppTypeName(type).Replace("::", "__");
-            Append("if (!" + ctorHasRun + ") { " + ctorHasRun + " = true; ");
+            // beforefieldinit only requires the class constructor to run at some point before the first static
+            // field access, so trigger it once on entry to the method instead of at every access.
+            MetadataType metadataType = type as MetadataType;
+            if (metadataType != null && metadataType.IsBeforeFieldInit)
+            {
+                if (_beforeFieldInitTriggers == null)
+                    _beforeFieldInitTriggers = new List<TypeDesc>();
+                if (!_beforeFieldInitTriggers.Contains(type))
+                    _beforeFieldInitTriggers.Add(type);
+                return;
+            }
+
+            AppendCctorTrigger(type);
+        }
+
+        private void AppendCctorTrigger(TypeDesc type)
+        {
+            MethodDesc cctor = type.GetStaticConstructor();
+
+            string cctorState = "__statics.__cctor_" + _writer.GetCppTypeName(type).Replace("::", "__");
+            Append("__ensure_cctor(&" + cctorState + ", &");
             Append(_writer.GetCppTypeName(cctor.OwningType));
             Append("::");
             Append(_writer.GetCppMethodName(cctor));
-            Append("(); }");
-
-            AddMethodReference(cctor);
+            Append(")");
+            Finish();
         }
 
         private void AddTypeReference(TypeDesc type, bool constructed)
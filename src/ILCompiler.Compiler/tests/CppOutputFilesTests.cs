@@ -0,0 +1,118 @@
+﻿// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+using System;
+using System.IO;
+
+using ILCompiler.CppCodeGen;
+
+using Xunit;
+
+namespace ILCompiler.Compiler.Tests
+{
+    public class CppOutputFilesTests : IDisposable
+    {
+        private readonly string _directory;
+        private readonly string _outputFilePath;
+
+        public CppOutputFilesTests()
+        {
+            _directory = Path.Combine(Path.GetTempPath(), Path.GetRandomFileName());
+            Directory.CreateDirectory(_directory);
+            _outputFilePath = Path.Combine(_directory, "test.cpp");
+        }
+
+        public void Dispose()
+        {
+            Directory.Delete(_directory, true);
+        }
+
+        /// <summary>
+        /// Writes the files of a compilation into the given number of units the way CppWriter does
+        /// </summary>
+        private void WriteOutput(int unitCount, string contents)
+        {
+            if (unitCount > 1)
+            {
+                StringWriter header = new StringWriter();
+                CppOutputFiles.BeginHeader(header);
+                header.WriteLine(contents);
+                CppOutputFiles.WriteFileIfChanged(CppOutputFiles.GetHeaderPath(_outputFilePath), header.ToString());
+            }
+
+            for (int i = 0; i < unitCount; i++)
+                CppOutputFiles.WriteFileIfChanged(CppOutputFiles.GetUnitPath(_outputFilePath, i), contents + i);
+            CppOutputFiles.DeleteStaleFiles(_outputFilePath, unitCount);
+        }
+
+        private int CountFiles()
+        {
+            return Directory.GetFiles(_directory).Length;
+        }
+
+        [Fact]
+        public void TestUnitPaths()
+        {
+            Assert.Equal(_outputFilePath, CppOutputFiles.GetUnitPath(_outputFilePath, 0));
+            Assert.Equal(Path.Combine(_directory, "test.1.cpp"), CppOutputFiles.GetUnitPath(_outputFilePath, 1));
+            Assert.Equal(Path.Combine(_directory, "test.12.cpp"), CppOutputFiles.GetUnitPath(_outputFilePath, 12));
+            Assert.Equal(Path.Combine(_directory, "test.h"), CppOutputFiles.GetHeaderPath(_outputFilePath));
+        }
+
+        [Fact]
+        public void TestSplitOutputIsWritten()
+        {
+            WriteOutput(4, "a");
+
+            Assert.Equal(5, CountFiles());
+            Assert.True(File.Exists(CppOutputFiles.GetHeaderPath(_outputFilePath)));
+            for (int i = 0; i < 4; i++)
+                Assert.Equal("a" + i, File.ReadAllText(CppOutputFiles.GetUnitPath(_outputFilePath, i)));
+        }
+
+        [Fact]
+        public void TestUnchangedFilesAreNotRewritten()
+        {
+            string unitPath = CppOutputFiles.GetUnitPath(_outputFilePath, 1);
+
+            Assert.True(CppOutputFiles.WriteFileIfChanged(unitPath, "a"));
+            DateTime lastWriteTime = new DateTime(2000, 1, 1, 0, 0, 0, DateTimeKind.Utc);
+            File.SetLastWriteTimeUtc(unitPath, lastWriteTime);
+
+            Assert.False(CppOutputFiles.WriteFileIfChanged(unitPath, "a"));
+            Assert.Equal(lastWriteTime, File.GetLastWriteTimeUtc(unitPath));
+
+            Assert.True(CppOutputFiles.WriteFileIfChanged(unitPath, "b"));
+            Assert.Equal("b", File.ReadAllText(unitPath));
+        }
+
+        [Fact]
+        public void TestFewerUnitsDeleteStaleUnits()
+        {
+            WriteOutput(6, "a");
+            WriteOutput(2, "a");
+
+            // Units 0 and 1, and the header they share
+            Assert.Equal(3, CountFiles());
+            Assert.True(File.Exists(CppOutputFiles.GetHeaderPath(_outputFilePath)));
+            Assert.False(File.Exists(CppOutputFiles.GetUnitPath(_outputFilePath, 2)));
+            Assert.False(File.Exists(CppOutputFiles.GetUnitPath(_outputFilePath, 5)));
+
+            WriteOutput(1, "a");
+
+            Assert.Equal(1, CountFiles());
+            Assert.True(File.Exists(_outputFilePath));
+        }
+
+        [Fact]
+        public void TestHandWrittenHeaderIsKept()
+        {
+            string headerPath = CppOutputFiles.GetHeaderPath(_outputFilePath);
+            File.WriteAllText(headerPath, "// Not generated\n");
+
+            WriteOutput(1, "a");
+
+            Assert.Equal("// Not generated\n", File.ReadAllText(headerPath));
+        }
+    }
+}
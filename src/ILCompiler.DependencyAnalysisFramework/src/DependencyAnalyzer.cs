@@ -5,6 +5,9 @@ using System;
 using System.Collections.Generic;
 using System.Collections.Immutable;
 using System.Diagnostics;
+using System.Runtime.ExceptionServices;
+using System.Threading;
+using System.Threading.Tasks;
 
 namespace ILCompiler.DependencyAnalysisFramework
 {
@@ -21,12 +24,20 @@ namespace ILCompiler.DependencyAnalysisFramework
     /// with strings describing the reason a given node was added to the graph. The degree of logging
     /// is configurable via the MarkStrategy
     /// 
+    /// If the analyzer is given a degree of parallelism greater than one, the static dependencies of the
+    /// nodes on the mark stack are computed concurrently ahead of time. The mark stack is still drained one
+    /// node at a time on the calling thread, exactly as in serial mode, using the precomputed dependencies.
+    /// Nodes must then be able to compute their dependencies from multiple threads at once, and before they
+    /// are marked, but all changes to the graph (marking, OnMarked, logging) happen in the same order as a
+    /// serial run, so MarkedNodeList, and anything laid out from it, is identical to what a serial run produces.
+    /// 
     /// </summary>
     public sealed class DependencyAnalyzer<MarkStrategy, DependencyContextType> : DependencyAnalyzerBase<DependencyContextType> where MarkStrategy : struct, IDependencyAnalysisMarkStrategy<DependencyContextType>
     {
         private MarkStrategy _marker = new MarkStrategy();
         private DependencyContextType _dependencyContext;
         private IComparer<DependencyNodeCore<DependencyContextType>> _resultSorter = null;
+        private int _degreeOfParallelism;
 
         private Stack<DependencyNodeCore<DependencyContextType>> _markStack = new Stack<DependencyNodeCore<DependencyContextType>>();
         private List<DependencyNodeCore<DependencyContextType>> _markedNodes = new List<DependencyNodeCore<DependencyContextType>>();
@@ -37,6 +48,8 @@ namespace ILCompiler.DependencyAnalysisFramework
         private List<DynamicDependencyNode> _markedNodesWithDynamicDependencies = new List<DynamicDependencyNode>();
         private bool _newDynamicDependenciesMayHaveAppeared = false;
 
+        private Dictionary<DependencyNodeCore<DependencyContextType>, ComputedStaticDependencies> _precomputedStaticDependencies = new Dictionary<DependencyNodeCore<DependencyContextType>, ComputedStaticDependencies>();
+
         private Dictionary<DependencyNodeCore<DependencyContextType>, HashSet<DependencyNodeCore<DependencyContextType>.CombinedDependencyListEntry>> _conditional_dependency_store = new Dictionary<DependencyNodeCore<DependencyContextType>, HashSet<DependencyNodeCore<DependencyContextType>.CombinedDependencyListEntry>>();
         private bool _markingCompleted = false;
 
@@ -62,11 +75,47 @@ namespace ILCompiler.DependencyAnalysisFramework
             }
         }
 
+        /// <summary>
+        /// Static dependencies of a node computed ahead of adding them to the graph. The lists are
+        /// copied so that no enumeration of the node's state is left to do on the marking thread.
+        /// </summary>
+        private sealed class ComputedStaticDependencies
+        {
+            public readonly List<DependencyNodeCore<DependencyContextType>.DependencyListEntry> StaticDependencies;
+            public readonly List<DependencyNodeCore<DependencyContextType>.CombinedDependencyListEntry> ConditionalStaticDependencies;
+
+            public ComputedStaticDependencies(DependencyNodeCore<DependencyContextType> node, DependencyContextType context)
+            {
+                IEnumerable<DependencyNodeCore<DependencyContextType>.DependencyListEntry> staticDependencies = node.GetStaticDependencies(context);
+                if (staticDependencies != null)
+                    StaticDependencies = new List<DependencyNodeCore<DependencyContextType>.DependencyListEntry>(staticDependencies);
+
+                if (node.HasConditionalStaticDependencies)
+                {
+                    IEnumerable<DependencyNodeCore<DependencyContextType>.CombinedDependencyListEntry> conditionalStaticDependencies = node.GetConditionalStaticDependencies(context);
+                    if (conditionalStaticDependencies != null)
+                        ConditionalStaticDependencies = new List<DependencyNodeCore<DependencyContextType>.CombinedDependencyListEntry>(conditionalStaticDependencies);
+                }
+            }
+        }
+
+        // Batches are only split across threads when each thread gets at least this many nodes
+        private const int MinimumNodesPerWorker = 16;
+
         // Api surface
         public DependencyAnalyzer(DependencyContextType dependencyContext, IComparer<DependencyNodeCore<DependencyContextType>> resultSorter)
+            : this(dependencyContext, resultSorter, 1)
+        {
+        }
+
+        public DependencyAnalyzer(DependencyContextType dependencyContext, IComparer<DependencyNodeCore<DependencyContextType>> resultSorter, int degreeOfParallelism)
         {
+            if (degreeOfParallelism < 1)
+                throw new ArgumentOutOfRangeException("degreeOfParallelism");
+
             _dependencyContext = dependencyContext;
             _resultSorter = resultSorter;
+            _degreeOfParallelism = degreeOfParallelism;
         }
 
         /// <summary>
@@ -135,7 +184,22 @@ namespace ILCompiler.DependencyAnalysisFramework
         // Internal details
         private void GetStaticDependenciesImpl(DependencyNodeCore<DependencyContextType> node)
         {
-            IEnumerable<DependencyNodeCore<DependencyContextType>.DependencyListEntry> staticDependencies = node.GetStaticDependencies(_dependencyContext);
+            AddStaticDependencies(node, node.GetStaticDependencies(_dependencyContext));
+
+            if (node.HasConditionalStaticDependencies)
+                AddConditionalStaticDependencies(node, node.GetConditionalStaticDependencies(_dependencyContext));
+        }
+
+        private void AddStaticDependencies(DependencyNodeCore<DependencyContextType> node, ComputedStaticDependencies computedStaticDependencies)
+        {
+            AddStaticDependencies(node, computedStaticDependencies.StaticDependencies);
+
+            if (computedStaticDependencies.ConditionalStaticDependencies != null)
+                AddConditionalStaticDependencies(node, computedStaticDependencies.ConditionalStaticDependencies);
+        }
+
+        private void AddStaticDependencies(DependencyNodeCore<DependencyContextType> node, IEnumerable<DependencyNodeCore<DependencyContextType>.DependencyListEntry> staticDependencies)
+        {
             if (staticDependencies != null)
             {
                 foreach (DependencyNodeCore<DependencyContextType>.DependencyListEntry dependency in staticDependencies)
@@ -143,31 +207,31 @@ namespace ILCompiler.DependencyAnalysisFramework
                     AddToMarkStack(dependency.Node, dependency.Reason, node, null);
                 }
             }
+        }
 
-            if (node.HasConditionalStaticDependencies)
+        private void AddConditionalStaticDependencies(DependencyNodeCore<DependencyContextType> node, IEnumerable<DependencyNodeCore<DependencyContextType>.CombinedDependencyListEntry> conditionalStaticDependencies)
+        {
+            foreach (DependencyNodeCore<DependencyContextType>.CombinedDependencyListEntry dependency in conditionalStaticDependencies)
             {
-                foreach (DependencyNodeCore<DependencyContextType>.CombinedDependencyListEntry dependency in node.GetConditionalStaticDependencies(_dependencyContext))
+                if (dependency.OtherReasonNode.Marked)
                 {
-                    if (dependency.OtherReasonNode.Marked)
+                    AddToMarkStack(dependency.Node, dependency.Reason, node, dependency.OtherReasonNode);
+                }
+                else
+                {
+                    HashSet<DependencyNodeCore<DependencyContextType>.CombinedDependencyListEntry> storedDependencySet = null;
+                    if (!_conditional_dependency_store.TryGetValue(dependency.OtherReasonNode, out storedDependencySet))
                     {
-                        AddToMarkStack(dependency.Node, dependency.Reason, node, dependency.OtherReasonNode);
+                        storedDependencySet = new HashSet<DependencyNodeCore<DependencyContextType>.CombinedDependencyListEntry>();
+                        _conditional_dependency_store.Add(dependency.OtherReasonNode, storedDependencySet);
                     }
-                    else
-                    {
-                        HashSet<DependencyNodeCore<DependencyContextType>.CombinedDependencyListEntry> storedDependencySet = null;
-                        if (!_conditional_dependency_store.TryGetValue(dependency.OtherReasonNode, out storedDependencySet))
-                        {
-                            storedDependencySet = new HashSet<DependencyNodeCore<DependencyContextType>.CombinedDependencyListEntry>();
-                            _conditional_dependency_store.Add(dependency.OtherReasonNode, storedDependencySet);
-                        }
-                        // Swap out other reason node as we're storing that as the dictionary key
-                        DependencyNodeCore<DependencyContextType>.CombinedDependencyListEntry conditionalDependencyStoreEntry = new DependencyNodeCore<DependencyContextType>.CombinedDependencyListEntry();
-                        conditionalDependencyStoreEntry.Node = dependency.Node;
-                        conditionalDependencyStoreEntry.Reason = dependency.Reason;
-                        conditionalDependencyStoreEntry.OtherReasonNode = node;
+                    // Swap out other reason node as we're storing that as the dictionary key
+                    DependencyNodeCore<DependencyContextType>.CombinedDependencyListEntry conditionalDependencyStoreEntry = new DependencyNodeCore<DependencyContextType>.CombinedDependencyListEntry();
+                    conditionalDependencyStoreEntry.Node = dependency.Node;
+                    conditionalDependencyStoreEntry.Reason = dependency.Reason;
+                    conditionalDependencyStoreEntry.OtherReasonNode = node;
 
-                        storedDependencySet.Add(conditionalDependencyStoreEntry);
-                    }
+                    storedDependencySet.Add(conditionalDependencyStoreEntry);
                 }
             }
         }
@@ -184,47 +248,192 @@ namespace ILCompiler.DependencyAnalysisFramework
             }
         }
 
-        private void ProcessMarkStack()
+        private void ProcessMarkedNode(DependencyNodeCore<DependencyContextType> currentNode, ComputedStaticDependencies computedStaticDependencies)
         {
-            do
+            Debug.Assert(currentNode.Marked);
+
+            // Only some marked objects are interesting for dynamic dependencies
+            // store those in a seperate list to avoid excess scanning over non-interesting
+            // nodes during dynamic dependency discovery
+            if (currentNode.InterestingForDynamicDependencyAnalysis)
+            {
+                _dynamicDependencyInterestingList.Add(currentNode);
+                _newDynamicDependenciesMayHaveAppeared = true;
+            }
+
+            // Add all static dependencies to the mark stack
+            if (computedStaticDependencies != null)
+                AddStaticDependencies(currentNode, computedStaticDependencies);
+            else
+                GetStaticDependencies(currentNode);
+
+            // If there are dynamic dependencies, note for later
+            if (currentNode.HasDynamicDependencies)
             {
-                while (_markStack.Count > 0)
+                _newDynamicDependenciesMayHaveAppeared = true;
+                _markedNodesWithDynamicDependencies.Add(new DynamicDependencyNode(currentNode));
+            }
+
+            // If this new node satisfies any stored conditional dependencies, 
+            // add them to the mark stack
+            HashSet<DependencyNodeCore<DependencyContextType>.CombinedDependencyListEntry> storedDependencySet = null;
+            if (_conditional_dependency_store.TryGetValue(currentNode, out storedDependencySet))
+            {
+                foreach (DependencyNodeCore<DependencyContextType>.CombinedDependencyListEntry newlySatisfiedDependency in storedDependencySet)
                 {
-                    // Pop the top node of the mark stack
-                    DependencyNodeCore<DependencyContextType> currentNode = _markStack.Pop();
+                    AddToMarkStack(newlySatisfiedDependency.Node, newlySatisfiedDependency.Reason, newlySatisfiedDependency.OtherReasonNode, currentNode);
+                }
+
+                _conditional_dependency_store.Remove(currentNode);
+            }
+        }
 
-                    Debug.Assert(currentNode.Marked);
+        /// <summary>
+        /// Computes the static dependencies of the nodes at the top of the mark stack concurrently, so that they
+        /// are ready by the time each node is popped. The static dependencies of a node are always marked once the
+        /// node is processed, so the ones which aren't marked yet are computed too, a level at a time, until each
+        /// thread has had a batch worth of nodes. That keeps the threads busy while the mark stack is drained depth
+        /// first, where each node only pushes a few new ones.
+        /// </summary>
+        private void PrecomputeStaticDependencies()
+        {
+            List<DependencyNodeCore<DependencyContextType>> batch = new List<DependencyNodeCore<DependencyContextType>>();
+            foreach (DependencyNodeCore<DependencyContextType> node in _markStack)
+            {
+                // Nodes which aren't ready are deferred when they are popped, same as in serial mode
+                if (!node.StaticDependenciesAreComputed)
+                    continue;
+
+                // Everything pushed before this was looked at by an earlier batch. Anything it missed gets its
+                // own batch once it's on top.
+                if (_precomputedStaticDependencies.ContainsKey(node))
+                    break;
+
+                batch.Add(node);
+            }
 
-                    // Only some marked objects are interesting for dynamic dependencies
-                    // store those in a seperate list to avoid excess scanning over non-interesting
-                    // nodes during dynamic dependency discovery
-                    if (currentNode.InterestingForDynamicDependencyAnalysis)
+            int precomputedCount = 0;
+            while (batch.Count > 0)
+            {
+                ComputedStaticDependencies[] computedStaticDependencies = new ComputedStaticDependencies[batch.Count];
+                ComputeStaticDependenciesInParallel(batch, computedStaticDependencies);
+
+                for (int i = 0; i < batch.Count; i++)
+                {
+                    _precomputedStaticDependencies.Add(batch[i], computedStaticDependencies[i]);
+                }
+
+                precomputedCount += batch.Count;
+                if (precomputedCount >= _degreeOfParallelism * MinimumNodesPerWorker)
+                    break;
+
+                // The next level is every not yet marked static dependency of this one
+                HashSet<DependencyNodeCore<DependencyContextType>> nextLevel = new HashSet<DependencyNodeCore<DependencyContextType>>();
+                List<DependencyNodeCore<DependencyContextType>> nextBatch = new List<DependencyNodeCore<DependencyContextType>>();
+                foreach (ComputedStaticDependencies computed in computedStaticDependencies)
+                {
+                    if (computed.StaticDependencies == null)
+                        continue;
+
+                    foreach (DependencyNodeCore<DependencyContextType>.DependencyListEntry dependency in computed.StaticDependencies)
                     {
-                        _dynamicDependencyInterestingList.Add(currentNode);
-                        _newDynamicDependenciesMayHaveAppeared = true;
+                        DependencyNodeCore<DependencyContextType> node = dependency.Node;
+                        if (!node.Marked && node.StaticDependenciesAreComputed &&
+                            !_precomputedStaticDependencies.ContainsKey(node) && nextLevel.Add(node))
+                        {
+                            nextBatch.Add(node);
+                        }
                     }
+                }
 
-                    // Add all static dependencies to the mark stack
-                    GetStaticDependencies(currentNode);
+                batch = nextBatch;
+            }
+        }
 
-                    // If there are dynamic dependencies, note for later
-                    if (currentNode.HasDynamicDependencies)
+        private void ProcessMarkStackInParallel()
+        {
+            while (_markStack.Count > 0)
+            {
+                DependencyNodeCore<DependencyContextType> currentNode = _markStack.Peek();
+                if (currentNode.StaticDependenciesAreComputed && !_precomputedStaticDependencies.ContainsKey(currentNode))
+                    PrecomputeStaticDependencies();
+
+                // Pop the top node of the mark stack, and process it the way a serial run would
+                _markStack.Pop();
+
+                ComputedStaticDependencies computedStaticDependencies;
+                if (_precomputedStaticDependencies.TryGetValue(currentNode, out computedStaticDependencies))
+                    _precomputedStaticDependencies.Remove(currentNode);
+
+                ProcessMarkedNode(currentNode, computedStaticDependencies);
+            }
+        }
+
+        private void ComputeStaticDependenciesInParallel(List<DependencyNodeCore<DependencyContextType>> nodes, ComputedStaticDependencies[] results)
+        {
+            Exception[] exceptions = null;
+            int nextIndex = -1;
+
+            Action worker = () =>
+            {
+                int index;
+                while ((index = Interlocked.Increment(ref nextIndex)) < nodes.Count)
+                {
+                    DependencyNodeCore<DependencyContextType> node = nodes[index];
+
+                    // Nodes which aren't ready yet are left for ComputeDependencies
+                    if (!node.StaticDependenciesAreComputed)
+                        continue;
+
+                    try
                     {
-                        _newDynamicDependenciesMayHaveAppeared = true;
-                        _markedNodesWithDynamicDependencies.Add(new DynamicDependencyNode(currentNode));
+                        results[index] = new ComputedStaticDependencies(node, _dependencyContext);
                     }
-
-                    // If this new node satisfies any stored conditional dependencies, 
-                    // add them to the mark stack
-                    HashSet<DependencyNodeCore<DependencyContextType>.CombinedDependencyListEntry> storedDependencySet = null;
-                    if (_conditional_dependency_store.TryGetValue(currentNode, out storedDependencySet))
+                    catch (Exception e)
                     {
-                        foreach (DependencyNodeCore<DependencyContextType>.CombinedDependencyListEntry newlySatisfiedDependency in storedDependencySet)
-                        {
-                            AddToMarkStack(newlySatisfiedDependency.Node, newlySatisfiedDependency.Reason, newlySatisfiedDependency.OtherReasonNode, currentNode);
-                        }
+                        if (exceptions == null)
+                            Interlocked.CompareExchange(ref exceptions, new Exception[nodes.Count], null);
+                        exceptions[index] = e;
+                    }
+                }
+            };
+
+            // Small batches aren't worth the cost of handing them to other threads
+            int workerCount = Math.Min(_degreeOfParallelism, nodes.Count / MinimumNodesPerWorker);
+            Task[] workers = new Task[Math.Max(workerCount - 1, 0)];
+            for (int i = 0; i < workers.Length; i++)
+            {
+                workers[i] = Task.Run(worker);
+            }
+
+            worker();
+            Task.WaitAll(workers);
 
-                        _conditional_dependency_store.Remove(currentNode);
+            // Report the failure of the first node in the batch, whichever thread saw it first
+            if (exceptions != null)
+            {
+                foreach (Exception e in exceptions)
+                {
+                    if (e != null)
+                        ExceptionDispatchInfo.Capture(e).Throw();
+                }
+            }
+        }
+
+        private void ProcessMarkStack()
+        {
+            do
+            {
+                if (_degreeOfParallelism > 1)
+                {
+                    ProcessMarkStackInParallel();
+                }
+                else
+                {
+                    while (_markStack.Count > 0)
+                    {
+                        // Pop the top node of the mark stack
+                        ProcessMarkedNode(_markStack.Pop(), null);
                     }
                 }
 
@@ -249,10 +458,24 @@ namespace ILCompiler.DependencyAnalysisFramework
 
                 // Compute all dependencies which were not ready during the ProcessMarkStack step
                 ComputeDependencies(_deferredStaticDependencies);
-                foreach (DependencyNodeCore<DependencyContextType> node in _deferredStaticDependencies)
+                if (_degreeOfParallelism > 1)
                 {
-                    Debug.Assert(node.StaticDependenciesAreComputed);
-                    GetStaticDependenciesImpl(node);
+                    ComputedStaticDependencies[] computedStaticDependencies = new ComputedStaticDependencies[_deferredStaticDependencies.Count];
+                    ComputeStaticDependenciesInParallel(_deferredStaticDependencies, computedStaticDependencies);
+
+                    for (int i = 0; i < _deferredStaticDependencies.Count; i++)
+                    {
+                        Debug.Assert(computedStaticDependencies[i] != null);
+                        AddStaticDependencies(_deferredStaticDependencies[i], computedStaticDependencies[i]);
+                    }
+                }
+                else
+                {
+                    foreach (DependencyNodeCore<DependencyContextType> node in _deferredStaticDependencies)
+                    {
+                        Debug.Assert(node.StaticDependenciesAreComputed);
+                        GetStaticDependenciesImpl(node);
+                    }
                 }
 
                 _deferredStaticDependencies.Clear();
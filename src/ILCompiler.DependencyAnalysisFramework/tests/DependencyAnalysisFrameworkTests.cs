@@ -38,6 +38,12 @@ namespace ILCompiler.DependencyAnalysisFramework.Tests
             DependencyAnalyzerBase<TestGraph> analyzerNoLog = new DependencyAnalyzer<NoLogStrategy<TestGraph>, TestGraph>(testGraphNoLog, null);
             testGraphNoLog.AttachToDependencyAnalyzer(analyzerNoLog);
             testGraph(testGraphNoLog, analyzerNoLog);
+
+            // Test computing dependencies on multiple threads
+            TestGraph testGraphParallel = new TestGraph();
+            DependencyAnalyzerBase<TestGraph> analyzerParallel = new DependencyAnalyzer<NoLogStrategy<TestGraph>, TestGraph>(testGraphParallel, null, 4);
+            testGraphParallel.AttachToDependencyAnalyzer(analyzerParallel);
+            testGraph(testGraphParallel, analyzerParallel);
         }
 
         [Fact]
@@ -160,6 +166,42 @@ namespace ILCompiler.DependencyAnalysisFramework.Tests
             Assert.True(results.Count == 11);
         }
 
+        private List<string> AnalyzeWideGraph(int degreeOfParallelism, bool computeDependenciesOnDemand)
+        {
+            TestGraph testGraph = new TestGraph();
+            DependencyAnalyzerBase<TestGraph> analyzer = new DependencyAnalyzer<FullGraphLogStrategy<TestGraph>, TestGraph>(testGraph, null, degreeOfParallelism);
+            testGraph.AttachToDependencyAnalyzer(analyzer);
+            if (computeDependenciesOnDemand)
+                testGraph.ComputeDependenciesOnDemand(0);
+
+            // Enough nodes at each level for the batches to be split across threads
+            for (int i = 0; i < 1000; i++)
+            {
+                testGraph.AddStaticRule("Root", "A" + i, "Root depends on A" + i);
+                testGraph.AddStaticRule("A" + i, "B" + (i % 100), "A" + i + " depends on B" + (i % 100));
+                testGraph.AddConditionalRule("A" + i, "B" + ((i + 1) % 100), "C" + i, "A" + i + " depends on C" + i + " if B" + ((i + 1) % 100));
+            }
+            testGraph.AddRoot("Root", "Root is root");
+
+            return testGraph.AnalysisResults;
+        }
+
+        [Fact]
+        public void TestParallelAnalysisIsDeterministic()
+        {
+            foreach (bool computeDependenciesOnDemand in new bool[] { false, true })
+            {
+                List<string> serialResults = AnalyzeWideGraph(1, computeDependenciesOnDemand);
+                Assert.Equal(2101, serialResults.Count);
+
+                // The nodes are marked in exactly the order a serial run marks them in
+                for (int i = 0; i < 4; i++)
+                {
+                    Assert.Equal(serialResults, AnalyzeWideGraph(8, computeDependenciesOnDemand));
+                }
+            }
+        }
+
         [Fact]
         public void TestDGMLOutput()
         {
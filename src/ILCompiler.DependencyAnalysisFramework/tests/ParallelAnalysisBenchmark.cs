@@ -0,0 +1,81 @@
+﻿// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+using System;
+using System.Collections.Generic;
+using System.Diagnostics;
+
+using ILCompiler.DependencyAnalysisFramework;
+
+using Xunit;
+using Xunit.Abstractions;
+
+namespace ILCompiler.DependencyAnalysisFramework.Tests
+{
+    /// <summary>
+    /// Times dependency analysis of a large graph at several degrees of parallelism. The graph is layered, and
+    /// each node depends on a few nodes of the next layer, so the mark stack is drained mostly depth first like
+    /// in a real compilation. The timings are written to the test output; the test only fails if a parallel
+    /// run marks the nodes in a different order than the serial one.
+    /// </summary>
+    public class ParallelAnalysisBenchmark
+    {
+        private const int Layers = 20;
+        private const int NodesPerLayer = 500;
+        private const int DependenciesPerNode = 3;
+        private const int WorkPerNode = 20000;
+
+        private readonly ITestOutputHelper _output;
+
+        public ParallelAnalysisBenchmark(ITestOutputHelper output)
+        {
+            _output = output;
+        }
+
+        private List<string> AnalyzeLayeredGraph(int degreeOfParallelism, out long elapsedMilliseconds)
+        {
+            TestGraph testGraph = new TestGraph();
+            DependencyAnalyzerBase<TestGraph> analyzer = new DependencyAnalyzer<NoLogStrategy<TestGraph>, TestGraph>(testGraph, null, degreeOfParallelism);
+            testGraph.AttachToDependencyAnalyzer(analyzer);
+            testGraph.ComputeDependenciesOnDemand(WorkPerNode);
+
+            for (int i = 0; i < NodesPerLayer; i++)
+            {
+                testGraph.AddStaticRule("Root", "L0N" + i, "Root depends on layer 0");
+
+                for (int layer = 0; layer < Layers - 1; layer++)
+                {
+                    for (int j = 0; j < DependenciesPerNode; j++)
+                    {
+                        int dependency = (i * DependenciesPerNode + j) % NodesPerLayer;
+                        testGraph.AddStaticRule("L" + layer + "N" + i, "L" + (layer + 1) + "N" + dependency, "Depends on the next layer");
+                    }
+                }
+            }
+
+            Stopwatch stopwatch = Stopwatch.StartNew();
+            testGraph.AddRoot("Root", "Root is root");
+            List<string> results = testGraph.AnalysisResults;
+            elapsedMilliseconds = stopwatch.ElapsedMilliseconds;
+
+            return results;
+        }
+
+        [Fact]
+        public void BenchmarkParallelAnalysis()
+        {
+            long serialMilliseconds;
+            List<string> serialResults = AnalyzeLayeredGraph(1, out serialMilliseconds);
+            Assert.Equal(Layers * NodesPerLayer + 1, serialResults.Count);
+            _output.WriteLine("Degree of parallelism 1: " + serialMilliseconds + " ms");
+
+            foreach (int degreeOfParallelism in new int[] { 2, 4, Environment.ProcessorCount })
+            {
+                long parallelMilliseconds;
+                List<string> parallelResults = AnalyzeLayeredGraph(degreeOfParallelism, out parallelMilliseconds);
+                Assert.Equal(serialResults, parallelResults);
+                _output.WriteLine("Degree of parallelism " + degreeOfParallelism + ": " + parallelMilliseconds + " ms");
+            }
+        }
+    }
+}
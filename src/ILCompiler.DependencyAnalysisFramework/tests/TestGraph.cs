@@ -5,6 +5,7 @@ using System;
 using System.Collections.Generic;
 using System.Linq;
 using System.Text;
+using System.Threading;
 using System.Threading.Tasks;
 using ILCompiler.DependencyAnalysisFramework;
 
@@ -15,11 +16,13 @@ namespace ILCompiler.DependencyAnalysisFramework.Tests
         public class TestNode : ComputedStaticDependencyNode<TestGraph>
         {
             private readonly string _data;
+            private readonly TestGraph _graph;
             private readonly static CombinedDependencyListEntry[] s_emptyDynamicList = new CombinedDependencyListEntry[0];
 
-            public TestNode(string data)
+            public TestNode(string data, TestGraph graph)
             {
                 _data = data;
+                _graph = graph;
             } 
 
             public string Data
@@ -35,6 +38,39 @@ namespace ILCompiler.DependencyAnalysisFramework.Tests
                 return _data;
             }
 
+            public override bool StaticDependenciesAreComputed
+            {
+                get
+                {
+                    return _graph._computeDependenciesOnDemand || base.StaticDependenciesAreComputed;
+                }
+            }
+
+            public override bool HasConditionalStaticDependencies
+            {
+                get
+                {
+                    return _graph._computeDependenciesOnDemand || base.HasConditionalStaticDependencies;
+                }
+            }
+
+            public override IEnumerable<DependencyListEntry> GetStaticDependencies(TestGraph context)
+            {
+                if (!context._computeDependenciesOnDemand)
+                    return base.GetStaticDependencies(context);
+
+                context.DoWork(this);
+                return context.GetStaticRules(this);
+            }
+
+            public override IEnumerable<CombinedDependencyListEntry> GetConditionalStaticDependencies(TestGraph context)
+            {
+                if (!context._computeDependenciesOnDemand)
+                    return base.GetConditionalStaticDependencies(context);
+
+                return context.GetConditionalRules(this);
+            }
+
             public override bool HasDynamicDependencies
             {
                 get
@@ -77,6 +113,32 @@ namespace ILCompiler.DependencyAnalysisFramework.Tests
         Dictionary<string, TestNode> _nodes = new Dictionary<string, TestNode>();
         DependencyAnalyzerBase<TestGraph> _analyzer;
 
+        bool _computeDependenciesOnDemand;
+        int _workPerNode;
+        int _workResult;
+
+        /// <summary>
+        /// Have nodes compute their static dependencies when the analyzer asks for them, rather than all being
+        /// deferred to the ComputeDependencyRoutine. Each node spins for workPerNode iterations first, to stand
+        /// in for the work a real node does to find its dependencies.
+        /// </summary>
+        public void ComputeDependenciesOnDemand(int workPerNode)
+        {
+            _computeDependenciesOnDemand = true;
+            _workPerNode = workPerNode;
+        }
+
+        private void DoWork(TestNode node)
+        {
+            int hash = 0;
+            for (int i = 0; i < _workPerNode; i++)
+            {
+                hash = hash * 31 + node.Data[i % node.Data.Length];
+            }
+
+            Volatile.Write(ref _workResult, hash);
+        }
+
         public void AddStaticRule(string depender, string dependedOn, string reason)
         {
             HashSet<Tuple<string, string>> knownEdges = null;
@@ -113,10 +175,15 @@ namespace ILCompiler.DependencyAnalysisFramework.Tests
         public TestNode GetNode(string nodeName)
         {
             TestNode node;
-            if (!_nodes.TryGetValue(nodeName, out node))
+
+            // Nodes computing their dependencies on demand may do so on several threads
+            lock (_nodes)
             {
-                node = new TestNode(nodeName);
-                _nodes.Add(nodeName, node);
+                if (!_nodes.TryGetValue(nodeName, out node))
+                {
+                    node = new TestNode(nodeName, this);
+                    _nodes.Add(nodeName, node);
+                }
             }
 
             return node;
@@ -132,29 +199,40 @@ namespace ILCompiler.DependencyAnalysisFramework.Tests
         {
             foreach (TestNode node in obj)
             {
-                List<TestNode.DependencyListEntry> staticList = new List<DependencyNodeCore<TestGraph>.DependencyListEntry>();
-                List<TestNode.CombinedDependencyListEntry> conditionalStaticList = new List<DependencyNodeCore<TestGraph>.CombinedDependencyListEntry>();
+                node.SetStaticDependencies(GetStaticRules(node), GetConditionalRules(node));
+            }
+        }
 
-                HashSet<Tuple<string, string>> nonConditionalRules;
-                if (_staticNonConditionalRules.TryGetValue(node.Data, out nonConditionalRules))
+        private List<TestNode.DependencyListEntry> GetStaticRules(TestNode node)
+        {
+            List<TestNode.DependencyListEntry> staticList = new List<DependencyNodeCore<TestGraph>.DependencyListEntry>();
+
+            HashSet<Tuple<string, string>> nonConditionalRules;
+            if (_staticNonConditionalRules.TryGetValue(node.Data, out nonConditionalRules))
+            {
+                foreach (Tuple<string, string> dependedOn in nonConditionalRules)
                 {
-                    foreach (Tuple<string, string> dependedOn in nonConditionalRules)
-                    {
-                        staticList.Add(new TestNode.DependencyListEntry(GetNode(dependedOn.Item1), dependedOn.Item2));
-                    }
+                    staticList.Add(new TestNode.DependencyListEntry(GetNode(dependedOn.Item1), dependedOn.Item2));
                 }
+            }
+
+            return staticList;
+        }
+
+        private List<TestNode.CombinedDependencyListEntry> GetConditionalRules(TestNode node)
+        {
+            List<TestNode.CombinedDependencyListEntry> conditionalStaticList = new List<DependencyNodeCore<TestGraph>.CombinedDependencyListEntry>();
 
-                HashSet<Tuple<string, Tuple<string, string>>> conditionalRules;
-                if (_staticConditionalRules.TryGetValue(node.Data, out conditionalRules))
+            HashSet<Tuple<string, Tuple<string, string>>> conditionalRules;
+            if (_staticConditionalRules.TryGetValue(node.Data, out conditionalRules))
+            {
+                foreach (Tuple<string, Tuple<string, string>> dependedOn in conditionalRules)
                 {
-                    foreach (Tuple<string, Tuple<string, string>> dependedOn in conditionalRules)
-                    {
-                        conditionalStaticList.Add(new TestNode.CombinedDependencyListEntry(GetNode(dependedOn.Item1), GetNode(dependedOn.Item2.Item1), dependedOn.Item2.Item2));
-                    }
+                    conditionalStaticList.Add(new TestNode.CombinedDependencyListEntry(GetNode(dependedOn.Item1), GetNode(dependedOn.Item2.Item1), dependedOn.Item2.Item2));
                 }
-
-                node.SetStaticDependencies(staticList, conditionalStaticList);
             }
+
+            return conditionalStaticList;
         }
 
         public List<string> AnalysisResults
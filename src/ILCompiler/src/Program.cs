@@ -33,6 +33,10 @@ namespace ILCompiler
             Console.WriteLine("-help        Display this usage message (Short form: -?)");
             Console.WriteLine("-out         Specify output file name");
             Console.WriteLine("-reference   Reference metadata from the specified assembly (Short form: -r)");
+            Console.WriteLine("-cppunits    With -cpp, number of C++ files to split the output into, with a header for their shared");
+            Console.WriteLine("             declarations. Files from an earlier run into more units are deleted");
+            Console.WriteLine("-parallelism Number of threads for dependency analysis and RyuJIT code generation. The output is");
+            Console.WriteLine("             the same as with a single thread");
         }
 
         private void InitializeDefaultOptions()
@@ -113,6 +117,14 @@ namespace ILCompiler
                         _options.NoLineNumbers = true;
                         break;
 
+                    case "cppunits":
+                        _options.CppUnitCount = Int32.Parse(parser.GetStringValue());
+                        break;
+
+                    case "parallelism":
+                        _options.Parallelism = Int32.Parse(parser.GetStringValue());
+                        break;
+
                     case "systemmodule":
                         _options.SystemModuleName = parser.GetStringValue();
                         break;
@@ -1,4 +1,4 @@
-// Copyright (c) Microsoft. All rights reserved.
+﻿// Copyright (c) Microsoft. All rights reserved.
 // Licensed under the MIT license. See LICENSE file in the project root for full license information.
 
 using System;
@@ -67,11 +67,20 @@ namespace Internal.JitInterface
             _jit = getJit();
         }
 
+        private TextWriter _log;
+
+        /// <summary>
+        /// Where to log messages from compiling a method. Defaults to the compilation's log.
+        /// </summary>
         public TextWriter Log
         {
             get
             {
-                return _compilation.Log;
+                return _log ?? _compilation.Log;
+            }
+            set
+            {
+                _log = value;
             }
         }
 
@@ -21,6 +21,10 @@
 
 #include <new>
 
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
 #ifndef WIN32
 #include <pthread.h>
 #include <alloca.h>
@@ -39,6 +43,7 @@ extern "C" Object * RhNewMDArray(MethodTable * pMT, int32_t rank,...);
 extern "C" Object * __allocate_array(size_t elements, MethodTable * pMT);
 Object * __allocate_string(int32_t len);
 extern "C" __declspec(noreturn) void __throw_exception(void * pEx);
+extern "C" void __fail_fast();
 Object * __load_string_literal(const char * string);
 
 extern "C" Object * __castclass_class(void * p, MethodTable * pMT);
@@ -49,6 +54,116 @@ void __range_check(void * a, size_t elem);
 
 Object * __get_commandline_args(int argc, char * argv[]);
 
+// States of the flag generated for each type with a class constructor that runs on first access
+#define CCTOR_STATE_NOT_RUN     0
+#define CCTOR_STATE_RUNNING     1
+#define CCTOR_STATE_DONE        2
+#define CCTOR_STATE_FAILED      3
+
+// Loads and stores that order the accesses around them, for flags that publish data to other threads.
+// __acquire_fence follows the loads and __release_fence precedes the stores that have the volatile. prefix in IL.
+#ifdef _MSC_VER
+inline int32_t __load_acquire(volatile int32_t * pSrc)
+{
+    int32_t value = *pSrc;
+    _ReadWriteBarrier();
+    return value;
+}
+
+inline void __store_release(volatile int32_t * pDst, int32_t value)
+{
+    _ReadWriteBarrier();
+    *pDst = value;
+}
+
+inline void __acquire_fence()
+{
+    _ReadWriteBarrier();
+}
+
+inline void __release_fence()
+{
+    _ReadWriteBarrier();
+}
+#else
+inline int32_t __load_acquire(volatile int32_t * pSrc)
+{
+    return __atomic_load_n(pSrc, __ATOMIC_ACQUIRE);
+}
+
+inline void __store_release(volatile int32_t * pDst, int32_t value)
+{
+    __atomic_store_n(pDst, value, __ATOMIC_RELEASE);
+}
+
+inline void __acquire_fence()
+{
+    __atomic_thread_fence(__ATOMIC_ACQUIRE);
+}
+
+inline void __release_fence()
+{
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+}
+#endif
+
+// Runs the class constructor once, waits for another thread that runs it, or rethrows what it threw.
+void __run_cctor(volatile int32_t * pState, void (*pfnCctor)());
+
+// Fast path of a class constructor trigger: a single acquire load once the class constructor has run, which
+// makes the statics it wrote visible to this thread.
+inline void __ensure_cctor(volatile int32_t * pState, void (*pfnCctor)())
+{
+    if (__load_acquire(pState) != CCTOR_STATE_DONE)
+        __run_cctor(pState, pfnCctor);
+}
+
+// Interlocked.CompareExchange on primitive types, expanded inline by the code generator
+#ifdef _MSC_VER
+inline int32_t __interlocked_compare_exchange(volatile int32_t * pDst, int32_t value, int32_t comparand)
+{
+    return _InterlockedCompareExchange((volatile long *)pDst, value, comparand);
+}
+
+inline int64_t __interlocked_compare_exchange(volatile int64_t * pDst, int64_t value, int64_t comparand)
+{
+    return _InterlockedCompareExchange64(pDst, value, comparand);
+}
+#else
+template <typename T>
+inline T __interlocked_compare_exchange(volatile T * pDst, T value, T comparand)
+{
+    return __sync_val_compare_and_swap(pDst, comparand, value);
+}
+#endif
+
+// Interface calls go through a cell per call site that caches the target for the type of the object the call was
+// last made on. Entries are never freed or changed once the resolver created them, so storing the pointer to one
+// publishes the type and the target together.
+struct __InterfaceDispatchEntry
+{
+    MethodTable * m_pMT;
+    void * m_pTarget;
+};
+
+struct __InterfaceDispatchCell
+{
+    const __InterfaceDispatchEntry * volatile m_pEntry;
+};
+
+inline void * __interface_dispatch(__InterfaceDispatchCell * pCell, void * pThis, const __InterfaceDispatchEntry * (*pfnResolve)(void *))
+{
+    const __InterfaceDispatchEntry * pEntry = pCell->m_pEntry;
+    __acquire_fence();
+    if (pEntry == NULL || pEntry->m_pMT != *(MethodTable **)pThis)
+    {
+        pEntry = pfnResolve(pThis);
+        __release_fence();
+        pCell->m_pEntry = pEntry;
+    }
+    return pEntry->m_pTarget;
+}
+
 // POD version of EEType to use for static initialization
 struct RawEEType
 {
@@ -91,6 +206,40 @@ struct SimpleModuleHeader
 
 void __register_module(SimpleModuleHeader* pModule);
 
+#ifdef _MSC_VER
+#define __THREAD __declspec(thread)
+#else
+#define __THREAD __thread
+#endif
+
+// Mirrors ShadowStackFrame in the runtime. Generated methods that hold GC references keep them in a struct that is
+// reported to the GC through a __ShadowFrame, which the runtime finds through tls_pShadowStackTop.
+#define SHADOW_ROOT_INTERIOR 0x1
+#define SHADOW_ROOT_PINNED   0x2
+
+typedef void __ReportRoot(void ** ppRoot, uint32_t flags, void * pContext);
+
+extern "C" __THREAD void * tls_pShadowStackTop;
+extern "C" __THREAD void * tls_pSimpleModuleThreadStatics;
+
+struct __ShadowFrame
+{
+    __ShadowFrame * m_pPrev;
+    void * m_pRoots;
+    void (*m_pfnEnumRoots)(void * pRoots, __ReportRoot * pfnReport, void * pContext);
+
+    __ShadowFrame(void * pRoots, void (*pfnEnumRoots)(void *, __ReportRoot *, void *))
+        : m_pPrev((__ShadowFrame *)tls_pShadowStackTop), m_pRoots(pRoots), m_pfnEnumRoots(pfnEnumRoots)
+    {
+        tls_pShadowStackTop = this;
+    }
+
+    ~__ShadowFrame()
+    {
+        tls_pShadowStackTop = m_pPrev;
+    }
+};
+
 // TODO: this might be wrong...
 typedef size_t UIntNative;
 
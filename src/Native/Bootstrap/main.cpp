@@ -8,6 +8,11 @@
 #include "gcenv.base.h"
 
 #include <stdlib.h> 
+#include <mutex>
+#include <condition_variable>
+#include <exception>
+#include <thread>
+#include <unordered_map>
 
 #pragma warning(disable:4297)
 
@@ -16,6 +21,8 @@ extern "C" Object * RhNewArray(MethodTable * pMT, int32_t elements);
 extern "C" void RhpReversePInvoke2(ReversePInvokeFrame* pRevFrame);
 extern "C" void RhpReversePInvokeReturn(ReversePInvokeFrame* pRevFrame);
 extern "C" int32_t RhpEnableConservativeStackReporting();
+extern "C" int32_t RhpEnableShadowStackReporting();
+extern "C" void RhpCallPreemptive(void (*pfnCallback)(void *), void * pContext);
 extern "C" void RhpRegisterSimpleModule(SimpleModuleHeader* pModule);
 extern "C" void * RhHandleAlloc(void * pObject, int handleType);
 extern "C" void * RhTypeCast_IsInstanceOfClass(void * pObject, MethodTable * pMT);
@@ -30,7 +37,12 @@ int __initialize_runtime()
 {
     RtuDllMain(NULL, DLL_PROCESS_ATTACH, NULL);
 
+#ifdef CPPCODEGEN
+    // The generated code reports its GC references precisely through the shadow stack
+    RhpEnableShadowStackReporting();
+#else
     RhpEnableConservativeStackReporting();
+#endif
 
     return 0;
 }
@@ -54,6 +66,150 @@ void __register_module(SimpleModuleHeader* pModule)
     RhpRegisterSimpleModule(pModule);
 }
 
+// Bookkeeping for the class constructors that are running or have failed, keyed by the address of the flag
+// generated for the type. g_cctorLock is only held to update this table and the flags, never while a class
+// constructor runs, so a thread only ever waits for the type it needs. Waiting happens in preemptive mode
+// (RhpCallPreemptive) so that a thread blocked on another thread's class constructor can't hold up a GC.
+struct CctorRecord
+{
+    std::thread::id     m_owner;        // thread running the class constructor
+    std::exception_ptr  m_failure;      // what it threw, rethrown on every later access
+};
+
+static std::mutex g_cctorLock;
+static std::condition_variable g_cctorFinished;
+static std::unordered_map<volatile int32_t *, CctorRecord> g_cctorRecords;
+static std::unordered_map<std::thread::id, volatile int32_t *> g_cctorWaits;  // thread -> flag it waits on
+
+enum CctorAction
+{
+    CctorAction_Run,        // this thread owns the class constructor now
+    CctorAction_Return,     // done, or running on this thread or on a thread that waits for this one
+    CctorAction_Rethrow,    // failed earlier
+};
+
+struct CctorStartArgs
+{
+    volatile int32_t *  m_pState;
+    CctorAction         m_action;
+    std::exception_ptr  m_failure;
+};
+
+// Whether the thread that owns pState waits, directly or through other threads, for the current thread
+static bool __cctor_wait_is_cycle(volatile int32_t * pState, std::thread::id self)
+{
+    for (;;)
+    {
+        auto record = g_cctorRecords.find(pState);
+        if (record == g_cctorRecords.end())
+            return false;
+
+        std::thread::id owner = record->second.m_owner;
+        if (owner == self)
+            return true;
+
+        auto wait = g_cctorWaits.find(owner);
+        if (wait == g_cctorWaits.end())
+            return false;
+
+        pState = wait->second;
+    }
+}
+
+static void __cctor_start(void * pContext)
+{
+    CctorStartArgs * pArgs = (CctorStartArgs *)pContext;
+    volatile int32_t * pState = pArgs->m_pState;
+    std::thread::id self = std::this_thread::get_id();
+
+    std::unique_lock<std::mutex> lock(g_cctorLock);
+    for (;;)
+    {
+        switch (*pState)
+        {
+        case CCTOR_STATE_DONE:
+            pArgs->m_action = CctorAction_Return;
+            return;
+
+        case CCTOR_STATE_FAILED:
+            pArgs->m_action = CctorAction_Rethrow;
+            pArgs->m_failure = g_cctorRecords[pState].m_failure;
+            return;
+
+        case CCTOR_STATE_NOT_RUN:
+            g_cctorRecords[pState].m_owner = self;
+            *pState = CCTOR_STATE_RUNNING;
+            pArgs->m_action = CctorAction_Run;
+            return;
+        }
+
+        // Running. Like the CLR, a thread that would deadlock sees the partially initialized type instead.
+        if (__cctor_wait_is_cycle(pState, self))
+        {
+            pArgs->m_action = CctorAction_Return;
+            return;
+        }
+
+        g_cctorWaits[self] = pState;
+        g_cctorFinished.wait(lock);
+        g_cctorWaits.erase(self);
+    }
+}
+
+struct CctorFinishArgs
+{
+    volatile int32_t *  m_pState;
+    std::exception_ptr  m_failure;
+};
+
+static void __cctor_finish(void * pContext)
+{
+    CctorFinishArgs * pArgs = (CctorFinishArgs *)pContext;
+
+    {
+        std::lock_guard<std::mutex> lock(g_cctorLock);
+        if (pArgs->m_failure)
+        {
+            CctorRecord & record = g_cctorRecords[pArgs->m_pState];
+            record.m_owner = std::thread::id();
+            record.m_failure = pArgs->m_failure;
+            __store_release(pArgs->m_pState, CCTOR_STATE_FAILED);
+        }
+        else
+        {
+            g_cctorRecords.erase(pArgs->m_pState);
+            __store_release(pArgs->m_pState, CCTOR_STATE_DONE);
+        }
+    }
+    g_cctorFinished.notify_all();
+}
+
+void __run_cctor(volatile int32_t * pState, void (*pfnCctor)())
+{
+    CctorStartArgs start = { pState, CctorAction_Return };
+    RhpCallPreemptive(&__cctor_start, &start);
+
+    if (start.m_action == CctorAction_Rethrow)
+        std::rethrow_exception(start.m_failure);
+
+    if (start.m_action != CctorAction_Run)
+        return;
+
+    CctorFinishArgs finish = { pState };
+    try
+    {
+        pfnCctor();
+    }
+    catch (...)
+    {
+        finish.m_failure = std::current_exception();
+    }
+    RhpCallPreemptive(&__cctor_finish, &finish);
+
+    if (finish.m_failure)
+        std::rethrow_exception(finish.m_failure);
+}
+
 namespace System_Private_CoreLib { namespace System { 
 
     class Object {
@@ -227,6 +383,31 @@ Object * __get_commandline_args(int argc, char * argv[])
 #else
 	 MethodTable * pStringArrayMT = (MethodTable*)__EEType_System_Private_CoreLib_System_String__Array;
 #endif
+#ifdef CPPCODEGEN
+	// args and each string have to stay reported while the next string is allocated
+	struct Roots
+	{
+		System::Array * args;
+		Object * arg;
+
+		static void EnumRoots(void * pRoots, __ReportRoot * pfnReport, void * pContext)
+		{
+			pfnReport((void **)&((Roots *)pRoots)->args, 0, pContext);
+			pfnReport((void **)&((Roots *)pRoots)->arg, 0, pContext);
+		}
+	} roots = { 0, 0 };
+	__ShadowFrame frame(&roots, &Roots::EnumRoots);
+
+	roots.args = (System::Array *)__allocate_array(argc, pStringArrayMT);
+
+	for (int i = 0; i < argc; i++)
+	{
+		roots.arg = __load_string_literal(argv[i]);
+		__stelem_ref(roots.args, i, roots.arg);
+	}
+
+	return (Object *)roots.args;
+#else
 	System::Array * args = (System::Array *)__allocate_array(argc, pStringArrayMT);
 
 	for (int i = 0; i < argc; i++)
@@ -235,6 +416,7 @@ Object * __get_commandline_args(int argc, char * argv[])
 	}
 	
 	return (Object *)args;
+#endif
 }
 
 extern "C" void RhGetCurrentThreadStackTrace()
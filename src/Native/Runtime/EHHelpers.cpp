@@ -112,26 +112,19 @@ COOP_PINVOKE_HELPER(void *, RhpGetClasslibFunction, (void * address, ClasslibFun
     ASSERT(pClasslibModule != NULL);
 
     // Lookup the method and return it. If we don't find it, we just return NULL.
-    void * pMethod = NULL;
-    
-    if (functionId == GetRuntimeException)
+    switch (functionId)
     {
-        pMethod = pClasslibModule->GetClasslibRuntimeExceptionHelper();
-    }
-    else if (functionId == AppendExceptionStackFrame)
-    {
-        pMethod = pClasslibModule->GetClasslibAppendExceptionStackFrameHelper();
-    }
-    else if (functionId == FailFast)
-    {
-        pMethod = pClasslibModule->GetClasslibFailFastHelper();
-    }
-    else if (functionId == UnhandledExceptionHandler)
-    {
-        pMethod = pClasslibModule->GetClasslibUnhandledExceptionHandlerHelper();
+    case GetRuntimeException:
+        return pClasslibModule->GetClasslibRuntimeExceptionHelper();
+    case AppendExceptionStackFrame:
+        return pClasslibModule->GetClasslibAppendExceptionStackFrameHelper();
+    case FailFast:
+        return pClasslibModule->GetClasslibFailFastHelper();
+    case UnhandledExceptionHandler:
+        return pClasslibModule->GetClasslibUnhandledExceptionHandlerHelper();
+    default:
+        return NULL;
     }
-
-    return pMethod;
 }
 
 COOP_PINVOKE_HELPER(void, RhpValidateExInfoStack, ())
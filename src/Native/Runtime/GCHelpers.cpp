@@ -109,6 +109,37 @@ COOP_PINVOKE_HELPER(Int64, RhGetCurrentObjSize, ())
     return GCHeap::GetGCHeap()->GetCurrentObjSize();
 }
 
+// Doesn't take the gc lock, so it's cheap enough to sample frequently, but it's only an estimate.
+COOP_PINVOKE_HELPER(Int64, RhGetApproxGcTotalMemory, ())
+{
+    return GCHeap::GetGCHeap()->GetApproxTotalBytesInUse();
+}
+
+// Gets the number of bytes the current thread has allocated over its lifetime. The allocation context counts
+// each chunk the GC hands out to it, so the part of the current chunk that is still unused is taken off.
+COOP_PINVOKE_HELPER(Int64, RhGetAllocatedBytesForCurrentThread, ())
+{
+    alloc_context * acontext = GetThread()->GetAllocContext();
+    return acontext->alloc_bytes + acontext->alloc_bytes_loh - (acontext->alloc_limit - acontext->alloc_ptr);
+}
+
+// Gets the number and total size of the duplicate strings of one length bucket found by the last background GC,
+// see GCStringDedupStatsMB. Bucket -1 gets the number and size of all the strings that were looked at. Returns
+// false if the statistics aren't being gathered.
+COOP_PINVOKE_HELPER(Boolean, RhGetStringDedupStats, (Int32 bucket, Int64 * pCount, Int64 * pBytes))
+{
+    if ((bucket < -1) || (bucket >= STRING_DEDUP_LENGTH_BUCKETS))
+        return Boolean_false;
+
+    string_dedup_stats stats;
+    if (!GCHeap::GetGCHeap()->GetStringDedupStats(&stats))
+        return Boolean_false;
+
+    *pCount = (bucket == -1) ? stats.sampled_count : stats.dup_count[bucket];
+    *pBytes = (bucket == -1) ? stats.sampled_bytes : stats.dup_bytes[bucket];
+    return Boolean_true;
+}
+
 COOP_PINVOKE_HELPER(Int64, RhGetGCNow, ())
 {
     return GCHeap::GetGCHeap()->GetNow();
@@ -123,3 +154,88 @@ COOP_PINVOKE_HELPER(Int64, RhGetLastGCDuration, (Int32 generation))
 {
     return GCHeap::GetGCHeap()->GetLastGCDuration(generation);
 }
+
+// Registers unmanaged memory kept alive by managed objects with the GC, which charges it against its generation
+// budgets. The accounting goes to a per-processor counter. Returns the generation that the caller should
+// collect, or -1 if the budgets still have room.
+COOP_PINVOKE_HELPER(Int32, RhAddMemoryPressure, (Int64 bytesAllocated))
+{
+    ASSERT(bytesAllocated > 0);
+
+    return GCHeap::GetGCHeap()->AddMemoryPressure((size_t)bytesAllocated);
+}
+
+COOP_PINVOKE_HELPER(void, RhRemoveMemoryPressure, (Int64 bytesAllocated))
+{
+    ASSERT(bytesAllocated > 0);
+
+    GCHeap::GetGCHeap()->RemoveMemoryPressure((size_t)bytesAllocated);
+}
+
+// Start a region in which no GC happens as long as the allocations made in it stay within totalSize bytes
+// (lohSize of which are for the large object heap when hasLohSize is set). The calling thread's allocation
+// context is handed the whole small object budget of the region on its next refill, so its allocations in the
+// region stay on the fast path. Returns one of the start_no_gc_region_status values.
+EXTERN_C REDHAWK_API Int32 __cdecl RhStartNoGCRegion(Int64 totalSize, BOOL hasLohSize, Int64 lohSize, BOOL disallowFullBlockingGC)
+{
+    // This must be called via p/invoke rather than RuntimeImport since it performs a GC to make room for the
+    // region.
+    ASSERT(!GetThread()->PreemptiveGCDisabled());
+
+    Int32 status = GCHeap::GetGCHeap()->StartNoGCRegion(totalSize, hasLohSize, lohSize, disallowFullBlockingGC);
+    if (status == start_no_gc_success)
+        GCHeap::GetGCHeap()->PresizeAllocContextForNoGCRegion(GetThread()->GetAllocContext());
+
+    return status;
+}
+
+// Returns one of the end_no_gc_region_status values.
+EXTERN_C REDHAWK_API Int32 __cdecl RhEndNoGCRegion()
+{
+    ASSERT(!GetThread()->PreemptiveGCDisabled());
+
+    return GCHeap::GetGCHeap()->EndNoGCRegion();
+}
+
+// Returns end_no_gc_success while a no GC region is in progress and its budget has not been exceeded,
+// otherwise the end_no_gc_region_status that ending the region would report.
+COOP_PINVOKE_HELPER(Int32, RhGetNoGCRegionStatus, ())
+{
+    return GCHeap::GetGCHeap()->GetNoGCRegionStatus();
+}
+
+// Arms the full blocking GC notifications. The thresholds are percentages (1-99) of the remaining gen2 and
+// LOH allocation budgets at which the approach event is signalled.
+COOP_PINVOKE_HELPER(Boolean, RhRegisterForFullGCNotification, (Int32 maxGenerationThreshold, Int32 largeObjectHeapThreshold))
+{
+    ASSERT(maxGenerationThreshold >= 1 && maxGenerationThreshold <= 99);
+    ASSERT(largeObjectHeapThreshold >= 1 && largeObjectHeapThreshold <= 99);
+
+    return GCHeap::GetGCHeap()->RegisterForFullGCNotification(maxGenerationThreshold, largeObjectHeapThreshold) ? Boolean_true : Boolean_false;
+}
+
+// Disarms the full blocking GC notifications and releases any threads currently waiting on them.
+COOP_PINVOKE_HELPER(Boolean, RhCancelFullGCNotification, ())
+{
+    return GCHeap::GetGCHeap()->CancelFullGCNotification() ? Boolean_true : Boolean_false;
+}
+
+// Blocks until a full blocking GC is approaching, the notification is cancelled or the timeout expires.
+// Returns one of the wait_full_gc_status values. This must be called via p/invoke since it waits.
+EXTERN_C REDHAWK_API Int32 __cdecl RhWaitForFullGCApproach(Int32 millisecondsTimeout)
+{
+    ASSERT(millisecondsTimeout >= -1);
+    ASSERT(!GetThread()->PreemptiveGCDisabled());
+
+    return GCHeap::GetGCHeap()->WaitForFullGCApproach(millisecondsTimeout);
+}
+
+// Blocks until the full blocking GC announced by RhWaitForFullGCApproach has completed, the notification is
+// cancelled or the timeout expires. Returns one of the wait_full_gc_status values.
+EXTERN_C REDHAWK_API Int32 __cdecl RhWaitForFullGCComplete(Int32 millisecondsTimeout)
+{
+    ASSERT(millisecondsTimeout >= -1);
+    ASSERT(!GetThread()->PreemptiveGCDisabled());
+
+    return GCHeap::GetGCHeap()->WaitForFullGCComplete(millisecondsTimeout);
+}
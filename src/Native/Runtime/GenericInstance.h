@@ -32,6 +32,7 @@ struct UnifiedGenericInstance
 {
     UnifiedGenericInstance *    m_pNext;            // Next entry in the hash table chain
     UInt32                      m_cRefs;            // Number of modules which have published this type
+    UInt32                      m_cbMemory;         // Size of the block this heads, to free it with
 
     bool Equals(GenericInstanceDesc * pInst);
     GenericInstanceDesc * GetGid() { return (GenericInstanceDesc*)(this + 1); }
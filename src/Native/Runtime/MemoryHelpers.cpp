@@ -0,0 +1,309 @@
+//
+// Copyright (c) Microsoft Corporation.  All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+//
+#include "common.h"
+#include "CommonTypes.h"
+#include "CommonMacros.h"
+#include "daccess.h"
+#include "PalRedhawkCommon.h"
+#include "PalRedhawk.h"
+#include "assert.h"
+
+//
+// Memory copy and fill helpers for Buffer.Memmove and Buffer.ZeroMemory. The implementation used for a given
+// size is picked once at startup based on what the processor supports: rep movsb/stosb on processors with
+// enhanced rep string operations (ERMS), 32-byte AVX2 moves, and non-temporal stores for buffers too large to
+// be worth keeping in the cache. Overlapping copies and other architectures use the C runtime.
+//
+
+#if defined(_TARGET_AMD64_) && !defined(USE_PORTABLE_HELPERS)
+#define FEATURE_DISPATCHED_MEMORY_HELPERS
+#endif
+
+#ifdef FEATURE_DISPATCHED_MEMORY_HELPERS
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#define AVX2_FUNCTION
+#else
+#include <cpuid.h>
+#include <immintrin.h>
+#define AVX2_FUNCTION __attribute__((target("avx2")))
+#endif
+
+// Below this size the startup cost of rep movsb/stosb outweighs its throughput, even with ERMS.
+#define REP_STRING_THRESHOLD    2048
+
+typedef void (*PFN_COPY)(UInt8 * dest, const UInt8 * src, size_t len);
+typedef void (*PFN_FILL)(UInt8 * dest, UInt8 value, size_t len);
+
+static void CopyWithCrt(UInt8 * dest, const UInt8 * src, size_t len)
+{
+    memcpy(dest, src, len);
+}
+
+static void FillWithCrt(UInt8 * dest, UInt8 value, size_t len)
+{
+    memset(dest, value, len);
+}
+
+static void CopyWithRepMovsb(UInt8 * dest, const UInt8 * src, size_t len)
+{
+#ifdef _MSC_VER
+    __movsb(dest, src, len);
+#else
+    __asm__ __volatile__("rep movsb" : "+D"(dest), "+S"(src), "+c"(len) : : "memory");
+#endif
+}
+
+static void FillWithRepStosb(UInt8 * dest, UInt8 value, size_t len)
+{
+#ifdef _MSC_VER
+    __stosb(dest, value, len);
+#else
+    __asm__ __volatile__("rep stosb" : "+D"(dest), "+c"(len) : "a"(value) : "memory");
+#endif
+}
+
+// Aligns the destination to 32 bytes and covers the unaligned head and tail with overlapping unaligned moves.
+AVX2_FUNCTION static void CopyWithAvx2(UInt8 * dest, const UInt8 * src, size_t len)
+{
+    if (len < 32)
+    {
+        memcpy(dest, src, len);
+        return;
+    }
+
+    __m256i head = _mm256_loadu_si256((const __m256i *)src);
+    __m256i tail = _mm256_loadu_si256((const __m256i *)(src + len - 32));
+
+    for (size_t offset = 32 - ((size_t)dest & 31); offset + 32 <= len; offset += 32)
+        _mm256_store_si256((__m256i *)(dest + offset), _mm256_loadu_si256((const __m256i *)(src + offset)));
+
+    _mm256_storeu_si256((__m256i *)dest, head);
+    _mm256_storeu_si256((__m256i *)(dest + len - 32), tail);
+    _mm256_zeroupper();
+}
+
+AVX2_FUNCTION static void FillWithAvx2(UInt8 * dest, UInt8 value, size_t len)
+{
+    if (len < 32)
+    {
+        memset(dest, value, len);
+        return;
+    }
+
+    __m256i v = _mm256_set1_epi8((char)value);
+
+    for (size_t offset = 32 - ((size_t)dest & 31); offset + 32 <= len; offset += 32)
+        _mm256_store_si256((__m256i *)(dest + offset), v);
+
+    _mm256_storeu_si256((__m256i *)dest, v);
+    _mm256_storeu_si256((__m256i *)(dest + len - 32), v);
+    _mm256_zeroupper();
+}
+
+// Only used for sizes well above the cache size, so the head and tail don't need to be fast.
+static void CopyWithNonTemporalStores(UInt8 * dest, const UInt8 * src, size_t len)
+{
+    size_t head = (16 - ((size_t)dest & 15)) & 15;
+    memcpy(dest, src, head);
+    dest += head;
+    src += head;
+    len -= head;
+
+    for (; len >= 64; len -= 64, dest += 64, src += 64)
+    {
+        __m128i v0 = _mm_loadu_si128((const __m128i *)src);
+        __m128i v1 = _mm_loadu_si128((const __m128i *)(src + 16));
+        __m128i v2 = _mm_loadu_si128((const __m128i *)(src + 32));
+        __m128i v3 = _mm_loadu_si128((const __m128i *)(src + 48));
+        _mm_stream_si128((__m128i *)dest, v0);
+        _mm_stream_si128((__m128i *)(dest + 16), v1);
+        _mm_stream_si128((__m128i *)(dest + 32), v2);
+        _mm_stream_si128((__m128i *)(dest + 48), v3);
+    }
+
+    // Non-temporal stores are weakly ordered
+    _mm_sfence();
+
+    memcpy(dest, src, len);
+}
+
+static void FillWithNonTemporalStores(UInt8 * dest, UInt8 value, size_t len)
+{
+    size_t head = (16 - ((size_t)dest & 15)) & 15;
+    memset(dest, value, head);
+    dest += head;
+    len -= head;
+
+    __m128i v = _mm_set1_epi8((char)value);
+
+    for (; len >= 64; len -= 64, dest += 64)
+    {
+        _mm_stream_si128((__m128i *)dest, v);
+        _mm_stream_si128((__m128i *)(dest + 16), v);
+        _mm_stream_si128((__m128i *)(dest + 32), v);
+        _mm_stream_si128((__m128i *)(dest + 48), v);
+    }
+
+    _mm_sfence();
+
+    memset(dest, value, len);
+}
+
+static PFN_COPY g_pfnCopy = CopyWithCrt;
+static PFN_FILL g_pfnFill = FillWithCrt;
+static PFN_COPY g_pfnCopyLarge = CopyWithCrt;
+static PFN_FILL g_pfnFillLarge = FillWithCrt;
+static size_t g_cbLargeThreshold = SIZE_MAX;
+static size_t g_cbNonTemporalThreshold = SIZE_MAX;
+
+static void GetCpuid(UInt32 leaf, UInt32 subleaf, UInt32 regs[4])
+{
+#ifdef _MSC_VER
+    __cpuidex((int *)regs, (int)leaf, (int)subleaf);
+#else
+    __cpuid_count(leaf, subleaf, regs[0], regs[1], regs[2], regs[3]);
+#endif
+}
+
+static bool IsAvx2Supported()
+{
+    UInt32 regs[4];
+
+    GetCpuid(0, 0, regs);
+    if (regs[0] < 7)
+        return false;
+
+    // The OS has to save the YMM registers (OSXSAVE and AVX, then XCR0 bits 1 and 2)
+    GetCpuid(1, 0, regs);
+    if ((regs[2] & ((1 << 27) | (1 << 28))) != ((1 << 27) | (1 << 28)))
+        return false;
+
+#ifdef _MSC_VER
+    UInt64 xcr0 = _xgetbv(0);
+#else
+    UInt32 xcr0Low, xcr0High;
+    __asm__ __volatile__("xgetbv" : "=a"(xcr0Low), "=d"(xcr0High) : "c"(0));
+    UInt64 xcr0 = ((UInt64)xcr0High << 32) | xcr0Low;
+#endif
+    if ((xcr0 & 6) != 6)
+        return false;
+
+    GetCpuid(7, 0, regs);
+    return (regs[1] & (1 << 5)) != 0;
+}
+
+static bool IsErmsSupported()
+{
+    UInt32 regs[4];
+
+    GetCpuid(0, 0, regs);
+    if (regs[0] < 7)
+        return false;
+
+    GetCpuid(7, 0, regs);
+    return (regs[1] & (1 << 9)) != 0;
+}
+
+void InitializeMemoryHelpers()
+{
+    if (IsAvx2Supported())
+    {
+        g_pfnCopy = CopyWithAvx2;
+        g_pfnFill = FillWithAvx2;
+        g_pfnCopyLarge = CopyWithAvx2;
+        g_pfnFillLarge = FillWithAvx2;
+    }
+
+    if (IsErmsSupported())
+    {
+        g_pfnCopyLarge = CopyWithRepMovsb;
+        g_pfnFillLarge = FillWithRepStosb;
+    }
+
+    g_cbLargeThreshold = REP_STRING_THRESHOLD;
+
+    // Buffers bigger than the cache would only evict everything else from it on their way through.
+    size_t cbCache = PalGetLargestOnDieCacheSize(TRUE);
+    if (cbCache != 0)
+        g_cbNonTemporalThreshold = cbCache;
+}
+
+static void * MemoryMove(void * dest, const void * src, size_t len)
+{
+    UInt8 * pDest = (UInt8 *)dest;
+    const UInt8 * pSrc = (const UInt8 *)src;
+
+    if ((size_t)(pDest - pSrc) < len || (size_t)(pSrc - pDest) < len)
+        return memmove(dest, src, len);
+
+    if (len >= g_cbNonTemporalThreshold)
+        CopyWithNonTemporalStores(pDest, pSrc, len);
+    else if (len >= g_cbLargeThreshold)
+        g_pfnCopyLarge(pDest, pSrc, len);
+    else
+        g_pfnCopy(pDest, pSrc, len);
+
+    return dest;
+}
+
+static void * MemoryFill(void * dest, int c, size_t len)
+{
+    UInt8 * pDest = (UInt8 *)dest;
+
+    if (len >= g_cbNonTemporalThreshold)
+        FillWithNonTemporalStores(pDest, (UInt8)c, len);
+    else if (len >= g_cbLargeThreshold)
+        g_pfnFillLarge(pDest, (UInt8)c, len);
+    else
+        g_pfnFill(pDest, (UInt8)c, len);
+
+    return dest;
+}
+
+#else // FEATURE_DISPATCHED_MEMORY_HELPERS
+
+void InitializeMemoryHelpers()
+{
+}
+
+static void * MemoryMove(void * dest, const void * src, size_t len)
+{
+    return memmove(dest, src, len);
+}
+
+static void * MemoryFill(void * dest, int c, size_t len)
+{
+    return memset(dest, c, len);
+}
+
+#endif // FEATURE_DISPATCHED_MEMORY_HELPERS
+
+// These are called without a transition frame, so the thread can't be suspended for a GC until they return.
+// Managed code only uses them for sizes that don't hold up a suspension noticeably.
+//
+// USAGE:  The caller is responsible for hoisting any null reference exceptions to a place where the hardware exception
+//         can be properly translated to a managed exception.
+COOP_PINVOKE_CDECL_HELPER(void *, RhpMemoryMove, (void * dest, const void * src, size_t len))
+{
+    return MemoryMove(dest, src, len);
+}
+
+COOP_PINVOKE_CDECL_HELPER(void *, RhpMemoryFill, (void * dest, int c, size_t len))
+{
+    return MemoryFill(dest, c, len);
+}
+
+// P/invoke versions for large sizes.
+EXTERN_C REDHAWK_API void * __cdecl RhMemoryMove(void * dest, const void * src, size_t len)
+{
+    return MemoryMove(dest, src, len);
+}
+
+EXTERN_C REDHAWK_API void * __cdecl RhMemoryFill(void * dest, int c, size_t len)
+{
+    return MemoryFill(dest, c, len);
+}
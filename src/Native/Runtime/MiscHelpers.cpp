@@ -123,6 +123,17 @@ COOP_PINVOKE_HELPER(UInt32, RhGetLoadedModules, (Array * pResultArray))
     return cModules;
 }
 
+// Returns the bytes in use by the runtime's own heaps of type data (dynamically created types and unified
+// generic instantiations), and the bytes of address space reserved for them.
+COOP_PINVOKE_HELPER(void, RhGetRuntimeHeapBytes, (UInt64 * pcbLive, UInt64 * pcbReserved))
+{
+    UIntNative cbLive, cbReserved;
+    GetRuntimeInstance()->GetRuntimeHeapBytes(&cbLive, &cbReserved);
+
+    *pcbLive = cbLive;
+    *pcbReserved = cbReserved;
+}
+
 COOP_PINVOKE_HELPER(HANDLE, RhGetModuleFromPointer, (PTR_VOID pPointerVal))
 {
     Module * pModule = GetRuntimeInstance()->FindModuleByAddress(pPointerVal);
@@ -13,8 +13,17 @@
 #define BIT_SBLK_GC_RESERVE                 0x20000000
 #define BIT_SBLK_FINALIZER_RUN              0x40000000
 
-// The sync block index header (small structure that immediately precedes every object in the GC heap). Only
-// the GC uses this so far, and only to store a couple of bits of information.
+// The low bits belong to the classlib (see ObjectHeader.cs in System.Private.CoreLib), which stores either a
+// hash code, a thin lock (owning managed thread ID and recursion count) or the index of the object's entry in
+// its table of inflated locks there. The classlib updates them with compare-exchange of the whole word, so the
+// runtime must only change the bits above with interlocked operations (SetBit/ClrBit) unless managed code is
+// suspended, and the GC must keep the header with the object when it relocates it. The runtime never decodes
+// the classlib's bits; the two tag bits are listed here only so they aren't taken for anything else.
+#define BIT_SBLK_IS_HASH_OR_SYNCBLKINDEX    0x08000000
+#define BIT_SBLK_IS_HASHCODE                0x04000000
+
+// The sync block index header (small structure that immediately precedes every object in the GC heap). The GC
+// and runtime use the bits above, the rest is the classlib's.
 class ObjHeader
 {
 private:
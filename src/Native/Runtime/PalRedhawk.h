@@ -811,6 +811,11 @@ REDHAWK_PALIMPORT UInt32_BOOL REDHAWK_PALAPI PalAllocateThunksFromTemplate(_In_
 
 REDHAWK_PALIMPORT UInt32 REDHAWK_PALAPI PalCompatibleWaitAny(UInt32_BOOL alertable, UInt32 timeout, UInt32 count, HANDLE* pHandles, UInt32_BOOL allowReentrantWait);
 
+// Blocks while *pAddress is equal to comparand, until PalWakeByAddress is called for the address or the
+// timeout expires. Returns FALSE on timeout. Can return early, so callers have to check the value again.
+REDHAWK_PALIMPORT UInt32_BOOL REDHAWK_PALAPI PalWaitOnAddress(volatile Int32 * pAddress, Int32 comparand, UInt32 milliseconds);
+REDHAWK_PALIMPORT void REDHAWK_PALAPI PalWakeByAddress(volatile Int32 * pAddress, UInt32_BOOL wakeAll);
+
 #ifndef _MSC_VER
 REDHAWK_PALIMPORT Int32 __cdecl _wcsicmp(const wchar_t *string1, const wchar_t *string2);
 #endif // _MSC_VER
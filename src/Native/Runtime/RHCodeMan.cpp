@@ -417,7 +417,9 @@ void EECodeManager::EnumGcRefs(EEMethodInfo *   pMethodInfo,
     // This loop scans through the 'method info' to find a callsite offset which matches the incoming code 
     // offset.  Once it's found, we break out and have a pointer into the 'callsite info blob' which will
     // point at a string describing the roots that must be reported at this particular callsite.  This loop 
-    // needs to be fast because it's linear with respect to the number of callsites in a method.
+    // needs to be fast because it's linear with respect to the number of callsites in a method.  Methods with
+    // many callsites carry a seekable index in front of the table (see GCInfoCallsiteIndex), which we use to
+    // start the loop at the block that contains the callsite instead of at the beginning of the table.
     //
     // -------------------------------------------------------------------------------------------------------
     //
@@ -438,11 +440,15 @@ void EECodeManager::EnumGcRefs(EEMethodInfo *   pMethodInfo,
     //
     // 11111111 -- STRING TERMINATOR
     //
+    // 10000000 00000000 { index } -- SEEKABLE INDEX (only as the first entry, see GCInfoCallsiteIndex)
+    //
 
     UInt32 callCodeOffset = codeOffset;
     UInt32 curCodeOffset = 0;
     IntNative infoOffset = 0;
 
+    GCInfoCallsiteIndex::Seek(callCodeOffset, &pCursor, &curCodeOffset);
+
     while (curCodeOffset < callCodeOffset)
     {
 ContinueUnconditionally:
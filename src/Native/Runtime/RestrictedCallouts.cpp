@@ -39,8 +39,17 @@ RestrictedCallouts::GcRestrictedCallout * RestrictedCallouts::s_rgGcRestrictedCa
 // The head of the chain of HandleTable callouts.
 RestrictedCallouts::HandleTableRestrictedCallout * RestrictedCallouts::s_pHandleTableRestrictedCallouts = NULL;
 
-// Lock protecting access to s_rgGcRestrictedCallouts and s_pHandleTableRestrictedCallouts during registration
-// and unregistration (not used during actual callbacks since everything is single threaded then).
+// The HandleTable callouts keyed by type, NULL if there are none.
+RestrictedCallouts::HandleTableCalloutMap * volatile RestrictedCallouts::s_pHandleTableCalloutMap = NULL;
+
+// Replaced maps waiting for the scans that might be reading them to finish.
+RestrictedCallouts::HandleTableCalloutMap * RestrictedCallouts::s_pRetiredHandleTableCalloutMaps = NULL;
+
+// The number of ref counted handle scans in progress.
+volatile Int32 RestrictedCallouts::s_cHandleTableScans = 0;
+
+// Lock protecting access to s_rgGcRestrictedCallouts, s_pHandleTableRestrictedCallouts and the HandleTable
+// callout maps during registration and unregistration (not used during actual callbacks).
 CrstStatic RestrictedCallouts::s_sLock;
 
 // One time startup initialization.
@@ -136,6 +145,13 @@ bool RestrictedCallouts::RegisterRefCountedHandleCallback(void * pCalloutMethod,
     pCallout->m_pNext = s_pHandleTableRestrictedCallouts;
     s_pHandleTableRestrictedCallouts = pCallout;
 
+    if (!RebuildHandleTableCalloutMap())
+    {
+        s_pHandleTableRestrictedCallouts = pCallout->m_pNext;
+        delete pCallout;
+        return false;
+    }
+
     return true;
 }
 
@@ -161,6 +177,14 @@ void RestrictedCallouts::UnregisterRefCountedHandleCallback(void * pCalloutMetho
 
             delete pCurrCallout;
 
+            // The GC may be scanning with the current map, so it can't be changed in place. And it can't be
+            // kept either, since it still has the callout that was just unregistered.
+            if (!RebuildHandleTableCalloutMap())
+            {
+                ASSERT_UNCONDITIONALLY("Out of memory unregistering a ref counted handle callout.");
+                RhFailFast();
+            }
+
             return;
         }
 
@@ -173,6 +197,133 @@ void RestrictedCallouts::UnregisterRefCountedHandleCallback(void * pCalloutMetho
     RhFailFast();
 }
 
+// Find the bucket for the given type in the map, or the empty bucket where it would go.
+RestrictedCallouts::HandleTableCalloutBucket *
+RestrictedCallouts::FindHandleTableCalloutBucket(HandleTableCalloutMap * pMap, EEType * pType)
+{
+    // EETypes are pointer aligned, so the low bits carry no information.
+    UInt32 uBucket = (UInt32)((UIntNative)pType >> 3) & pMap->m_uBucketMask;
+    while (true)
+    {
+        HandleTableCalloutBucket * pBucket = &pMap->m_rgBuckets[uBucket];
+        if ((pBucket->m_pTypeFilter == pType) || (pBucket->m_pTypeFilter == NULL))
+            return pBucket;
+
+        uBucket = (uBucket + 1) & pMap->m_uBucketMask;
+    }
+}
+
+// Fill in a new map from s_pHandleTableRestrictedCallouts. The map must have at least twice as many buckets
+// and at least as many method slots as are needed for callouts and terminators. It must not have been
+// published yet.
+void RestrictedCallouts::FillHandleTableCalloutMap(HandleTableCalloutMap * pMap)
+{
+    UInt32 cBuckets = pMap->m_uBucketMask + 1;
+    memset(pMap->m_rgBuckets, 0, cBuckets * sizeof(HandleTableCalloutBucket));
+
+    // Count the callouts for each type.
+    for (HandleTableRestrictedCallout * pCallout = s_pHandleTableRestrictedCallouts; pCallout; pCallout = pCallout->m_pNext)
+    {
+        HandleTableCalloutBucket * pBucket = FindHandleTableCalloutBucket(pMap, pCallout->m_pTypeFilter);
+        pBucket->m_pTypeFilter = pCallout->m_pTypeFilter;
+        pBucket->m_cCallouts++;
+    }
+
+    // Give each type its slice of the method array.
+    void ** pNextMethodSlot = (void **)(pMap->m_rgBuckets + cBuckets);
+    for (UInt32 i = 0; i < cBuckets; i++)
+    {
+        HandleTableCalloutBucket * pBucket = &pMap->m_rgBuckets[i];
+        if (pBucket->m_pTypeFilter == NULL)
+            continue;
+
+        pBucket->m_rgCalloutMethods = pNextMethodSlot;
+        pNextMethodSlot += pBucket->m_cCallouts;
+        *pNextMethodSlot++ = NULL;
+        pBucket->m_cCallouts = 0;
+    }
+    ASSERT(pNextMethodSlot <= (void **)(pMap->m_rgBuckets + cBuckets) + pMap->m_cMethodSlots);
+
+    // Fill them in, keeping the order of the chain so the most recently registered callouts come first.
+    for (HandleTableRestrictedCallout * pCallout = s_pHandleTableRestrictedCallouts; pCallout; pCallout = pCallout->m_pNext)
+    {
+        HandleTableCalloutBucket * pBucket = FindHandleTableCalloutBucket(pMap, pCallout->m_pTypeFilter);
+        pBucket->m_rgCalloutMethods[pBucket->m_cCallouts++] = pCallout->m_pCalloutMethod;
+    }
+}
+
+// Replace s_pHandleTableCalloutMap with a new one built from the current s_pHandleTableRestrictedCallouts
+// (or NULL if there are none). Returns false, leaving the current map alone, if insufficient memory was
+// available.
+bool RestrictedCallouts::RebuildHandleTableCalloutMap()
+{
+    UInt32 cCallouts = 0;
+    for (HandleTableRestrictedCallout * pCallout = s_pHandleTableRestrictedCallouts; pCallout; pCallout = pCallout->m_pNext)
+        cCallouts++;
+
+    if (cCallouts == 0)
+    {
+        PublishHandleTableCalloutMap(NULL);
+        return true;
+    }
+
+    UInt32 cBuckets = 4;
+    while (cBuckets < (cCallouts * 2))
+        cBuckets *= 2;
+
+    // Every type needs a terminator and there can't be more types than callouts.
+    UInt32 cMethodSlots = cCallouts * 2;
+
+    size_t cbMap = sizeof(HandleTableCalloutMap) +
+                   (cBuckets * sizeof(HandleTableCalloutBucket)) +
+                   (cMethodSlots * sizeof(void *));
+    UInt8 * pbMap = new (nothrow) UInt8[cbMap];
+    if (pbMap == NULL)
+        return false;
+
+    HandleTableCalloutMap * pMap = (HandleTableCalloutMap *)pbMap;
+    pMap->m_uBucketMask = cBuckets - 1;
+    pMap->m_cMethodSlots = cMethodSlots;
+    pMap->m_rgBuckets = (HandleTableCalloutBucket *)(pMap + 1);
+    pMap->m_pNextRetired = NULL;
+
+    FillHandleTableCalloutMap(pMap);
+
+    PublishHandleTableCalloutMap(pMap);
+
+    return true;
+}
+
+// Make the given map (fully filled in) the one the callbacks use and retire the previous one. Retired maps are
+// freed once no scan is in progress, which may be on a later call.
+void RestrictedCallouts::PublishHandleTableCalloutMap(HandleTableCalloutMap * pMap)
+{
+    // The exchange is a full barrier: the contents of the new map are visible before the pointer to it, and
+    // the store is ordered before the read of the scan count below. A scan increments the count (also with
+    // a full barrier) before it reads the pointer, so either we see its count, or it sees the new map and
+    // can't be using any of the retired ones.
+    HandleTableCalloutMap * pOldMap =
+        (HandleTableCalloutMap *)PalInterlockedExchangePointer((void * volatile *)&s_pHandleTableCalloutMap, pMap);
+
+    if (pOldMap != NULL)
+    {
+        pOldMap->m_pNextRetired = s_pRetiredHandleTableCalloutMaps;
+        s_pRetiredHandleTableCalloutMaps = pOldMap;
+    }
+
+    if (s_cHandleTableScans != 0)
+        return;
+
+    HandleTableCalloutMap * pRetiredMap = s_pRetiredHandleTableCalloutMaps;
+    s_pRetiredHandleTableCalloutMaps = NULL;
+    while (pRetiredMap != NULL)
+    {
+        HandleTableCalloutMap * pNextRetiredMap = pRetiredMap->m_pNextRetired;
+        delete [] (UInt8*)pRetiredMap;
+        pRetiredMap = pNextRetiredMap;
+    }
+}
+
 // Invoke all the registered GC callouts of the given kind. The condemned generation of the current collection
 // is passed along to the callouts.
 void RestrictedCallouts::InvokeGcCallouts(GcRestrictedCalloutKind eKind, UInt32 uiCondemnedGeneration)
@@ -211,7 +362,45 @@ void RestrictedCallouts::InvokeGcCallouts(GcRestrictedCalloutKind eKind, UInt32
 // soon as a handler returns true.
 bool RestrictedCallouts::InvokeRefCountedHandleCallbacks(Object * pObject)
 {
+    // It is illegal for any of the callouts to trigger a GC, and the map mustn't be freed while we use it.
+    // Inside a BeginRefCountedHandleCallbacks / EndRefCountedHandleCallbacks pair both are already taken care
+    // of.
+    Thread * pThread = ThreadStore::GetCurrentThread();
+    bool fInBatch = pThread->IsDoNotTriggerGcSet();
+    bool fGcStressWasSuppressed = false;
+    if (!fInBatch)
+        fGcStressWasSuppressed = BeginRefCountedHandleCallbacks();
+
     bool fResult = false;
+    HandleTableCalloutMap * pMap = s_pHandleTableCalloutMap;
+    if (pMap != NULL)
+    {
+        HandleTableCalloutBucket * pBucket = FindHandleTableCalloutBucket(pMap, pObject->get_SafeEEType());
+        if (pBucket->m_pTypeFilter != NULL)
+        {
+            for (void ** ppCalloutMethod = pBucket->m_rgCalloutMethods; *ppCalloutMethod; ppCalloutMethod++)
+            {
+                // Make the callout. Return true to our caller as soon as we see a true result here.
+                if (((HandleTableRestrictedCallbackFunction)*ppCalloutMethod)(pObject))
+                {
+                    fResult = true;
+                    break;
+                }
+            }
+        }
+    }
+
+    if (!fInBatch)
+        EndRefCountedHandleCallbacks(fGcStressWasSuppressed);
+
+    return fResult;
+}
+
+bool RestrictedCallouts::BeginRefCountedHandleCallbacks()
+{
+    // Keep registration from freeing the map we're about to read. This has to come before the map is read;
+    // see PublishHandleTableCalloutMap.
+    PalInterlockedIncrement(&s_cHandleTableScans);
 
     // It is illegal for any of the callouts to trigger a GC.
     Thread * pThread = ThreadStore::GetCurrentThread();
@@ -222,28 +411,18 @@ bool RestrictedCallouts::InvokeRefCountedHandleCallbacks(Object * pObject)
     if (!fGcStressWasSuppressed)
         pThread->SetSuppressGcStress();
 
-    HandleTableRestrictedCallout * pCurrCallout = s_pHandleTableRestrictedCallouts;
-    while (pCurrCallout)
-    {
-        if (pObject->get_SafeEEType() == pCurrCallout->m_pTypeFilter)
-        {
-            // Make the callout. Return true to our caller as soon as we see a true result here.
-            if (((HandleTableRestrictedCallbackFunction)pCurrCallout->m_pCalloutMethod)(pObject))
-            {
-                fResult = true;
-                goto Done;
-            }
-        }
+    return fGcStressWasSuppressed;
+}
 
-        pCurrCallout = pCurrCallout->m_pNext;
-    }
+void RestrictedCallouts::EndRefCountedHandleCallbacks(bool fGcStressWasSuppressed)
+{
+    Thread * pThread = ThreadStore::GetCurrentThread();
 
-  Done:
     // Revert GC stress mode if we changed it.
     if (!fGcStressWasSuppressed)
         pThread->ClearSuppressGcStress();
 
     pThread->ClearDoNotTriggerGc();
 
-    return fResult;
+    PalInterlockedDecrement(&s_cHandleTableScans);
 }
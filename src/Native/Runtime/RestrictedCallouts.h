@@ -68,6 +68,12 @@ public:
     // invocations cease as soon as a handler returns true.
     static bool InvokeRefCountedHandleCallbacks(Object * pObject);
 
+    // Bracket a scan of many ref counted handles. The thread state that keeps the callouts from triggering a
+    // GC is set up once here instead of on every InvokeRefCountedHandleCallbacks call in between. The result
+    // of BeginRefCountedHandleCallbacks must be passed to the matching EndRefCountedHandleCallbacks.
+    static bool BeginRefCountedHandleCallbacks();
+    static void EndRefCountedHandleCallbacks(bool fGcStressWasSuppressed);
+
 private:
     // Context struct used to record which GC callbacks are registered to be made (we allow multiple
     // registrations).
@@ -93,9 +99,42 @@ private:
     // The head of the chain of HandleTable callouts.
     static HandleTableRestrictedCallout * s_pHandleTableRestrictedCallouts;
 
-    // Lock protecting access to s_rgGcRestrictedCallouts and s_pHandleTableRestrictedCallouts during
-    // registration and unregistration (not used during actual callbacks since everything is single threaded
-    // then).
+    // HandleTable callouts are made for every ref counted handle during a GC, so they're looked up by type
+    // in a table built from the chain above whenever it changes. It's open addressed on the EEType address
+    // and always has at least twice as many buckets as there are callouts. A map is never changed once it's
+    // published: registration builds a new one and swaps it in, and the old one is only freed once no scan
+    // of the handles can still be reading it.
+    struct HandleTableCalloutBucket
+    {
+        EEType *                        m_pTypeFilter;          // NULL if the bucket is empty
+        UInt32                          m_cCallouts;            // Number of callouts for the type
+        void **                         m_rgCalloutMethods;     // Most recently registered first, NULL terminated
+    };
+
+    struct HandleTableCalloutMap
+    {
+        UInt32                          m_uBucketMask;          // Number of buckets - 1, a power of 2
+        UInt32                          m_cMethodSlots;         // Size of the array m_rgCalloutMethods point into
+        HandleTableCalloutBucket *      m_rgBuckets;
+        HandleTableCalloutMap *         m_pNextRetired;         // Next map waiting to be freed
+    };
+
+    static HandleTableCalloutMap * volatile s_pHandleTableCalloutMap;
+
+    // Maps that have been replaced but may still be in use by a scan, and the number of scans in progress.
+    static HandleTableCalloutMap * s_pRetiredHandleTableCalloutMaps;
+    static volatile Int32 s_cHandleTableScans;
+
+    static HandleTableCalloutBucket * FindHandleTableCalloutBucket(HandleTableCalloutMap * pMap, EEType * pType);
+    static void FillHandleTableCalloutMap(HandleTableCalloutMap * pMap);
+    static bool RebuildHandleTableCalloutMap();
+    static void PublishHandleTableCalloutMap(HandleTableCalloutMap * pMap);
+
+    // Lock protecting access to s_rgGcRestrictedCallouts, s_pHandleTableRestrictedCallouts,
+    // s_pHandleTableCalloutMap and s_pRetiredHandleTableCalloutMaps during registration and unregistration.
+    // It's not taken during the callbacks, which can run on GC threads while a registration is in progress;
+    // those only read a published map, bracketed by BeginRefCountedHandleCallbacks and
+    // EndRefCountedHandleCallbacks.
     static CrstStatic s_sLock;
 
     // Prototypes for the callouts.
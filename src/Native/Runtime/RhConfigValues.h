@@ -19,6 +19,15 @@ RETAIL_CONFIG_VALUE(HeapVerify)
 RETAIL_CONFIG_VALUE(StressLogLevel)
 RETAIL_CONFIG_VALUE(TotalStressLogSize)
 RETAIL_CONFIG_VALUE(DisableBGC)
+RETAIL_CONFIG_VALUE(GCStringDedupStatsMB)                              // MB of gen2 string contents to hash per BGC looking for duplicates, 0 disables
+RETAIL_CONFIG_VALUE(GCBgcMarkThreads)                                  // Number of helper threads for concurrent background marking, 0 marks on the BGC thread alone
+RETAIL_CONFIG_VALUE(GCLOHThreshold)                                    // Size in bytes at which objects go on the LOH, from 85000 up to half of gen0's max size
+RETAIL_CONFIG_VALUE(GCLOHCompactionMode)                               // Non-zero compacts the LOH on every blocking gen2 GC
+RETAIL_CONFIG_VALUE_WITH_DEFAULT(GCLOHCompactFragPercent, 0x32)        // LOH free space percentage that makes compacting it worthwhile, 0 disables
+RETAIL_CONFIG_VALUE_WITH_DEFAULT(GCLOHCompactMinFragMB, 0x20)          // Minimum LOH free space (in MB) before compacting it is considered
+RETAIL_CONFIG_VALUE_WITH_DEFAULT(GCLOHCompactLargestFreePercent, 0x32) // Only compact if the largest LOH free item is below this percentage of the free space
+RETAIL_CONFIG_VALUE(GCSegmentStandbyMB)                                // MB of freed segment address space kept reserved for reuse, 0 returns freed segments to the OS
+RETAIL_CONFIG_VALUE_WITH_DEFAULT(GCSegmentStandbyMaxAge, 0x4)          // Number of gen2 GCs a standby segment can stay unused before it is returned to the OS
 DEBUG_CONFIG_VALUE(DisallowRuntimeServicesFallback)
 DEBUG_CONFIG_VALUE(GcStressThrottleMode)    // gcstm_TriggerAlways / gcstm_TriggerOnFirstHit / gcstm_TriggerRandom
 DEBUG_CONFIG_VALUE(GcStressFreqCallsite)    // Number of times to force GC out of GcStressFreqDenom (for GCSTM_RANDOM)
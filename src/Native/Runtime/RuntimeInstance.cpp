@@ -26,6 +26,9 @@
 #include "StackFrameIterator.h"
 #include "thread.h"
 #include "DebugEventSource.h"
+#include "Range.h"
+#include "memaccessmgr.h"
+#include "allocheap.h"
 
 #include "CommonMacros.inl"
 #include "slist.inl"
@@ -40,6 +43,14 @@ bool ShouldHijackForGcStress(UIntNative CallsiteIP, HijackType ht);
 #include "shash.h"
 #include "shash.inl"
 
+// for performance and correctness reasons (at least on ARM), we wish to align the static areas on a
+// multiple of STATIC_FIELD_ALIGNMENT
+static const UInt32 STATIC_FIELD_ALIGNMENT = 8;
+
+// Dynamically created EETypes start on a cache line of their own, so that casting and dispatch on them
+// touch as few lines as possible.
+static const UInt32 DYNAMIC_TYPE_ALIGNMENT = 64;
+
 #ifndef DACCESS_COMPILE
 COOP_PINVOKE_HELPER(UInt8 *, RhSetErrorInfoBuffer, (UInt8 * pNewBuffer))
 {
@@ -370,7 +381,10 @@ RuntimeInstance::RuntimeInstance() :
     m_fStandaloneExeMode(false),
     m_pStandaloneExeModule(NULL),
     m_pGenericTypeHashTable(NULL),
-    m_conservativeStackReportingEnabled(false)
+    m_pDynamicTypeHeap(NULL),
+    m_pGenericInstanceHeap(NULL),
+    m_conservativeStackReportingEnabled(false),
+    m_shadowStackReportingEnabled(false)
 {
 }
 
@@ -388,6 +402,18 @@ RuntimeInstance::~RuntimeInstance()
         m_pThreadStore = NULL;
     }
 
+    if (NULL != m_pDynamicTypeHeap)
+    {
+        delete m_pDynamicTypeHeap;
+        m_pDynamicTypeHeap = NULL;
+    }
+
+    if (NULL != m_pGenericInstanceHeap)
+    {
+        delete m_pGenericInstanceHeap;
+        m_pGenericInstanceHeap = NULL;
+    }
+
     m_genericInstHashtabLock.Destroy();
 }
 
@@ -402,6 +428,13 @@ bool RuntimeInstance::EnableConservativeStackReporting()
     return true;
 }
 
+bool RuntimeInstance::EnableShadowStackReporting()
+{
+    ASSERT(!m_conservativeStackReportingEnabled);
+    m_shadowStackReportingEnabled = true;
+    return true;
+}
+
 EXTERN_C void REDHAWK_CALLCONV RhpSetHaveNewClasslibs();
 
 bool RuntimeInstance::RegisterModule(ModuleHeader *pModuleHeader)
@@ -563,6 +596,14 @@ RuntimeInstance * RuntimeInstance::Create(HANDLE hPalInstance)
     if (NULL == pThreadStore)
         return NULL;
 
+    NewHolder<AllocHeap> pDynamicTypeHeap = new (nothrow) AllocHeap();
+    if (NULL == pDynamicTypeHeap || !pDynamicTypeHeap->Init())
+        return NULL;
+
+    NewHolder<AllocHeap> pGenericInstanceHeap = new (nothrow) AllocHeap();
+    if (NULL == pGenericInstanceHeap || !pGenericInstanceHeap->Init())
+        return NULL;
+
 #ifdef FEATURE_VSD
     VirtualCallStubManager * pVSD;
     if (!CreateVSD(&pVSD))
@@ -571,6 +612,12 @@ RuntimeInstance * RuntimeInstance::Create(HANDLE hPalInstance)
 
     pThreadStore.SuppressRelease();
     pRuntimeInstance->m_pThreadStore = pThreadStore;
+
+    pDynamicTypeHeap.SuppressRelease();
+    pRuntimeInstance->m_pDynamicTypeHeap = pDynamicTypeHeap;
+
+    pGenericInstanceHeap.SuppressRelease();
+    pRuntimeInstance->m_pGenericInstanceHeap = pGenericInstanceHeap;
     pRuntimeInstance->m_hPalInstance = hPalInstance;
 
 #ifdef FEATURE_VSD
@@ -838,16 +885,13 @@ UnifiedGenericInstance *RuntimeInstance::UnifyGenericInstance(GenericInstanceDes
         PTR_StaticGcDesc pLocalGcStaticDesc = cbGcStaticFields ? pLocalGid->GetGcStaticFieldDesc() : NULL;
         UInt32 cbGcDesc = pLocalGcStaticDesc ? pLocalGcStaticDesc->GetSize() : 0;
 
-        // for performance and correctness reasons (at least on ARM), we wish to align the static areas on a
-        // multiple of STATIC_FIELD_ALIGNMENT
-        const UInt32 STATIC_FIELD_ALIGNMENT = 8;
         UInt32 cbMemory = (UInt32)ALIGN_UP(sizeof(UnifiedGenericInstance) + cbPaddedGid + cbEEType, STATIC_FIELD_ALIGNMENT) +
                           (UInt32)ALIGN_UP(cbNonGcStaticFields, STATIC_FIELD_ALIGNMENT) +
                           cbGcStaticFields +
                           cbGcDesc;
         // Note: Generic instance unification is not a product feature that we ship in ProjectN, so there is no need to
         // use safe integers when computing the value of cbMemory.
-        UInt8 * pMemory = new (nothrow) UInt8[cbMemory];
+        UInt8 * pMemory = m_pGenericInstanceHeap->AllocAligned(cbMemory, sizeof(void *) * 2);
         if (pMemory == NULL)
             return NULL;
 
@@ -905,6 +949,7 @@ UnifiedGenericInstance *RuntimeInstance::UnifyGenericInstance(GenericInstanceDes
         // Initialize the UnifiedGenericInstance.
         pCanonicalInst->m_pNext = m_genericInstHashtabUpdates[hashCode];
         pCanonicalInst->m_cRefs = 1;
+        pCanonicalInst->m_cbMemory = cbMemory;
 
         // Update canonical GenericInstanceDesc with any values that are no longer local to the module.
         pCanonicalGid->SetEEType(pCanonicalType);
@@ -935,7 +980,7 @@ UnifiedGenericInstance *RuntimeInstance::UnifyGenericInstance(GenericInstanceDes
         // don't modify any global state (the unification hash table) until this call has succeeded.
         if (!FlattenGenericInstance(pCanonicalInst))
         {
-            delete [] pMemory;
+            m_pGenericInstanceHeap->Free(pCanonicalInst, cbMemory);
             return NULL;
         }
 
@@ -1058,7 +1103,7 @@ void RuntimeInstance::ReleaseGenericInstance(GenericInstanceDesc * pInst)
                 if (pTypeVar->IsRuntimeAllocated())
                     delete pTypeVar;
             }
-            delete [] (UInt8*)pGlobalInst;
+            m_pGenericInstanceHeap->Free(pGlobalInst, pGlobalInst->m_cbMemory);
 
             return;
         }
@@ -1184,6 +1229,70 @@ EEType * RuntimeInstance::GetGenericInstantiation(EEType *               pEEType
     return pInst->GetGenericTypeDef().GetValue();
 }
 
+UInt8 * RuntimeInstance::AllocateDynamicTypeMemory(UInt32 cbMemory)
+{
+    // Pieces of a type built up by successive calls end up next to each other since the heap hands out memory
+    // by bumping a pointer. Two pointers worth of alignment matches what operator new used to provide.
+    return m_pDynamicTypeHeap->AllocAligned(cbMemory, sizeof(void *) * 2);
+}
+
+void RuntimeInstance::GetRuntimeHeapBytes(UIntNative * pcbLive, UIntNative * pcbReserved)
+{
+    *pcbLive = m_pDynamicTypeHeap->GetLiveBytes() + m_pGenericInstanceHeap->GetLiveBytes();
+    *pcbReserved = m_pDynamicTypeHeap->GetReservedBytes() + m_pGenericInstanceHeap->GetReservedBytes();
+}
+
+static GenericInstanceDesc::OptionalFieldTypes GetDynamicGenericInstanceDescFlags(EEType *   pTemplateType,
+                                                                                   UInt32     nonGcStaticDataSize,
+                                                                                   UInt32     gcStaticDataSize,
+                                                                                   UInt32     threadStaticOffset)
+{
+    GenericInstanceDesc::OptionalFieldTypes flags = GenericInstanceDesc::GID_Instantiation;
+    
+    if (pTemplateType->HasGenericVariance())
+        flags |= GenericInstanceDesc::GID_Variance;
+    if (gcStaticDataSize > 0)
+        flags |= GenericInstanceDesc::GID_GcStaticFields | GenericInstanceDesc::GID_GcRoots;
+    if (nonGcStaticDataSize > 0)
+        flags |= GenericInstanceDesc::GID_NonGcStaticFields;
+    if (threadStaticOffset != 0)
+        flags |= GenericInstanceDesc::GID_ThreadStaticFields | GenericInstanceDesc::GID_GcRoots;
+
+    return flags;
+}
+
+// Size of the single chunk of memory holding the GenericInstanceDesc of a dynamically created type followed
+// by its non-GC and GC static data.
+static UInt32 GetDynamicGenericInstanceDescMemorySize(EEType *   pTemplateType,
+                                                      UInt32     arity,
+                                                      UInt32     nonGcStaticDataSize,
+                                                      UInt32     gcStaticDataSize,
+                                                      UInt32     threadStaticOffset)
+{
+    GenericInstanceDesc::OptionalFieldTypes flags = 
+        GetDynamicGenericInstanceDescFlags(pTemplateType, nonGcStaticDataSize, gcStaticDataSize, threadStaticOffset);
+
+    // Note: arity is limited to a maximum value of 65535 on the managed layer before CreateGenericInstanceDesc
+    // gets called. With this value, cbGidSize will not exceed 600K. The static data sizes are read from native
+    // layout info in the managed layer, where there is also a check that they do not exceed the max value of
+    // a signed Int32. So no need to use safe integers when adding them up on 64-bit.
+    size_t cbGidSize = GenericInstanceDesc::GetSize(flags, arity);
+    size_t cbMemory = ALIGN_UP(cbGidSize, STATIC_FIELD_ALIGNMENT) +
+                      ALIGN_UP((size_t)nonGcStaticDataSize, STATIC_FIELD_ALIGNMENT) +
+                      gcStaticDataSize;
+
+    if (cbMemory > UInt32_MAX)
+    {
+        ASSERT_UNCONDITIONALLY("Invalid sizes for dynamic type detected.");
+        RhFailFast();
+    }
+
+    return (UInt32)cbMemory;
+}
+
+// If pMemory is NULL, the GenericInstanceDesc and static data are allocated here. Otherwise it must point to
+// GetDynamicGenericInstanceDescMemorySize bytes aligned on STATIC_FIELD_ALIGNMENT, which the caller releases
+// if this fails.
 bool RuntimeInstance::CreateGenericInstanceDesc(EEType *             pEEType,
                                                 EEType *             pTemplateType,
                                                 UInt32               arity,
@@ -1193,7 +1302,8 @@ bool RuntimeInstance::CreateGenericInstanceDesc(EEType *             pEEType,
                                                 UInt32               threadStaticOffset,
                                                 StaticGcDesc *       pGcStaticsDesc,
                                                 StaticGcDesc *       pThreadStaticsDesc,
-                                                UInt32*              pGenericVarianceFlags)
+                                                UInt32*              pGenericVarianceFlags,
+                                                UInt8 *              pMemory)
 {
     if (m_pGenericTypeHashTable == NULL)
     {
@@ -1201,55 +1311,43 @@ bool RuntimeInstance::CreateGenericInstanceDesc(EEType *             pEEType,
             return false;
     }
 
-    GenericInstanceDesc::OptionalFieldTypes flags = GenericInstanceDesc::GID_Instantiation;
-    
-    if (pTemplateType->HasGenericVariance())
-        flags |= GenericInstanceDesc::GID_Variance;
-    if (gcStaticDataSize > 0)
-        flags |= GenericInstanceDesc::GID_GcStaticFields | GenericInstanceDesc::GID_GcRoots;
-    if (nonGcStaticDataSize > 0)
-        flags |= GenericInstanceDesc::GID_NonGcStaticFields;
-    if (threadStaticOffset != 0)
-        flags |= GenericInstanceDesc::GID_ThreadStaticFields | GenericInstanceDesc::GID_GcRoots;
+    GenericInstanceDesc::OptionalFieldTypes flags = 
+        GetDynamicGenericInstanceDescFlags(pTemplateType, nonGcStaticDataSize, gcStaticDataSize, threadStaticOffset);
 
-    // Note: arity is limited to a maximum value of 65535 on the managed layer before CreateGenericInstanceDesc
-    // gets called. With this value, cbGidSize will not exceed 600K, so no need to use safe integers
     size_t cbGidSize = GenericInstanceDesc::GetSize(flags, arity);
+    UInt32 cbMemory = GetDynamicGenericInstanceDescMemorySize(pTemplateType, arity, nonGcStaticDataSize, gcStaticDataSize, threadStaticOffset);
 
-    NewArrayHolder<UInt8> pGidMemory = new (nothrow) UInt8[cbGidSize];
-    if (pGidMemory == NULL)
-        return false;
+    // The GenericInstanceDesc and static data are allocated together so they're released together if the
+    // type can't be created, and so that they're close to each other.
+    NewArrayHolder<UInt8> pOwnedMemory;
+    if (pMemory == NULL)
+    {
+        pOwnedMemory = new (nothrow) UInt8[cbMemory];
+        if (pOwnedMemory == NULL)
+            return false;
+        pMemory = pOwnedMemory;
+    }
+    ASSERT(IS_ALIGNED(pMemory, STATIC_FIELD_ALIGNMENT));
 
-    GenericInstanceDesc * pGid = (GenericInstanceDesc *)(UInt8 *)pGidMemory;
-    memset(pGid, 0, cbGidSize);
+    memset(pMemory, 0, cbMemory);
+
+    GenericInstanceDesc * pGid = (GenericInstanceDesc *)pMemory;
+    pMemory += ALIGN_UP(cbGidSize, STATIC_FIELD_ALIGNMENT);
 
     pGid->Init(flags);
     pGid->SetEEType(pEEType);
     pGid->SetArity(arity);
 
-    NewArrayHolder<UInt8> pNonGcStaticData;
     if (nonGcStaticDataSize > 0)
     {
-        // The value of nonGcStaticDataSize is read from native layout info in the managed layer, where
-        // there is also a check that it does not exceed the max value of a signed Int32
         ASSERT(nonGCStaticDataOffset <= nonGcStaticDataSize);
-        pNonGcStaticData = new (nothrow) UInt8[nonGcStaticDataSize];
-        if (pNonGcStaticData == NULL)
-            return false;
-        memset(pNonGcStaticData, 0, nonGcStaticDataSize);
-        pGid->SetNonGcStaticFieldData(pNonGcStaticData + nonGCStaticDataOffset);
+        pGid->SetNonGcStaticFieldData(pMemory + nonGCStaticDataOffset);
+        pMemory += ALIGN_UP(nonGcStaticDataSize, STATIC_FIELD_ALIGNMENT);
     }
 
-    NewArrayHolder<UInt8> pGcStaticData;
     if (gcStaticDataSize > 0)
     {
-        // The value of gcStaticDataSize is read from native layout info in the managed layer, where
-        // there is also a check that it does not exceed the max value of a signed Int32
-        pGcStaticData = new (nothrow) UInt8[gcStaticDataSize];
-        if (pGcStaticData == NULL)
-            return false;
-        memset(pGcStaticData, 0, gcStaticDataSize);
-        pGid->SetGcStaticFieldData(pGcStaticData);
+        pGid->SetGcStaticFieldData(pMemory);
         pGid->SetGcStaticFieldDesc(pGcStaticsDesc);
     }
 
@@ -1285,9 +1383,7 @@ bool RuntimeInstance::CreateGenericInstanceDesc(EEType *             pEEType,
         m_genericInstReportList = pGid;
     }
 
-    pGidMemory.SuppressRelease();
-    pNonGcStaticData.SuppressRelease();
-    pGcStaticData.SuppressRelease();
+    pOwnedMemory.SuppressRelease();
     return true;
 }
 
@@ -1419,11 +1515,25 @@ COOP_PINVOKE_HELPER(EEType *, RhCloneType, (EEType *        pTemplate,
         RhFailFast();
     }
 
-    NewArrayHolder<UInt8> pEETypeMemory = new (nothrow) UInt8[cbGCDescAligned + cbEEType + sizeof(EEType *)+cbOptionalFieldsSize];
+    // The GCDesc, EEType (with its vtable and interface map), optional fields and, for generic types, the
+    // GenericInstanceDesc and static data all live in one chunk, with the EEType starting a cache line. The
+    // chunk is released as a whole if any part of the type can't be created.
+    UInt32 cbEETypeChunk = (UInt32)ALIGN_UP(cbEEType + sizeof(EEType *) + cbOptionalFieldsSize, STATIC_FIELD_ALIGNMENT);
+    UInt32 cbGidChunk = 0;
+    if (pTemplate->IsGeneric())
+        cbGidChunk = GetDynamicGenericInstanceDescMemorySize(pTemplate, arity, nonGcStaticDataSize, gcStaticDataSize, threadStaticsOffset);
+
+    if (cbGidChunk > UInt32_MAX - (DYNAMIC_TYPE_ALIGNMENT - 1) - cbGCDescAligned - cbEETypeChunk)
+    {
+        ASSERT_UNCONDITIONALLY("Invalid sizes for dynamic type detected.");
+        RhFailFast();
+    }
+
+    NewArrayHolder<UInt8> pEETypeMemory = new (nothrow) UInt8[(DYNAMIC_TYPE_ALIGNMENT - 1) + cbGCDescAligned + cbEETypeChunk + cbGidChunk];
     if (pEETypeMemory == NULL)
         return NULL;
 
-    EEType * pEEType = (EEType *)((UInt8*)pEETypeMemory + cbGCDescAligned);
+    EEType * pEEType = (EEType *)ALIGN_UP((UInt8*)pEETypeMemory + cbGCDescAligned, DYNAMIC_TYPE_ALIGNMENT);
 
     UInt32 cbTemplate = EEType::GetSizeofEEType(pTemplate->GetNumVtableSlots(),
                                                 pTemplate->GetNumInterfaces(),
@@ -1463,7 +1573,9 @@ COOP_PINVOKE_HELPER(EEType *, RhCloneType, (EEType *        pTemplate,
                 ((UInt32*)pGenericVarianceFlags)[i] = (UInt32)pTemplateGid->GetParameterVariance(i);
         }
 
-        if (!GetRuntimeInstance()->CreateGenericInstanceDesc(pEEType, pTemplate, arity, nonGcStaticDataSize, nonGCStaticDataOffset, gcStaticDataSize, threadStaticsOffset, pGcStaticsDesc, pThreadStaticsDesc, (UInt32*)pGenericVarianceFlags))
+        UInt8 * pGidMemory = (UInt8 *)pEEType + cbEETypeChunk;
+
+        if (!GetRuntimeInstance()->CreateGenericInstanceDesc(pEEType, pTemplate, arity, nonGcStaticDataSize, nonGCStaticDataOffset, gcStaticDataSize, threadStaticsOffset, pGcStaticsDesc, pThreadStaticsDesc, (UInt32*)pGenericVarianceFlags, pGidMemory))
             return NULL;
     }
 
@@ -1478,7 +1590,7 @@ COOP_PINVOKE_HELPER(PTR_VOID, RhAllocateMemory, (UInt32 size))
     // Generic memory allocation function, for use by managed code
     // Note: all callers to RhAllocateMemory on the managed side use checked integer arithmetics to catch overflows,
     // so there is no need to use safe integers here.
-    PTR_VOID pMemory = new (nothrow) UInt8[size];
+    PTR_VOID pMemory = GetRuntimeInstance()->AllocateDynamicTypeMemory(size);
     if (pMemory == NULL)
         return NULL;
 
@@ -1566,6 +1678,8 @@ enum RuntimeHelperKind
     CastClass,
     AllocateArray,
     CheckArrayElementType,
+    Box,
+    Unbox,
 };
 
 // The dictionary codegen expects a pointer that points at a memory location that points to the method pointer
@@ -1591,6 +1705,17 @@ DECLARE_INDIRECTION(RhTypeCast_CheckCastInterface);
 
 DECLARE_INDIRECTION(RhTypeCast_CheckVectorElemAddr);
 
+DECLARE_INDIRECTION(RhpNewBoxed1);
+DECLARE_INDIRECTION(RhpNewBoxed2);
+DECLARE_INDIRECTION(RhpNewBoxed4);
+DECLARE_INDIRECTION(RhpNewBoxed8);
+
+DECLARE_INDIRECTION(RhUnbox);
+DECLARE_INDIRECTION(RhpUnbox1);
+DECLARE_INDIRECTION(RhpUnbox2);
+DECLARE_INDIRECTION(RhpUnbox4);
+DECLARE_INDIRECTION(RhpUnbox8);
+
 #ifdef _ARM_
 DECLARE_INDIRECTION(RhpNewFinalizableAlign8);
 DECLARE_INDIRECTION(RhpNewFastMisalign);
@@ -1599,6 +1724,30 @@ DECLARE_INDIRECTION(RhpNewFastAlign8);
 DECLARE_INDIRECTION(RhpNewArrayAlign8);
 #endif
 
+EXTERN_C REDHAWK_API UInt32 REDHAWK_CALLCONV RhGetValueTypeSize(EEType * pEEType);
+
+// Returns the size of the field data of value types that the specialized box and unbox helpers handle:
+// no GC references, not Nullable and 1, 2, 4 or 8 bytes. Returns 0 for everything else.
+static UInt32 GetSpecializedBoxSize(EEType * pEEType)
+{
+    if (!pEEType->get_IsValueType() || pEEType->HasReferenceFields() || pEEType->IsNullable())
+        return 0;
+
+#ifdef _ARM_
+    if (pEEType->RequiresAlign8())
+        return 0;
+#endif
+
+    UInt32 cbFields = RhGetValueTypeSize(pEEType);
+    switch (cbFields)
+    {
+    case 1: case 2: case 4: case 8:
+        return cbFields;
+    default:
+        return 0;
+    }
+}
+
 COOP_PINVOKE_HELPER(PTR_VOID, RhGetRuntimeHelperForType, (EEType * pEEType, int helperKind))
 {
     // This implementation matches what the binder does (MetaDataEngine::*() in rh\src\tools\rhbind\MetaDataEngine.cpp)
@@ -1649,6 +1798,27 @@ COOP_PINVOKE_HELPER(PTR_VOID, RhGetRuntimeHelperForType, (EEType * pEEType, int
     case RuntimeHelperKind::CheckArrayElementType:
         return INDIRECTION(RhTypeCast_CheckVectorElemAddr);
 
+    case RuntimeHelperKind::Box:
+        // Other shapes go through RhBox in the classlib, which also deals with Nullable.
+        switch (GetSpecializedBoxSize(pEEType))
+        {
+        case 1: return INDIRECTION(RhpNewBoxed1);
+        case 2: return INDIRECTION(RhpNewBoxed2);
+        case 4: return INDIRECTION(RhpNewBoxed4);
+        case 8: return INDIRECTION(RhpNewBoxed8);
+        default: return NULL;
+        }
+
+    case RuntimeHelperKind::Unbox:
+        switch (GetSpecializedBoxSize(pEEType))
+        {
+        case 1: return INDIRECTION(RhpUnbox1);
+        case 2: return INDIRECTION(RhpUnbox2);
+        case 4: return INDIRECTION(RhpUnbox4);
+        case 8: return INDIRECTION(RhpUnbox8);
+        default: return INDIRECTION(RhUnbox);
+        }
+
     default:
         UNREACHABLE();
     }
@@ -17,6 +17,7 @@ class GenericTypeHashTable;
 typedef DPTR(GenericTypeHashTable) PTR_GenericTypeHashTable;
 struct StaticGcDesc;
 struct SimpleModuleHeader;
+class AllocHeap;
 
 class RuntimeInstance
 {
@@ -88,7 +89,14 @@ class RuntimeInstance
     // This is used (in standalone mode only) to build an on-demand hash tables of all generic instantiations
     PTR_GenericTypeHashTable            m_pGenericTypeHashTable;
 
+    // Backs RhAllocateMemory, so that the pieces of a dynamically created type end up next to each other
+    AllocHeap *                 m_pDynamicTypeHeap;
+
+    // Unified generic instantiations, which are freed again once no module uses them
+    AllocHeap *                 m_pGenericInstanceHeap;
+
     bool                        m_conservativeStackReportingEnabled;
+    bool                        m_shadowStackReportingEnabled;
 
     RuntimeInstance();
 
@@ -126,6 +134,8 @@ public:
     PTR_UInt8 FindMethodStartAddress(PTR_VOID ControlPC);
     bool EnableConservativeStackReporting();
     bool IsConservativeStackReportingEnabled() { return m_conservativeStackReportingEnabled; }
+    bool EnableShadowStackReporting();
+    bool IsShadowStackReportingEnabled() { return m_shadowStackReportingEnabled; }
 
 #ifdef FEATURE_DYNAMIC_CODE
     bool RegisterCodeManager(ICodeManager * pCodeManager, PTR_VOID pvStartRange, UInt32 cbRange);
@@ -188,7 +198,14 @@ public:
                                    UInt32               threadStaticOffset,
                                    StaticGcDesc *       pGcStaticsDesc,
                                    StaticGcDesc *       pThreadStaticsDesc,
-                                   UInt32*              pGenericVarianceFlags);
+                                   UInt32*              pGenericVarianceFlags,
+                                   UInt8 *              pMemory = NULL);
+
+    // Memory for dynamically created types that is never freed (see RhAllocateMemory).
+    UInt8 * AllocateDynamicTypeMemory(UInt32 cbMemory);
+
+    // Bytes in use by, and reserved for, the runtime's own heaps of type data (see RhGetRuntimeHeapBytes).
+    void GetRuntimeHeapBytes(UIntNative * pcbLive, UIntNative * pcbReserved);
 
 #ifdef FEATURE_PROFILING
     void InitProfiling(ModuleHeader *pModuleHeader);
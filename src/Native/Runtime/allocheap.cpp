@@ -14,6 +14,7 @@
 #include "holder.h"
 #include "Crst.h"
 #include "Range.h"
+#include "Volatile.h"
 #ifdef FEATURE_RWX_MEMORY
 #include "memaccessmgr.h"
 #endif
@@ -36,8 +37,14 @@ AllocHeap::AllocHeap()
       m_pNextFree(NULL),
       m_pFreeCommitEnd(NULL),
       m_pFreeReserveEnd(NULL),
+      m_pCurBlockStart(NULL),
       m_pbInitialMem(NULL),
       m_fShouldFreeInitialMem(false),
+      m_rgSmallFreeLists(),
+      m_pLargeFreeList(NULL),
+      m_cbRetiredBlocksUsed(0),
+      m_cbFreeListed(0),
+      m_cbReserved(0),
       m_lock(CrstAllocHeap)
       COMMA_INDEBUG(m_fIsInit(false))
 {
@@ -58,8 +65,14 @@ AllocHeap::AllocHeap(
       m_pNextFree(NULL),
       m_pFreeCommitEnd(NULL),
       m_pFreeReserveEnd(NULL),
+      m_pCurBlockStart(NULL),
       m_pbInitialMem(NULL),
       m_fShouldFreeInitialMem(false),
+      m_rgSmallFreeLists(),
+      m_pLargeFreeList(NULL),
+      m_cbRetiredBlocksUsed(0),
+      m_cbFreeListed(0),
+      m_cbReserved(0),
       m_lock(CrstAllocHeap)
       COMMA_INDEBUG(m_fIsInit(false))
 {
@@ -108,8 +121,10 @@ bool AllocHeap::Init(
         return false;
     }
 
+    m_pCurBlockStart = pbInitialMem;
     m_pbInitialMem = pbInitialMem;
     m_fShouldFreeInitialMem = fShouldFreeInitialMem;
+    m_cbReserved += cbInitialMemReserve;
 
     INDEBUG(m_fIsInit = true;)
     return true;
@@ -146,6 +161,22 @@ UInt8 * AllocHeap::_Alloc(
     if (_UseAccessManager() && pRWAccessHolder == NULL)
         return NULL;
 
+    UIntNative cbRounded = ALIGN_UP(cbMem, s_allocGranularity);
+    if (cbRounded < cbMem)
+        return NULL;
+    cbMem = cbRounded;
+
+    // Without an access manager there is no per-page state to maintain, so the current block can be
+    // carved up without taking the lock. Freed blocks are only recycled then too.
+    if (!_UseAccessManager())
+    {
+        UInt8 * pbMem = _AllocFromFreeList(cbMem, alignment);
+        if (pbMem == NULL)
+            pbMem = _AllocFromCurBlockNoLock(cbMem, alignment);
+        if (pbMem != NULL)
+            return pbMem;
+    }
+
     CrstHolder lock(&m_lock);
 
     UInt8 * pbMem = _AllocFromCurBlock(cbMem, alignment PASS_WRITE_ACCESS_HOLDER_ARG);
@@ -157,6 +188,16 @@ UInt8 * AllocHeap::_Alloc(
         return NULL;
 
     pbMem = _AllocFromCurBlock(cbMem, alignment PASS_WRITE_ACCESS_HOLDER_ARG);
+
+    // Lock-free allocations on other threads may have used up the new block already.
+    while (pbMem == NULL && !_UseAccessManager())
+    {
+        if (!_AllocNewBlock(cbMem))
+            return NULL;
+
+        pbMem = _AllocFromCurBlock(cbMem, alignment PASS_WRITE_ACCESS_HOLDER_ARG);
+    }
+
     ASSERT_MSG(pbMem != NULL, "AllocHeap::Alloc: failed to alloc mem after new block alloc");
 
     return pbMem;
@@ -179,6 +220,105 @@ UInt8 * AllocHeap::AllocAligned(
     return _Alloc(cbMem, alignment PASS_WRITE_ACCESS_HOLDER_ARG);
 }
 
+//-------------------------------------------------------------------------------------------------
+void AllocHeap::Free(void * pvMem, UIntNative cbMem)
+{
+    ASSERT(!_UseAccessManager());
+    ASSERT(IS_ALIGNED(pvMem, s_allocGranularity));
+    ASSERT(Contains(pvMem, cbMem));
+
+    // The allocation was rounded up the same way, so the block really is this big.
+    cbMem = ALIGN_UP(cbMem, s_allocGranularity);
+    if (cbMem == 0)
+        return;
+
+    CrstHolder lock(&m_lock);
+
+    _AddToFreeList(static_cast<UInt8*>(pvMem), cbMem);
+}
+
+//-------------------------------------------------------------------------------------------------
+// Must be called with the lock held. cbMem is a non-zero multiple of s_allocGranularity.
+void AllocHeap::_AddToFreeList(UInt8 * pbMem, UIntNative cbMem)
+{
+    FreeListEntry * pEntry = reinterpret_cast<FreeListEntry *>(pbMem);
+    pEntry->m_cbSize = cbMem;
+
+    FreeListEntry ** ppHead = (cbMem <= s_maxSmallFreeListSize) ?
+        &m_rgSmallFreeLists[cbMem / s_allocGranularity] :
+        &m_pLargeFreeList;
+    pEntry->m_pNext = *ppHead;
+    *ppHead = pEntry;
+
+    m_cbFreeListed += cbMem;
+}
+
+//-------------------------------------------------------------------------------------------------
+// cbMem is a non-zero multiple of s_allocGranularity. Blocks that aren't suitably aligned are passed over.
+UInt8 * AllocHeap::_AllocFromFreeList(UIntNative cbMem, UIntNative alignment)
+{
+    // Don't bother taking the lock if the lists look empty.
+    if (VolatileLoad(&m_cbFreeListed) == 0)
+        return NULL;
+
+    CrstHolder lock(&m_lock);
+
+    FreeListEntry * pEntry = NULL;
+
+    if (cbMem <= s_maxSmallFreeListSize)
+    {
+        FreeListEntry ** ppHead = &m_rgSmallFreeLists[cbMem / s_allocGranularity];
+        if (*ppHead != NULL && IS_ALIGNED(*ppHead, alignment))
+        {
+            pEntry = *ppHead;
+            *ppHead = pEntry->m_pNext;
+        }
+    }
+
+    if (pEntry == NULL)
+    {
+        for (FreeListEntry ** ppEntry = &m_pLargeFreeList; *ppEntry != NULL; ppEntry = &(*ppEntry)->m_pNext)
+        {
+            if ((*ppEntry)->m_cbSize >= cbMem && IS_ALIGNED(*ppEntry, alignment))
+            {
+                pEntry = *ppEntry;
+                *ppEntry = pEntry->m_pNext;
+                break;
+            }
+        }
+    }
+
+    if (pEntry == NULL)
+        return NULL;
+
+    UIntNative cbEntry = pEntry->m_cbSize;
+    m_cbFreeListed -= cbEntry;
+
+    UInt8 * pbMem = reinterpret_cast<UInt8 *>(pEntry);
+    if (cbEntry > cbMem)
+        _AddToFreeList(pbMem + cbMem, cbEntry - cbMem);
+
+    memset(pbMem, 0, cbMem);
+    return pbMem;
+}
+
+//-------------------------------------------------------------------------------------------------
+UIntNative AllocHeap::GetLiveBytes()
+{
+    CrstHolder lock(&m_lock);
+
+    UIntNative cbCurBlockUsed = (m_pCurBlockStart != NULL) ? VolatileLoad(&m_pNextFree) - m_pCurBlockStart : 0;
+    return m_cbRetiredBlocksUsed + cbCurBlockUsed - m_cbFreeListed;
+}
+
+//-------------------------------------------------------------------------------------------------
+UIntNative AllocHeap::GetReservedBytes()
+{
+    CrstHolder lock(&m_lock);
+
+    return m_cbReserved;
+}
+
 //-------------------------------------------------------------------------------------------------
 bool AllocHeap::Contains(void* pvMem, UIntNative cbMem)
 {
@@ -257,9 +397,10 @@ bool AllocHeap::_UpdateMemPtrs(UInt8* pNextFree, UInt8* pFreeCommitEnd, UInt8* p
     }
 #endif // FEATURE_RWX_MEMORY
 
-    m_pNextFree = pNextFree;
-    m_pFreeCommitEnd = pFreeCommitEnd;
+    // Lock-free allocations read m_pNextFree before m_pFreeCommitEnd, publish them in the opposite order.
+    VolatileStore(&m_pNextFree, pNextFree);
     m_pFreeReserveEnd = pFreeReserveEnd;
+    VolatileStore(&m_pFreeCommitEnd, pFreeCommitEnd);
     return true;
 }
 
@@ -298,15 +439,49 @@ bool AllocHeap::_AllocNewBlock(UIntNative cbMem)
     // memory barrier to make sure any reader sees a consistent list.
     m_blockList.PushHeadInterlocked(pBlockListElem);
 
+    _RetireCurBlock();
+
+    m_pCurBlockStart = pbMem;
+    m_cbReserved += cbMem;
+
     return _UpdateMemPtrs(pbMem, pbMem + cbMem, pbMem + cbMem);
 }
 
+//-------------------------------------------------------------------------------------------------
+// Stops allocations from the current block before switching to a new one. Closing the committed range
+// first makes lock-free allocations fail their bounds check, and swapping out the free pointer makes any
+// that already passed it fail to advance it, so the value swapped out is final.
+void AllocHeap::_RetireCurBlock()
+{
+    VolatileStore(&m_pFreeCommitEnd, (UInt8 *)NULL);
+
+    UInt8 * pNextFree = (UInt8 *)PalInterlockedExchangePointer((void * volatile *)&m_pNextFree, NULL);
+    if (m_pCurBlockStart != NULL)
+        m_cbRetiredBlocksUsed += pNextFree - m_pCurBlockStart;
+}
+
 //-------------------------------------------------------------------------------------------------
 UInt8 * AllocHeap::_AllocFromCurBlock(
     UIntNative cbMem,
     UIntNative alignment
     WRITE_ACCESS_HOLDER_ARG)
 {
+    if (!_UseAccessManager())
+    {
+        // Other threads may be advancing the free pointer without the lock, so only commit here.
+        while (true)
+        {
+            UInt8 * pbMem = _AllocFromCurBlockNoLock(cbMem, alignment);
+            if (pbMem != NULL)
+                return pbMem;
+
+            UInt8 * pNextFree = VolatileLoad(&m_pNextFree);
+            UIntNative cbNeeded = cbMem + ((UInt8 *)ALIGN_UP(pNextFree, alignment) - pNextFree);
+            if (pNextFree + cbNeeded > m_pFreeCommitEnd && !_CommitFromCurBlock(cbNeeded))
+                return NULL;
+        }
+    }
+
     UInt8 * pbMem = NULL;
 
     cbMem += (UInt8 *)ALIGN_UP(m_pNextFree, alignment) - m_pNextFree;
@@ -331,6 +506,31 @@ UInt8 * AllocHeap::_AllocFromCurBlock(
     return pbMem;
 }
 
+//-------------------------------------------------------------------------------------------------
+// Carves cbMem bytes out of the committed part of the current block, racing with other threads doing
+// the same. Returns NULL if they don't fit, the caller must then take the lock and commit more memory
+// or switch to a new block.
+UInt8 * AllocHeap::_AllocFromCurBlockNoLock(
+    UIntNative cbMem,
+    UIntNative alignment)
+{
+    ASSERT(!_UseAccessManager());
+
+    while (true)
+    {
+        // Must be read in this order, see _UpdateMemPtrs and _RetireCurBlock.
+        UInt8 * pNextFree = VolatileLoad(&m_pNextFree);
+        UInt8 * pFreeCommitEnd = VolatileLoad(&m_pFreeCommitEnd);
+
+        UInt8 * pbMem = ALIGN_UP(pNextFree, alignment);
+        if (pbMem < pNextFree || pbMem > pFreeCommitEnd || cbMem > (UIntNative)(pFreeCommitEnd - pbMem))
+            return NULL;
+
+        if (PalInterlockedCompareExchangePointer((void * volatile *)&m_pNextFree, pbMem + cbMem, pNextFree) == pNextFree)
+            return pbMem;
+    }
+}
+
 //-------------------------------------------------------------------------------------------------
 bool AllocHeap::_CommitFromCurBlock(UIntNative cbMem)
 {
@@ -354,6 +554,13 @@ bool AllocHeap::_CommitFromCurBlock(UIntNative cbMem)
         }
 #endif // FEATURE_RWX_MEMORY
 
+        if (!_UseAccessManager())
+        {
+            // The free pointer may be advancing concurrently, leave it alone.
+            VolatileStore(&m_pFreeCommitEnd, m_pFreeCommitEnd + cbMemToCommit);
+            return true;
+        }
+
         return _UpdateMemPtrs(m_pNextFree, m_pFreeCommitEnd + cbMemToCommit);
     }
 
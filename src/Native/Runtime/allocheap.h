@@ -47,10 +47,22 @@ class AllocHeap
                          UIntNative alignment
                          WRITE_ACCESS_HOLDER_ARG_NULL_DEFAULT);
 
+    // Returns a block from Alloc or AllocAligned to the heap so that later allocations can reuse it. cbMem
+    // must be the size that was asked for. Reused memory is zeroed, like fresh memory. Must not be used on
+    // AllocHeaps created with a MemAccessMgr.
+    void Free(void * pvMem,
+              UIntNative cbMem);
+
     // Returns true if this AllocHeap owns the memory range [pvMem, pvMem+cbMem)
     bool Contains(void * pvMem,
                   UIntNative cbMem);
 
+    // Bytes handed out and not freed, including rounding and alignment padding.
+    UIntNative GetLiveBytes();
+
+    // Bytes of address space reserved by the heap.
+    UIntNative GetReservedBytes();
+
 #ifdef FEATURE_RWX_MEMORY
     // Used with previously-allocated memory for which RW access is needed again.
     // Returns true on success. R/W access will be granted until the holder is
@@ -65,7 +77,11 @@ class AllocHeap
     UInt8* _Alloc(UIntNative cbMem, UIntNative alignment WRITE_ACCESS_HOLDER_ARG);
     bool _AllocNewBlock(UIntNative cbMem);
     UInt8* _AllocFromCurBlock(UIntNative cbMem, UIntNative alignment WRITE_ACCESS_HOLDER_ARG);
+    UInt8* _AllocFromCurBlockNoLock(UIntNative cbMem, UIntNative alignment);
+    UInt8* _AllocFromFreeList(UIntNative cbMem, UIntNative alignment);
+    void _AddToFreeList(UInt8* pbMem, UIntNative cbMem);
     bool _CommitFromCurBlock(UIntNative cbMem);
+    void _RetireCurBlock();
 
     // Access protection helpers
 #ifdef FEATURE_RWX_MEMORY
@@ -78,6 +94,21 @@ class AllocHeap
 
     static const UIntNative s_minBlockSize = OS_PAGE_SIZE;
 
+    // Allocation sizes are rounded up to a multiple of s_allocGranularity, so every block starts on such a
+    // boundary and can hold a FreeListEntry once it's freed.
+    static const UIntNative s_allocGranularity = 16;
+
+    // Freed blocks of up to s_maxSmallFreeListSize bytes are kept on one list per size. Larger ones share a
+    // list that is searched for the first that fits, and split if it's bigger than needed.
+    static const UIntNative s_maxSmallFreeListSize = 256;
+    static const UIntNative s_cSmallFreeLists = s_maxSmallFreeListSize / s_allocGranularity + 1;
+
+    struct FreeListEntry
+    {
+        FreeListEntry * m_pNext;
+        UIntNative      m_cbSize;
+    };
+
     typedef rh::util::MemRange Block;
     typedef DPTR(Block) PTR_Block;
     struct BlockListElem : public Block
@@ -105,13 +136,26 @@ class AllocHeap
     rh::util::WriteAccessHolder     m_hCurPageRW;   // Used to hold RW access to the current allocation page
                                                     // Passed as pHint to MemAccessMgr::AcquireWriteAccess.
 #endif // FEATURE_RWX_MEMORY
+    // Unless an access manager is used, m_pNextFree is advanced without taking the lock, see
+    // _AllocFromCurBlockNoLock. Everything else is only modified under the lock.
     UInt8 *                         m_pNextFree;
     UInt8 *                         m_pFreeCommitEnd;
     UInt8 *                         m_pFreeReserveEnd;
+    UInt8 *                         m_pCurBlockStart;
 
     UInt8 *                         m_pbInitialMem;
     bool                            m_fShouldFreeInitialMem;
 
+    // Only modified under the lock. Allocations look at m_cbFreeListed without it to skip the lists when
+    // they're empty.
+    FreeListEntry *                 m_rgSmallFreeLists[s_cSmallFreeLists];
+    FreeListEntry *                 m_pLargeFreeList;
+
+    // Counters for GetLiveBytes and GetReservedBytes
+    UIntNative                      m_cbRetiredBlocksUsed;  // Bytes handed out from blocks before the current one
+    UIntNative                      m_cbFreeListed;         // Bytes on the free lists
+    UIntNative                      m_cbReserved;
+
     Crst                            m_lock;
 
     INDEBUG(bool                    m_fIsInit;)
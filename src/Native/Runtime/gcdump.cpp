@@ -414,10 +414,18 @@ size_t   FASTCALL   GCDump::DumpGCTable (PTR_UInt8              gcInfo,
     //
     // 11111111 -- STRING TERMINATOR
     //
+    // 10000000 00000000 { index } -- SEEKABLE INDEX (only as the first entry, see GCInfoCallsiteIndex)
+    //
 
     PTR_UInt8 pCursor = gcInfo;
     UInt32 curOffset = 0;
 
+    if (GCInfoCallsiteIndex::HasIndex(pCursor))
+    {
+        gcPrintf("   callsiteIndex:  present\r\n");
+        pCursor = GCInfoCallsiteIndex::SkipIndex(pCursor);
+    }
+
     for (;;)
     {
         UInt8 b = *pCursor++;
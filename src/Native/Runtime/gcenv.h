@@ -114,6 +114,8 @@ public:
 #endif // FEATURE_STRUCTALIGN
     bool RequiresAlign8() { return ((EEType*)this)->RequiresAlign8(); }
     bool IsValueType() { return ((EEType*)this)->get_IsValueType(); }
+    // String is the only type besides arrays whose instances have 2 byte components.
+    bool IsString() { return (((EEType*)this)->get_ComponentSize() == sizeof(UInt16)) && !((EEType*)this)->IsArray(); }
     UInt32_BOOL SanityCheck() { return ((EEType*)this)->Validate(); }
 };
 
@@ -185,7 +187,15 @@ public:
     int     GetGCForceCompact()             const { return 0; }
     int     GetGCRetainVM ()                const { return 0; }
     int     GetGCTrimCommit()               const { return 0; }
-    int     GetGCLOHCompactionMode()        const { return 0; }
+    int     GetGCBgcMarkThreads();
+    int     GetGCStringDedupStatsMB();
+    int     GetGCLOHThreshold();
+    int     GetGCLOHCompactionMode();
+    int     GetGCLOHCompactFragPercent();
+    int     GetGCLOHCompactMinFragMB();
+    int     GetGCLOHCompactLargestFreePercent();
+    int     GetGCSegmentStandbyMB();
+    int     GetGCSegmentStandbyMaxAge();
 
     bool    GetGCAllowVeryLargeObjects ()   const { return false; }
 
@@ -84,6 +84,51 @@ int EEConfig::GetGCconcurrent()
     return !g_pRhConfig->GetDisableBGC();
 }
 
+int EEConfig::GetGCBgcMarkThreads()
+{
+    return g_pRhConfig->GetGCBgcMarkThreads();
+}
+
+int EEConfig::GetGCStringDedupStatsMB()
+{
+    return g_pRhConfig->GetGCStringDedupStatsMB();
+}
+
+int EEConfig::GetGCLOHThreshold()
+{
+    return g_pRhConfig->GetGCLOHThreshold();
+}
+
+int EEConfig::GetGCLOHCompactionMode()
+{
+    return g_pRhConfig->GetGCLOHCompactionMode();
+}
+
+int EEConfig::GetGCLOHCompactFragPercent()
+{
+    return g_pRhConfig->GetGCLOHCompactFragPercent();
+}
+
+int EEConfig::GetGCLOHCompactMinFragMB()
+{
+    return g_pRhConfig->GetGCLOHCompactMinFragMB();
+}
+
+int EEConfig::GetGCLOHCompactLargestFreePercent()
+{
+    return g_pRhConfig->GetGCLOHCompactLargestFreePercent();
+}
+
+int EEConfig::GetGCSegmentStandbyMB()
+{
+    return g_pRhConfig->GetGCSegmentStandbyMB();
+}
+
+int EEConfig::GetGCSegmentStandbyMaxAge()
+{
+    return g_pRhConfig->GetGCSegmentStandbyMaxAge();
+}
+
 // A few settings are now backed by the cut-down version of Redhawk configuration values.
 static RhConfig g_sRhConfig;
 RhConfig * g_pRhConfig = &g_sRhConfig;
@@ -378,7 +423,7 @@ void RedhawkGCInterface::EnumGcRefsInRegionConservatively(PTR_RtuObjectRef pLowe
 }
 
 // static 
-void RedhawkGCInterface::EnumGcRef(PTR_RtuObjectRef pRef, GCRefKind kind, void * pfnEnumCallback, void * pvCallbackData)
+void RedhawkGCInterface::EnumGcRef(PTR_RtuObjectRef pRef, GCRefKind kind, void * pfnEnumCallback, void * pvCallbackData, bool fPinned)
 {
     ASSERT((GCRK_Object == kind) || (GCRK_Byref == kind));
 
@@ -389,6 +434,11 @@ void RedhawkGCInterface::EnumGcRef(PTR_RtuObjectRef pRef, GCRefKind kind, void *
         flags |= GC_CALL_INTERIOR;
     }
 
+    if (fPinned)
+    {
+        flags |= GC_CALL_PINNED;
+    }
+
     GcEnumObject((PTR_OBJECTREF)pRef, flags, (EnumGcRefCallbackFunc *)pfnEnumCallback, (EnumGcRefScanContext *)pvCallbackData);
 }
 
@@ -752,6 +802,39 @@ COOP_PINVOKE_HELPER(void, RhUnbox, (Object * pObj, void * pData, EEType * pUnbox
     }
 }
 
+// Unbox helpers for the value type shapes RhpNewBoxed1/2/4/8 handle (see RhGetRuntimeHelperForType and
+// RhUnboxAny in the classlib). The caller has already checked the type of pObj and the target is never a
+// Nullable, so all that's left is a fixed size copy.
+template <typename T>
+static inline void UnboxFixedSize(Object * pObj, void * pData, EEType * pUnboxToEEType)
+{
+    UNREFERENCED_PARAMETER(pUnboxToEEType);
+    ASSERT(pObj != NULL && !pObj->get_EEType()->HasReferenceFields());
+    ASSERT((pUnboxToEEType == NULL) || !pUnboxToEEType->IsNullable());
+
+    memcpy(pData, (UInt8*)pObj + sizeof(EEType*), sizeof(T));
+}
+
+COOP_PINVOKE_HELPER(void, RhpUnbox1, (Object * pObj, void * pData, EEType * pUnboxToEEType))
+{
+    UnboxFixedSize<UInt8>(pObj, pData, pUnboxToEEType);
+}
+
+COOP_PINVOKE_HELPER(void, RhpUnbox2, (Object * pObj, void * pData, EEType * pUnboxToEEType))
+{
+    UnboxFixedSize<UInt16>(pObj, pData, pUnboxToEEType);
+}
+
+COOP_PINVOKE_HELPER(void, RhpUnbox4, (Object * pObj, void * pData, EEType * pUnboxToEEType))
+{
+    UnboxFixedSize<UInt32>(pObj, pData, pUnboxToEEType);
+}
+
+COOP_PINVOKE_HELPER(void, RhpUnbox8, (Object * pObj, void * pData, EEType * pUnboxToEEType))
+{
+    UnboxFixedSize<UInt64>(pObj, pData, pUnboxToEEType);
+}
+
 #endif // !DACCESS_COMPILE
 
 //
@@ -873,6 +956,16 @@ bool GCToEEInterface::RefCountedHandleCallbacks(Object * pObject)
     return RestrictedCallouts::InvokeRefCountedHandleCallbacks(pObject);
 }
 
+bool GCToEEInterface::BeginRefCountedHandleScan()
+{
+    return RestrictedCallouts::BeginRefCountedHandleCallbacks();
+}
+
+void GCToEEInterface::EndRefCountedHandleScan(bool cookie)
+{
+    RestrictedCallouts::EndRefCountedHandleCallbacks(cookie);
+}
+
 void GCToEEInterface::SyncBlockCacheWeakPtrScan(HANDLESCANPROC /*scanProc*/, uintptr_t /*lp1*/, uintptr_t /*lp2*/)
 {
 }
@@ -93,6 +93,9 @@ extern void * g_pvHeapScanContext;
 
 typedef void * GcSegmentHandle;
 
+// The smallest size at which objects may be allocated on the LOH. The GC can be configured to use a higher
+// threshold at startup (see GCLOHThreshold) so the allocation helpers use this constant only to decide
+// whether a new object might need publishing to the background GC, which is a no-op for small objects.
 #define RH_LARGE_OBJECT_SIZE 85000
 
 // A 'clump' is defined as the size of memory covered by 1 byte in the card table.  These constants are 
@@ -142,7 +145,7 @@ public:
 
     static void WaitForGCCompletion();
 
-    static void EnumGcRef(PTR_RtuObjectRef pRef, GCRefKind kind, void * pfnEnumCallback, void * pvCallbackData);
+    static void EnumGcRef(PTR_RtuObjectRef pRef, GCRefKind kind, void * pfnEnumCallback, void * pvCallbackData, bool fPinned = false);
 
     static void BulkEnumGcObjRef(PTR_RtuObjectRef pRefs, UInt32 cRefs, void * pfnEnumCallback, void * pvCallbackData);
 
@@ -1350,6 +1350,212 @@ public:
 #endif // RHDUMP
 };
 
+//
+// CALLSITE TABLE INDEX
+//
+// The callsite table that follows the epilog table is normally decoded linearly from its first entry, which
+// makes each lookup linear with respect to the number of callsites in the method.  For methods with many
+// callsites, the table may be prefixed with a sparse index that lets the decoder binary-search to a block of
+// entries close to the code offset of interest and decode only the entries in that block:
+//
+// 10000000 00000000 { count } { entry0 } ... { entry(count-1) } -- SEEKABLE INDEX
+//
+//              -- the first two bytes look like a FORWARDER with a zero delta.  Such a forwarder is never
+//                 emitted otherwise and the index may only appear as the first entry of the table.
+//              -- { count } is a variable-length unsigned encoding of the number of index entries
+//              -- each entry is a pair of fixed-size UInt32s { codeOffset, tableOffset }, sorted by codeOffset:
+//                 codeOffset is the running callsite offset at the start of the block (i.e. the offset of the
+//                 last callsite of the previous block) and tableOffset is the byte offset of the first
+//                 encoding of the block, relative to the end of the index.  The first block starts at 
+//                 { 0, 0 } implicitly and is not described by an entry.
+//
+// Blocks always begin right after a SMALL or BIG encoding, never in the middle of a FORWARDER sequence, so the
+// decoder can resume its normal scan loop from any block with the codeOffset of the entry.
+//
+struct GCInfoCallsiteIndex
+{
+    enum EncodingConstants
+    {
+        EC_IndexByte0               = 0x80,
+        EC_IndexByte1               = 0x00,
+        EC_SizeOfEntry              = 2 * sizeof(UInt32),
+        EC_MinCallsitesForIndex     = 64,   // below this, the linear scan is as cheap as the binary search
+        EC_CallsitesPerBlock        = 16,
+    };
+
+    static bool HasIndex(PTR_UInt8 pbCallsiteTable)
+    {
+        return (pbCallsiteTable[0] == EC_IndexByte0) && (pbCallsiteTable[1] == EC_IndexByte1);
+    }
+
+    // Returns a pointer to the first compact encoding of the table, skipping the index if there is one.
+    static PTR_UInt8 SkipIndex(PTR_UInt8 pbCallsiteTable)
+    {
+        if (!HasIndex(pbCallsiteTable))
+            return pbCallsiteTable;
+
+        PTR_UInt8 pbDecode = pbCallsiteTable + 2;
+        UInt32 count = VarInt::ReadUnsigned(pbDecode);
+        return pbDecode + count * EC_SizeOfEntry;
+    }
+
+    // Positions the decoder at the block which contains the callsite for 'targetCodeOffset'.  On entry,
+    // *ppbCursor points at the start of the callsite table and *pCurCodeOffset is 0.  On exit, they describe
+    // a state of the linear scan loop from which the scan for 'targetCodeOffset' may continue.
+    static void Seek(UInt32 targetCodeOffset, PTR_UInt8 * ppbCursor, UInt32 * pCurCodeOffset)
+    {
+        PTR_UInt8 pbDecode = *ppbCursor;
+        if (!HasIndex(pbDecode))
+            return;
+
+        pbDecode += 2;
+        UInt32 count = VarInt::ReadUnsigned(pbDecode);
+        PTR_UInt8 pbEntries = pbDecode;
+        PTR_UInt8 pbTable = pbEntries + count * EC_SizeOfEntry;
+
+        // Find the number of blocks whose starting code offset is below the target.  The scan loop only 
+        // stops once it reaches or passes the target, so any of those blocks is a valid place to resume.
+        UInt32 lo = 0;
+        UInt32 hi = count;
+        while (lo < hi)
+        {
+            UInt32 mid = lo + (hi - lo) / 2;
+            if (GetEntryCodeOffset(pbEntries, mid) < targetCodeOffset)
+                lo = mid + 1;
+            else
+                hi = mid;
+        }
+
+        if (lo == 0)
+        {
+            *ppbCursor = pbTable;
+            *pCurCodeOffset = 0;
+        }
+        else
+        {
+            *ppbCursor = pbTable + GetEntryTableOffset(pbEntries, lo - 1);
+            *pCurCodeOffset = GetEntryCodeOffset(pbEntries, lo - 1);
+        }
+    }
+
+#ifndef DACCESS_COMPILE
+    //
+    // Copies the compact callsite table at 'pbTable' to 'pDest', prefixed with an index if the method has
+    // enough callsites to benefit from one.  If pDest is NULL, only the size of the encoding is computed.
+    // Returns the size of the encoding in bytes.
+    //
+    static size_t EncodeTable(UInt8 * pDest, UInt8 * pbTable, UInt8 * pbDeltaShortcutTable)
+    {
+        ASSERT(!HasIndex(pbTable));
+
+        UInt32 cCallsites = 0;
+        UInt8 * pbEnd = pbTable;
+        UInt32 delta;
+        EntryType type;
+        while ((type = ReadEntry(pbEnd, pbDeltaShortcutTable, &delta)) != ET_Terminator)
+        {
+            if (type == ET_Callsite)
+                cCallsites++;
+        }
+
+        size_t cbTable = (size_t)(pbEnd - pbTable);
+
+        if (cCallsites < EC_MinCallsitesForIndex)
+        {
+            if (pDest != NULL)
+                memcpy(pDest, pbTable, cbTable);
+            return cbTable;
+        }
+
+        UInt32 count = (cCallsites - 1) / EC_CallsitesPerBlock;
+        size_t cbIndex = 2 + VarInt::WriteUnsigned(NULL, count) + count * EC_SizeOfEntry;
+
+        if (pDest == NULL)
+            return cbIndex + cbTable;
+
+        *pDest++ = EC_IndexByte0;
+        *pDest++ = EC_IndexByte1;
+        pDest += VarInt::WriteUnsigned(pDest, count);
+
+        UInt8 * pbEntries = pDest;
+        UInt8 * pbCursor = pbTable;
+        UInt32 curCodeOffset = 0;
+        UInt32 iCallsite = 0;
+        UInt32 iEntry = 0;
+        while ((type = ReadEntry(pbCursor, pbDeltaShortcutTable, &delta)) != ET_Terminator)
+        {
+            curCodeOffset += delta;
+            if (type == ET_Forwarder)
+                continue;
+
+            iCallsite++;
+            if ((iCallsite % EC_CallsitesPerBlock) == 0 && iEntry < count)
+            {
+                UInt32 entry[2] = { curCodeOffset, (UInt32)(pbCursor - pbTable) };
+                memcpy(pbEntries + iEntry * EC_SizeOfEntry, entry, EC_SizeOfEntry);
+                iEntry++;
+            }
+        }
+        ASSERT(iEntry == count);
+
+        memcpy(pbEntries + count * EC_SizeOfEntry, pbTable, cbTable);
+        return cbIndex + cbTable;
+    }
+#endif // DACCESS_COMPILE
+
+private:
+    static UInt32 GetEntryCodeOffset(PTR_UInt8 pbEntries, UInt32 index)
+    {
+        return *dac_cast<PTR_UInt32>(pbEntries + index * EC_SizeOfEntry);
+    }
+
+    static UInt32 GetEntryTableOffset(PTR_UInt8 pbEntries, UInt32 index)
+    {
+        return *dac_cast<PTR_UInt32>(pbEntries + index * EC_SizeOfEntry + sizeof(UInt32));
+    }
+
+#ifndef DACCESS_COMPILE
+    enum EntryType
+    {
+        ET_Callsite,
+        ET_Forwarder,
+        ET_Terminator,
+    };
+
+    static EntryType ReadEntry(UInt8 * & pbCursor, UInt8 * pbDeltaShortcutTable, UInt32 * pDelta)
+    {
+        UInt8 b = *pbCursor++;
+        *pDelta = 0;
+
+        if ((b & 0x80) == 0)
+        {
+            // SMALL ENCODING
+            *pDelta = pbDeltaShortcutTable[b >> 3];
+            return ET_Callsite;
+        }
+
+        UInt8 lowBits = (b & 0x7F);
+        if (lowBits == 0)
+        {
+            // FORWARDER
+            *pDelta = VarInt::ReadUnsigned(pbCursor);
+            return ET_Forwarder;
+        }
+
+        if (lowBits == 0x7F)
+        {
+            // STRING TERMINATOR
+            return ET_Terminator;
+        }
+
+        // BIG ENCODING
+        *pDelta = lowBits;
+        VarInt::SkipUnsigned(pbCursor);
+        return ET_Callsite;
+    }
+#endif // DACCESS_COMPILE
+};
+
 
 
 /*****************************************************************************/
@@ -232,6 +232,24 @@ struct SimpleModuleHeader
 };
 #endif // !defined(RHDUMP) || !defined(RHDUMP_TARGET_NEUTRAL)
 
+// A frame of the shadow stack that code generated by the C++ backend keeps its GC references in. Each method that
+// uses GC references pushes one on entry and pops it on exit. The method reports its references through
+// m_pfnEnumRoots, so the runtime doesn't need to know the layout of m_pRoots (see Thread::GcScanRootsWorker).
+struct ShadowStackFrame
+{
+    enum RootFlags
+    {
+        RF_Interior = 0x1,      // the root is a byref, it can point into the middle of an object or outside the heap
+        RF_Pinned   = 0x2,      // the root is a pinned local, the object must not move
+    };
+
+    typedef void ReportRootFunc(void ** ppRoot, UInt32 flags, void * pContext);
+
+    ShadowStackFrame *  m_pPrev;
+    void *              m_pRoots;
+    void                (*m_pfnEnumRoots)(void * pRoots, ReportRootFunc * pfnReport, void * pContext);
+};
+
 
 class GcPollInfo
 {
@@ -45,8 +45,10 @@ Module::Module(ModuleHeader *pModuleHeader) :
     m_pNext(),
     m_pbDeltaShortcutTable(NULL),
     m_pModuleHeader(pModuleHeader),
+    m_pSimpleModuleHeader(NULL),
     m_MethodList(),
-    m_fFinalizerInitComplete(false)
+    m_fFinalizerInitComplete(false),
+    m_pClasslibModule(NULL)
 {
 }
 
@@ -62,7 +64,7 @@ Module * Module::Create(SimpleModuleHeader *pModuleHeader)
     pNewModule->m_FrozenSegment = nullptr;
     pNewModule->m_pStaticsGCInfo = dac_cast<PTR_StaticGcDesc>(pModuleHeader->m_pStaticsGcInfo);
     pNewModule->m_pStaticsGCDataSection = dac_cast<PTR_UInt8>((UInt8*)pModuleHeader->m_pStaticsGcDataSection);
-    pNewModule->m_pThreadStaticsGCInfo = nullptr;
+    pNewModule->m_pThreadStaticsGCInfo = dac_cast<PTR_StaticGcDesc>(pModuleHeader->m_pThreadStaticsGcInfo);
 
     pNewModule->m_hOsModuleHandle = PalGetModuleHandleFromPointer(pModuleHeader);
 
@@ -430,6 +432,21 @@ void Module::EnumStaticGCRefs(void * pfnCallback, void * pvCallbackData)
     // Thread local statics.
     if (m_pThreadStaticsGCInfo != NULL)
     {
+#ifndef DACCESS_COMPILE
+        if (m_pSimpleModuleHeader != NULL)
+        {
+            // The thread statics of a simple module live in a thread local block of the C++ backend's code
+            FOREACH_THREAD(pThread)
+            {
+                PTR_UInt8 pbThreadStatics = pThread->GetSimpleModuleThreadStatics();
+                if (pbThreadStatics != NULL)
+                    EnumStaticGCRefsBlock(pfnCallback, pvCallbackData, m_pThreadStaticsGCInfo, pbThreadStatics);
+            }
+            END_FOREACH_THREAD
+            return;
+        }
+#endif // !DACCESS_COMPILE
+
         FOREACH_THREAD(pThread)
         {
             // To calculate the address of the data for each thread's TLS fields we need two values:
@@ -730,18 +747,29 @@ VSDInterfaceTargetInfo * Module::GetInterfaceTargetInfoArray()
 // handling and fail fast.
 Module * Module::GetClasslibModule()
 {
+    // The answer never changes (the classlib module outlives every module bound against it), and this is on
+    // the path of every exception throw, so it's only looked up once. Racing threads store the same value.
+    Module * pClasslibModule = m_pClasslibModule;
+    if (pClasslibModule != NULL)
+        return pClasslibModule;
+
     // Every non-classlib module has a RVA to a IAT entry for System.Object in the classlib module it 
     // was compiled against. Therefore, we can use that address to locate the Module for the classlib module.
     // If this is a classlib module, then we can just return it.
     if (IsClasslibModule())
     {
-        return this;
+        pClasslibModule = this;
     }
+    else
+    {
+        void ** ppSystemObjectEEType = (void**)(m_pModuleHeader->RegionPtr[ModuleHeader::IAT_REGION] +
+                                                m_pModuleHeader->RraSystemObjectEEType);
 
-    void ** ppSystemObjectEEType = (void**)(m_pModuleHeader->RegionPtr[ModuleHeader::IAT_REGION] +
-                                            m_pModuleHeader->RraSystemObjectEEType);
+        pClasslibModule = GetRuntimeInstance()->FindModuleByReadOnlyDataAddress(*ppSystemObjectEEType);
+    }
 
-    return GetRuntimeInstance()->FindModuleByReadOnlyDataAddress(*ppSystemObjectEEType);
+    m_pClasslibModule = pClasslibModule;
+    return pClasslibModule;
 }
 
 bool Module::IsClasslibModule()
@@ -190,5 +190,7 @@ private:
     PTR_StaticGcDesc            m_pStaticsGCInfo;
     PTR_StaticGcDesc            m_pThreadStaticsGCInfo;
     PTR_UInt8                   m_pStaticsGCDataSection;
+
+    PTR_Module                  m_pClasslibModule;          // cached by GetClasslibModule
 };
 
@@ -110,6 +110,45 @@ COOP_PINVOKE_HELPER(Object *, RhpNewFast, (EEType* pEEType))
     return pObject;
 }
 
+//
+// Fused allocate-and-box helpers for value types without GC references whose field data is 1, 2, 4 or 8
+// bytes. RhBox in the classlib uses them for primitives and enums and RhGetRuntimeHelperForType hands them
+// out for any such value type. The value is read before allocating since a GC triggered by the allocation
+// could move the object pData points into.
+//
+template <typename T>
+static inline Object * NewBoxed(EEType * pEEType, void * pData)
+{
+    ASSERT(pEEType->get_IsValueType() && !pEEType->HasReferenceFields());
+
+    T value;
+    memcpy(&value, pData, sizeof(T));
+
+    Object * pObject = RhpNewFast(pEEType);
+    memcpy((UInt8 *)pObject + sizeof(EEType*), &value, sizeof(T));
+    return pObject;
+}
+
+COOP_PINVOKE_HELPER(Object *, RhpNewBoxed1, (EEType * pEEType, void * pData))
+{
+    return NewBoxed<UInt8>(pEEType, pData);
+}
+
+COOP_PINVOKE_HELPER(Object *, RhpNewBoxed2, (EEType * pEEType, void * pData))
+{
+    return NewBoxed<UInt16>(pEEType, pData);
+}
+
+COOP_PINVOKE_HELPER(Object *, RhpNewBoxed4, (EEType * pEEType, void * pData))
+{
+    return NewBoxed<UInt32>(pEEType, pData);
+}
+
+COOP_PINVOKE_HELPER(Object *, RhpNewBoxed8, (EEType * pEEType, void * pData))
+{
+    return NewBoxed<UInt64>(pEEType, pData);
+}
+
 #define GC_ALLOC_FINALIZE 0x1 // TODO: Defined in gc.h
 
 COOP_PINVOKE_HELPER(Object *, RhpNewFinalizable, (EEType* pEEType))
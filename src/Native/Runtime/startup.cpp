@@ -45,6 +45,7 @@ UInt32 _fls_index = FLS_OUT_OF_INDEXES;
 Int32 __stdcall RhpVectoredExceptionHandler(PEXCEPTION_POINTERS pExPtrs);
 void __stdcall FiberDetach(void* lpFlsData);
 void CheckForPalFallback();
+void InitializeMemoryHelpers();
 
 extern RhConfig * g_pRhConfig;
 
@@ -52,6 +53,8 @@ bool InitDLL(HANDLE hPalInstance)
 {
     CheckForPalFallback();
 
+    InitializeMemoryHelpers();
+
 #ifdef FEATURE_VSD
     //
     // init VSD
@@ -282,6 +285,15 @@ COOP_PINVOKE_HELPER(UInt32_BOOL, RhpEnableConservativeStackReporting, ())
     return UInt32_TRUE;
 }
 
+COOP_PINVOKE_HELPER(UInt32_BOOL, RhpEnableShadowStackReporting, ())
+{
+    RuntimeInstance * pInstance = GetRuntimeInstance();
+    if (!pInstance->EnableShadowStackReporting())
+        return UInt32_FALSE;
+
+    return UInt32_TRUE;
+}
+
 #endif // !DACCESS_COMPILE
 
 GPTR_IMPL_INIT(RuntimeInstance, g_pTheRuntimeInstance, NULL);
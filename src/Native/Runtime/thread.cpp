@@ -26,8 +26,17 @@
 #include "stressLog.h"
 #include "RhConfig.h"
 
+#include <setjmp.h>
+
 #ifndef DACCESS_COMPILE
 
+// Top of the shadow stack of the code generated by the C++ backend, a ShadowStackFrame (see GcScanRootsWorker)
+EXTERN_C DECLSPEC_THREAD void * tls_pShadowStackTop = NULL;
+
+// The thread statics that hold GC references of the module generated by the C++ backend. The generated code points
+// this at its thread local block on first access, so it stays NULL on threads that never touch them.
+EXTERN_C DECLSPEC_THREAD void * tls_pSimpleModuleThreadStatics = NULL;
+
 #ifdef _MSC_VER
 extern "C" void _ReadWriteBarrier(void);
 #pragma intrinsic(_ReadWriteBarrier)
@@ -285,6 +294,10 @@ void Thread::Construct()
     m_numDynamicTypesTlsCells = 0;
     m_pDynamicTypesTlsCells = NULL;
 
+    // Construct runs on the thread itself, so these are its own copies
+    m_ppShadowStackTop = &tls_pShadowStackTop;
+    m_ppSimpleModuleThreadStatics = &tls_pSimpleModuleThreadStatics;
+
     // NOTE: We do not explicitly defer to the GC implementation to initialize the alloc_context.  The 
     // alloc_context will be initialized to 0 via the static initialization of tls_CurrentThread. If the
     // alloc_context ever needs different initialization, a matching change to the tls_CurrentThread 
@@ -448,6 +461,24 @@ bool Thread::GcScanRoots(GcScanRootsCallbackFunc * pfnEnumCallback, void * token
 }
 #endif //DACCESS_COMPILE
 
+#ifndef DACCESS_COMPILE
+struct ShadowStackScanContext
+{
+    void *  m_pfnEnumCallback;
+    void *  m_pvCallbackData;
+};
+
+static void ReportShadowStackRoot(void ** ppRoot, UInt32 flags, void * pContext)
+{
+    ShadowStackScanContext * pScanContext = (ShadowStackScanContext *)pContext;
+    RedhawkGCInterface::EnumGcRef((PTR_RtuObjectRef)ppRoot,
+                                  (flags & ShadowStackFrame::RF_Interior) ? GCRK_Byref : GCRK_Object,
+                                  pScanContext->m_pfnEnumCallback,
+                                  pScanContext->m_pvCallbackData,
+                                  (flags & ShadowStackFrame::RF_Pinned) != 0);
+}
+#endif // !DACCESS_COMPILE
+
 void Thread::GcScanRootsWorker(void * pfnEnumCallback, void * pvCallbackData, StackFrameIterator & frameIterator)
 {
     PTR_RtuObjectRef pHijackedReturnValue    = NULL;
@@ -459,6 +490,18 @@ void Thread::GcScanRootsWorker(void * pfnEnumCallback, void * pvCallbackData, St
     }
 
 #ifndef DACCESS_COMPILE
+    if (GetRuntimeInstance()->IsShadowStackReportingEnabled())
+    {
+        // Code generated by the C++ backend keeps every GC reference that's live across a call in its shadow
+        // stack frame, so those frames are all there is to report. They are reported precisely, so the GC is
+        // free to move the objects.
+        ShadowStackScanContext scanContext = { pfnEnumCallback, pvCallbackData };
+        for (ShadowStackFrame * pFrame = (ShadowStackFrame *)*m_ppShadowStackTop; pFrame != NULL; pFrame = pFrame->m_pPrev)
+        {
+            pFrame->m_pfnEnumRoots(pFrame->m_pRoots, &ReportShadowStackRoot, &scanContext);
+        }
+    }
+    else
     if (GetRuntimeInstance()->IsConservativeStackReportingEnabled())
     {
         if (frameIterator.IsValid())
@@ -1010,6 +1053,13 @@ PTR_UInt8 Thread::GetThreadLocalStorage(UInt32 uTlsIndex, UInt32 uTlsStartOffset
 #endif
 }
 
+#ifndef DACCESS_COMPILE
+PTR_UInt8 Thread::GetSimpleModuleThreadStatics()
+{
+    return (PTR_UInt8)*m_ppSimpleModuleThreadStatics;
+}
+#endif // !DACCESS_COMPILE
+
 PTR_UInt8 Thread::GetThreadLocalStorageForDynamicType(UInt32 uTlsTypeOffset)
 {
     // Note: When called from GC root enumeration, no changes can be made by the AllocateThreadLocalStorageForDynamicType to 
@@ -1068,6 +1118,24 @@ EXTERN_C REDHAWK_API UInt32 __cdecl RhCompatibleReentrantWaitAny(UInt32_BOOL ale
     return PalCompatibleWaitAny(alertable, timeout, count, pHandles, /*allowReentrantWait:*/ TRUE);
 }
 
+// Blocks while *pAddress is equal to comparand, until RhWakeByAddress is called for the address or the timeout
+// expires. Returns FALSE on timeout. Can return early, so callers have to check the value again. The memory must
+// not move while waiting, managed callers pin it. This must be called via p/invoke rather than RuntimeImport
+// since it blocks.
+EXTERN_C REDHAWK_API UInt32_BOOL __cdecl RhWaitOnAddress(volatile Int32 * pAddress, Int32 comparand, Int32 millisecondsTimeout)
+{
+    ASSERT(millisecondsTimeout >= -1);
+    ASSERT(!ThreadStore::GetCurrentThread()->PreemptiveGCDisabled());
+
+    return PalWaitOnAddress(pAddress, comparand, (UInt32)millisecondsTimeout);
+}
+
+// Wakes one or all of the threads blocked in RhWaitOnAddress on the address.
+COOP_PINVOKE_HELPER(void, RhWakeByAddress, (volatile Int32 * pAddress, Boolean wakeAll))
+{
+    PalWakeByAddress(pAddress, wakeAll ? TRUE : FALSE);
+}
+
 
 EXTERN_C volatile UInt32 RhpTrapThreads;
 
@@ -1148,4 +1216,60 @@ void Thread::ReversePInvokeReturn(ReversePInvokeFrame * pFrame)
     }
 }
 
+// Calls pfnCallback in preemptive mode on behalf of native code running in cooperative mode that has no transition
+// frame of its own, like the C++ backend's bootstrap code. The GC only reports such code conservatively or through
+// its shadow stack, so the frame just has to start the scan of the stack below the caller's frames, with the callee
+// saved registers spilled where the scan sees them. pfnCallback must not touch the GC heap.
+void Thread::CallPreemptive(void (*pfnCallback)(void *), void * pContext)
+{
+    ASSERT(ThreadStore::GetCurrentThread() == this);
+    ASSERT(IsCurrentThreadInCooperativeMode());
+    ASSERT(GetRuntimeInstance()->IsConservativeStackReportingEnabled() ||
+           GetRuntimeInstance()->IsShadowStackReportingEnabled());
+
+    jmp_buf calleeSavedRegisters;
+    setjmp(calleeSavedRegisters);
+
+    UIntNative frameStorage[PInvokeTransitionFrame_MAX_SIZE / sizeof(UIntNative)];
+    memset(frameStorage, 0, sizeof(frameStorage));
+
+    UIntNative stackPointer = (UIntNative)&calleeSavedRegisters;
+    if ((UIntNative)frameStorage < stackPointer)
+        stackPointer = (UIntNative)frameStorage;
+
+    PInvokeTransitionFrame * pFrame = (PInvokeTransitionFrame *)frameStorage;
+    pFrame->m_RIP = (TgtPTR_Void)pfnCallback;    // anything non-null, it's never unwound
+    pFrame->m_pThread = this;
+#ifdef _TARGET_ARM_
+    pFrame->m_dwFlags = PTFF_SAVE_SP;
+#else
+    pFrame->m_dwFlags = PTFF_SAVE_RSP;
+#endif
+    pFrame->m_PreservedRegs[0] = stackPointer;
+
+    m_pTransitionFrame = pFrame;
+    if (RhpTrapThreads != 0)
+    {
+        RhpPInvokeWaitEx(this);
+    }
+
+    pfnCallback(pContext);
+
+    for (;;)
+    {
+        m_pTransitionFrame = NULL;
+        if (RhpTrapThreads == 0)
+            break;
+
+        m_pTransitionFrame = pFrame;
+        RhpPInvokeReturnWaitEx(this);
+    }
+}
+
+// See Thread::CallPreemptive.
+COOP_PINVOKE_HELPER(void, RhpCallPreemptive, (void (*pfnCallback)(void *), void * pContext))
+{
+    ThreadStore::GetCurrentThread()->CallPreemptive(pfnCallback, pContext);
+}
+
 #endif // !DACCESS_COMPILE
@@ -91,6 +91,11 @@ struct ThreadBuffer
     // Thread Statics Storage for dynamic types
     UInt32          m_numDynamicTypesTlsCells;
     PTR_UInt8*      m_pDynamicTypesTlsCells;
+
+    // This thread's copies of tls_pShadowStackTop and tls_pSimpleModuleThreadStatics, for code generated by the
+    // C++ backend
+    void **         m_ppShadowStackTop;
+    void **         m_ppSimpleModuleThreadStatics;
 };
 
 struct ReversePInvokeFrame
@@ -193,6 +198,9 @@ public:
     PTR_UInt8           AllocateThreadLocalStorageForDynamicType(UInt32 uTlsTypeOffset, UInt32 tlsStorageSize, UInt32 numTlsCells);
     PTR_UInt8           GetThreadLocalStorageForDynamicType(UInt32 uTlsTypeOffset);
     PTR_UInt8           GetThreadLocalStorage(UInt32 uTlsIndex, UInt32 uTlsStartOffset);
+#ifndef DACCESS_COMPILE
+    PTR_UInt8           GetSimpleModuleThreadStatics();
+#endif
     PTR_UInt8           GetTEB();
 
     void                PushExInfo(ExInfo * pExInfo);
@@ -249,6 +257,8 @@ public:
     bool TryFastReversePInvoke(ReversePInvokeFrame * pFrame);
     void ReversePInvoke(ReversePInvokeFrame * pFrame);
     void ReversePInvokeReturn(ReversePInvokeFrame * pFrame);
+
+    void CallPreemptive(void (*pfnCallback)(void *), void * pContext);
 };
 
 #ifndef GCENV_INCLUDED
@@ -34,6 +34,12 @@
 #include <fcntl.h>
 #include <sys/time.h>
 
+#ifdef __linux__
+#include <limits.h>
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#endif // __linux__
+
 #if !HAVE_SYSCONF && !HAVE_SYSCTL
 #error Neither sysconf nor sysctl is present on the current system
 #endif
@@ -231,6 +237,12 @@ public:
             }
 
         }
+
+        if ((st == 0) && !m_manualReset)
+        {
+            // Auto reset event releases only one waiter
+            m_state = false;
+        }
         pthread_mutex_unlock(&m_mutex);
 
         uint32_t waitStatus;
@@ -386,6 +398,123 @@ REDHAWK_PALEXPORT void REDHAWK_PALAPI PalSleep(uint32_t milliseconds)
 #endif // HAVE_CLOCK_MONOTONIC
 }
 
+#ifdef __linux__
+
+REDHAWK_PALEXPORT UInt32_BOOL REDHAWK_PALAPI PalWaitOnAddress(volatile Int32 * pAddress, Int32 comparand, uint32_t milliseconds)
+{
+    timespec timeout;
+    timespec* pTimeout = NULL;
+
+    if (milliseconds != INFINITE)
+    {
+        timeout.tv_sec = milliseconds / tccSecondsToMilliSeconds;
+        timeout.tv_nsec = (milliseconds % tccSecondsToMilliSeconds) * tccMilliSecondsToNanoSeconds;
+        pTimeout = &timeout;
+    }
+
+    // EAGAIN (the value already changed) and EINTR count as being woken, the caller checks the value anyway.
+    if (syscall(SYS_futex, pAddress, FUTEX_WAIT_PRIVATE, comparand, pTimeout, NULL, 0) == 0)
+        return TRUE;
+
+    return (errno != ETIMEDOUT);
+}
+
+REDHAWK_PALEXPORT void REDHAWK_PALAPI PalWakeByAddress(volatile Int32 * pAddress, UInt32_BOOL wakeAll)
+{
+    syscall(SYS_futex, pAddress, FUTEX_WAKE_PRIVATE, wakeAll ? INT_MAX : 1, NULL, NULL, 0);
+}
+
+#else // __linux__
+
+// Without futexes, waiters sleep on a condition variable picked by hashing the address. The value is compared
+// and the waiter woken under the same mutex, so a wake can't slip in between the two.
+struct AddressWaitBucket
+{
+    pthread_mutex_t m_mutex;
+    pthread_cond_t m_condition;
+};
+
+static const int s_cAddressWaitBuckets = 64;
+static AddressWaitBucket s_addressWaitBuckets[s_cAddressWaitBuckets];
+static pthread_once_t s_addressWaitBucketsOnce = PTHREAD_ONCE_INIT;
+
+static void InitializeAddressWaitBuckets()
+{
+    for (int i = 0; i < s_cAddressWaitBuckets; i++)
+    {
+        int st = pthread_mutex_init(&s_addressWaitBuckets[i].m_mutex, NULL);
+        ASSERT(st == 0);
+
+        pthread_condattr_t attrs;
+        st = pthread_condattr_init(&attrs);
+        ASSERT(st == 0);
+
+#if HAVE_CLOCK_MONOTONIC
+        // Ensure that the pthread_cond_timedwait will use CLOCK_MONOTONIC
+        st = pthread_condattr_setclock(&attrs, CLOCK_MONOTONIC);
+        ASSERT(st == 0);
+#endif // HAVE_CLOCK_MONOTONIC
+
+        st = pthread_cond_init(&s_addressWaitBuckets[i].m_condition, &attrs);
+        ASSERT(st == 0);
+
+        st = pthread_condattr_destroy(&attrs);
+        ASSERT(st == 0);
+    }
+}
+
+static AddressWaitBucket* GetAddressWaitBucket(volatile Int32 * pAddress)
+{
+    pthread_once(&s_addressWaitBucketsOnce, InitializeAddressWaitBuckets);
+    return &s_addressWaitBuckets[((size_t)pAddress / sizeof(Int32)) % s_cAddressWaitBuckets];
+}
+
+REDHAWK_PALEXPORT UInt32_BOOL REDHAWK_PALAPI PalWaitOnAddress(volatile Int32 * pAddress, Int32 comparand, uint32_t milliseconds)
+{
+    AddressWaitBucket* pBucket = GetAddressWaitBucket(pAddress);
+    int st = 0;
+
+    pthread_mutex_lock(&pBucket->m_mutex);
+    if (*pAddress == comparand)
+    {
+        if (milliseconds == INFINITE)
+        {
+            st = pthread_cond_wait(&pBucket->m_condition, &pBucket->m_mutex);
+        }
+        else
+        {
+            timespec endTime;
+#if HAVE_CLOCK_MONOTONIC
+            clock_gettime(CLOCK_MONOTONIC, &endTime);
+#else // HAVE_CLOCK_MONOTONIC
+            // Same limitation as UnixEvent::Wait, changing the time of day changes the timeout
+            timeval now;
+            gettimeofday(&now, NULL);
+            endTime.tv_sec = now.tv_sec;
+            endTime.tv_nsec = now.tv_usec * tccMicroSecondsToNanoSeconds;
+#endif // HAVE_CLOCK_MONOTONIC
+            TimeSpecAdd(&endTime, milliseconds);
+
+            st = pthread_cond_timedwait(&pBucket->m_condition, &pBucket->m_mutex, &endTime);
+        }
+    }
+    pthread_mutex_unlock(&pBucket->m_mutex);
+
+    return (st != ETIMEDOUT);
+}
+
+REDHAWK_PALEXPORT void REDHAWK_PALAPI PalWakeByAddress(volatile Int32 * pAddress, UInt32_BOOL wakeAll)
+{
+    AddressWaitBucket* pBucket = GetAddressWaitBucket(pAddress);
+
+    // Other addresses share the bucket, so all its waiters are woken; they check their values again.
+    pthread_mutex_lock(&pBucket->m_mutex);
+    pthread_cond_broadcast(&pBucket->m_condition);
+    pthread_mutex_unlock(&pBucket->m_mutex);
+}
+
+#endif // __linux__
+
 REDHAWK_PALEXPORT UInt32_BOOL REDHAWK_PALAPI __stdcall PalSwitchToThread()
 {
     // sched_yield yields to another thread in the current process. This implementation
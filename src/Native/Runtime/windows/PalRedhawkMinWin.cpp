@@ -172,6 +172,22 @@ REDHAWK_PALEXPORT UInt32 REDHAWK_PALAPI PalCompatibleWaitAny(UInt32_BOOL alertab
     }
 }
 
+REDHAWK_PALEXPORT UInt32_BOOL REDHAWK_PALAPI PalWaitOnAddress(volatile Int32 * pAddress, Int32 comparand, UInt32 milliseconds)
+{
+    if (WaitOnAddress(pAddress, &comparand, sizeof(Int32), milliseconds))
+        return TRUE;
+
+    return (GetLastError() != ERROR_TIMEOUT);
+}
+
+REDHAWK_PALEXPORT void REDHAWK_PALAPI PalWakeByAddress(volatile Int32 * pAddress, UInt32_BOOL wakeAll)
+{
+    if (wakeAll)
+        WakeByAddressAll((void *)pAddress);
+    else
+        WakeByAddressSingle((void *)pAddress);
+}
+
 REDHAWK_PALEXPORT void REDHAWK_PALAPI PalSleep(UInt32 milliseconds)
 {
     return Sleep(milliseconds);
@@ -1205,6 +1221,12 @@ bool PalQueryProcessorTopology()
     return !fError;
 }
 
+// Cache size found by PalQueryProcessorTopology, for the parts of the runtime that start before the GC does.
+REDHAWK_PALEXPORT size_t REDHAWK_PALAPI PalGetLargestOnDieCacheSize(UInt32_BOOL bTrueSize)
+{
+    return bTrueSize ? g_cbLargestOnDieCache : g_cbLargestOnDieCacheAdjusted;
+}
+
 void PalDebugBreak()
 {
     __debugbreak();
@@ -63,6 +63,11 @@ public:
     // Promote refcounted handle callback
     static bool RefCountedHandleCallbacks(Object * pObject);
 
+    // Bracket the RefCountedHandleCallbacks calls of a scan of the refcounted handles. The result of
+    // BeginRefCountedHandleScan is passed back to EndRefCountedHandleScan.
+    static bool BeginRefCountedHandleScan();
+    static void EndRefCountedHandleScan(bool cookie);
+
     // Sync block cache management
     static void SyncBlockCacheWeakPtrScan(HANDLESCANPROC scanProc, uintptr_t lp1, uintptr_t lp2);
     static void SyncBlockCacheDemote(int max_gen);
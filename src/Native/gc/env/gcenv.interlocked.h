@@ -73,6 +73,15 @@ public:
     template<typename T>
     static T ExchangeAdd(T volatile *addend, T value);
 
+    // Perform an atomic addition of two pointer-sized values and return the original value of the addend.
+    // Parameters:
+    //  addend - variable to be added to
+    //  value  - value to add
+    // Return:
+    //  The previous value of the addend
+    template<typename T>
+    static T ExchangeAddPtr(T volatile *addend, T value);
+
     // Performs an atomic compare-and-exchange operation on the specified values. 
     // Parameters:
     //  destination - value to be exchanged
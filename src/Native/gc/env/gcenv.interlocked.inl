@@ -97,6 +97,27 @@ __forceinline T Interlocked::ExchangeAdd(T volatile *addend, T value)
 #endif
 }
 
+// Perform an atomic addition of two pointer-sized values and return the original value of the addend.
+// Parameters:
+//  addend - variable to be added to
+//  value  - value to add
+// Return:
+//  The previous value of the addend
+template <typename T>
+__forceinline T Interlocked::ExchangeAddPtr(T volatile *addend, T value)
+{
+#ifdef _MSC_VER
+    static_assert(sizeof(void*) == sizeof(T), "Size of void* must be the same as size of T");
+#ifdef BIT64
+    return (T)_InterlockedExchangeAdd64((__int64 volatile *)addend, (__int64)value);
+#else
+    return (T)_InterlockedExchangeAdd((long volatile *)addend, (long)value);
+#endif
+#else
+    return __sync_fetch_and_add(addend, value);
+#endif
+}
+
 // Perform an atomic AND operation on the specified values values
 // Parameters:
 //  destination - the first operand and the destination
@@ -93,6 +93,11 @@ public:
         return (m_flags & MTFlag_IsArray) != 0;
     }
 
+    bool IsString()
+    {
+        return (m_componentSize == sizeof(uint16_t)) && !IsArray();
+    }
+
     MethodTable * GetParent()
     {
         _ASSERTE(!IsArray());
@@ -64,6 +64,27 @@ inline BOOL ShouldTrackMovementForProfilerOrEtw()
 #define MARK_STACK_INITIAL_LENGTH 128
 #endif // BIT64
 
+#ifdef BGC_PARALLEL_MARK
+#define MAX_BGC_MARK_HELPERS 64
+#define BGC_MARK_HELPER_STACK_LENGTH (16*1024)
+#define BGC_MARK_QUEUE_LENGTH (4*1024)
+// max number of entries moved to or from the shared queue at a time.
+#define BGC_MARK_SHARE_CHUNK 32
+#endif //BGC_PARALLEL_MARK
+
+#ifdef BGC_STRING_DEDUP_STATS
+// number of string hashes each heap remembers per BGC, must be a power of 2.
+#define STRING_DEDUP_TABLE_LENGTH (64*1024)
+#endif //BGC_STRING_DEDUP_STATS
+
+// Address space reserved for each heap's mark stack up front so marking can grow
+// the stack in place instead of overflowing.
+#ifdef BIT64
+#define MARK_STACK_RESERVE_SIZE (256*1024*1024)
+#else
+#define MARK_STACK_RESERVE_SIZE (16*1024*1024)
+#endif // BIT64
+
 #define LOH_PIN_QUEUE_LENGTH 100
 #define LOH_PIN_DECAY 10
 
@@ -2042,7 +2063,7 @@ uint8_t* gc_heap::pad_for_alignment_large (uint8_t* newAlloc, int requiredAlignm
 #define CLR_SIZE ((size_t)(8*1024))
 #endif //SERVER_GC
 
-#define END_SPACE_AFTER_GC (LARGE_OBJECT_SIZE + MAX_STRUCTALIGN)
+#define END_SPACE_AFTER_GC (gc_heap::loh_size_threshold + MAX_STRUCTALIGN)
 
 #ifdef BACKGROUND_GC
 #define SEGMENT_INITIAL_COMMIT (2*OS_PAGE_SIZE)
@@ -2260,6 +2281,7 @@ size_t      gc_heap::g_bpromoted;
 
 size_t      gc_heap::reserved_memory = 0;
 size_t      gc_heap::reserved_memory_limit = 0;
+size_t      gc_heap::loh_size_threshold = LARGE_OBJECT_SIZE;
 BOOL        gc_heap::g_low_memory_status;
 
 #ifndef DACCESS_COMPILE
@@ -2326,6 +2348,10 @@ size_t      gc_heap::ephemeral_fgc_counts[max_generation];
 
 BOOL        gc_heap::alloc_wait_event_p = FALSE;
 
+#ifdef BGC_STRING_DEDUP_STATS
+size_t      gc_heap::string_dedup_budget = 0;
+#endif //BGC_STRING_DEDUP_STATS
+
 #if defined (DACCESS_COMPILE) && !defined (MULTIPLE_HEAPS)
 SVAL_IMPL_NS_INIT(gc_heap::c_gc_state, WKS, gc_heap, current_c_gc_state, c_gc_state_free);
 #else
@@ -2421,6 +2447,12 @@ size_t      gc_heap::mark_stack_array_length = 0;
 
 mark*       gc_heap::mark_stack_array = 0;
 
+size_t      gc_heap::mark_stack_array_reserved_length = 0;
+
+size_t      gc_heap::mark_stack_overflow_count = 0;
+
+size_t      gc_heap::mark_overflow_rescan_count = 0;
+
 BOOL        gc_heap::verify_pinned_queue_p = FALSE;
 
 uint8_t*    gc_heap::oldest_pinned_plug = 0;
@@ -2491,6 +2523,48 @@ size_t      gc_heap::c_mark_list_length = 0;
 
 size_t      gc_heap::c_mark_list_index = 0;
 
+#ifdef BGC_PARALLEL_MARK
+int         gc_heap::n_bgc_mark_helpers = 0;
+
+int         gc_heap::n_bgc_mark_helpers_created = 0;
+
+bgc_mark_helper* gc_heap::bgc_mark_helpers = 0;
+
+CLREvent    gc_heap::bgc_mark_helpers_start_event;
+
+CLREvent    gc_heap::bgc_mark_helper_created_event;
+
+GCSpinLock  gc_heap::bgc_mark_queue_lock;
+
+uint8_t**   gc_heap::bgc_mark_queue = 0;
+
+VOLATILE(size_t) gc_heap::bgc_mark_queue_count = 0;
+
+VOLATILE(BOOL) gc_heap::bgc_parallel_mark_p = FALSE;
+
+size_t      gc_heap::bgc_parallel_mark_session = 0;
+
+int         gc_heap::bgc_mark_helpers_joined = 0;
+
+VOLATILE(int) gc_heap::bgc_mark_helpers_idle = 0;
+#endif //BGC_PARALLEL_MARK
+
+#ifdef BGC_STRING_DEDUP_STATS
+size_t      gc_heap::string_dedup_budget_left = 0;
+
+uint64_t*   gc_heap::string_dedup_table = 0;
+
+size_t      gc_heap::string_dedup_table_used = 0;
+
+string_dedup_stats gc_heap::string_dedup_current;
+
+string_dedup_stats gc_heap::string_dedup_last;
+
+#ifdef BGC_PARALLEL_MARK
+GCSpinLock  gc_heap::string_dedup_lock;
+#endif //BGC_PARALLEL_MARK
+#endif //BGC_STRING_DEDUP_STATS
+
 gc_history_per_heap gc_heap::bgc_data_per_heap;
 
 BOOL    gc_heap::bgc_thread_running;
@@ -2577,6 +2651,15 @@ GCSpinLock gc_heap::gc_lock;
 
 size_t gc_heap::eph_gen_starts_size = 0;
 heap_segment* gc_heap::segment_standby_list;
+GCSpinLock    gc_heap::segment_standby_lock;
+size_t        gc_heap::segment_standby_size = 0;
+size_t        gc_heap::segment_standby_limit = 0;
+size_t        gc_heap::segment_standby_max_age = 0;
+size_t        gc_heap::segment_standby_hits = 0;
+size_t        gc_heap::segment_standby_misses = 0;
+size_t        gc_heap::segment_standby_released = 0;
+memory_pressure_counter gc_heap::memory_pressure_counters[max_memory_pressure_counters];
+size_t        gc_heap::memory_pressure_at_gc[max_generation + 1];
 size_t        gc_heap::last_gc_index = 0;
 size_t        gc_heap::min_segment_size = 0;
 
@@ -2589,6 +2672,9 @@ size_t gc_heap::compact_or_sweep_gcs[2];
 #ifdef FEATURE_LOH_COMPACTION
 BOOL                   gc_heap::loh_compaction_always_p = FALSE;
 gc_loh_compaction_mode gc_heap::loh_compaction_mode = loh_compaction_default;
+uint32_t               gc_heap::loh_compaction_frag_pct = 0;
+size_t                 gc_heap::loh_compaction_min_frag = 0;
+uint32_t               gc_heap::loh_compaction_largest_free_pct = 0;
 int                    gc_heap::loh_pinned_queue_decay = LOH_PIN_DECAY;
 
 #endif //FEATURE_LOH_COMPACTION
@@ -2792,7 +2878,7 @@ void gc_history_global::print()
         str_settings[i * 2] = (get_mechanism_p ((gc_global_mechanism_p)i) ? 'Y' : 'N');
     }
 
-    dprintf (DT_LOG_0, ("[hp]|c|p|o|d|b|e|"));
+    dprintf (DT_LOG_0, ("[hp]|c|p|o|d|b|e|l|"));
 
     dprintf (DT_LOG_0, ("%4d|%s", num_heaps, str_settings));
     dprintf (DT_LOG_0, ("Condemned gen%d(reason: %s; mode: %s), youngest budget %Id(%d), memload %d",
@@ -4247,7 +4333,7 @@ void* virtual_alloc (size_t size)
 
     // We don't want (prgmem + size) to be right at the end of the address space 
     // because we'd have to worry about that everytime we do (address + size).
-    // We also want to make sure that we leave LARGE_OBJECT_SIZE at the end 
+    // We also want to make sure that we leave loh_size_threshold at the end 
     // so we allocate a small object we don't need to worry about overflow there
     // when we do alloc_ptr+size.
     if (prgmem)
@@ -4498,8 +4584,9 @@ gc_heap::get_segment (size_t size, BOOL loh_p)
 {
     heap_segment* result = 0;
 
-    if (segment_standby_list != 0)
+    if (segment_standby_limit != 0)
     {
+        enter_spin_lock (&segment_standby_lock);
         result = segment_standby_list;
         heap_segment* last = 0;
         while (result)
@@ -4516,6 +4603,7 @@ gc_heap::get_segment (size_t size, BOOL loh_p)
                 {
                     segment_standby_list = heap_segment_next (result);
                 }
+                segment_standby_size -= hs;
                 break;
             }
             else
@@ -4524,6 +4612,18 @@ gc_heap::get_segment (size_t size, BOOL loh_p)
                 result = heap_segment_next (result);
             }
         }
+
+        if (result)
+        {
+            segment_standby_hits++;
+        }
+        else
+        {
+            segment_standby_misses++;
+        }
+        dprintf (2, ("standby list: %Id hits, %Id misses, %Id bytes left",
+            segment_standby_hits, segment_standby_misses, segment_standby_size));
+        leave_spin_lock (&segment_standby_lock);
     }
 
     if (result)
@@ -4537,15 +4637,11 @@ gc_heap::get_segment (size_t size, BOOL loh_p)
             {
                 dprintf (GC_TABLE_LOG, ("failed to commit mark array for hoarded seg"));
                 // If we can't use it we need to thread it back.
-                if (segment_standby_list != 0)
-                {
-                    heap_segment_next (result) = segment_standby_list;
-                    segment_standby_list = result;
-                }
-                else
-                {
-                    segment_standby_list = result;
-                }
+                enter_spin_lock (&segment_standby_lock);
+                heap_segment_next (result) = segment_standby_list;
+                segment_standby_list = result;
+                segment_standby_size += (size_t)(heap_segment_reserved (result) - (uint8_t*)result);
+                leave_spin_lock (&segment_standby_lock);
 
                 result = 0;
             }
@@ -5636,6 +5732,9 @@ void gc_mechanisms::record (gc_history_global* history)
 
     if (elevation_reduced)
         history->set_mechanism_p (global_elevation);
+
+    if (loh_compaction)
+        history->set_mechanism_p (global_loh_compaction);
 }
 
 /**********************************
@@ -5729,6 +5828,8 @@ void gc_heap::fix_allocation_context (alloc_context* acontext, BOOL for_gc_p,
 
     if (for_gc_p)
     {
+        // alloc_bytes only counts what was actually handed out to objects
+        acontext->alloc_bytes -= (acontext->alloc_limit - acontext->alloc_ptr);
         acontext->alloc_ptr = 0;
         acontext->alloc_limit = acontext->alloc_ptr;
     }
@@ -5949,6 +6050,65 @@ ptrdiff_t  gc_heap::get_allocation (int gen_number)
     return dd_desired_allocation (dd) - dd_new_allocation (dd);
 }
 
+size_t gc_heap::get_memory_pressure ()
+{
+    // The counters can each hold up to SSIZE_T_MAX, so add them up in 64 bits even on 32-bit platforms.
+    int64_t net_bytes = 0;
+    for (int i = 0; i < max_memory_pressure_counters; i++)
+        net_bytes += memory_pressure_counters[i].net_bytes;
+
+    // A removal can be seen before the addition it pairs with when they went to different counters.
+    if (net_bytes <= 0)
+        return 0;
+
+    return (size_t)min (net_bytes, (int64_t)SSIZE_T_MAX);
+}
+
+// The budget left in gen_number once the unmanaged memory registered since gen_number was last
+// collected is charged against it. gen0 is left alone - its budget is sized to fit in the cache and
+// the objects holding on to the unmanaged memory use it up themselves.
+ptrdiff_t gc_heap::get_new_allocation_with_pressure (int gen_number, size_t memory_pressure)
+{
+    ptrdiff_t new_allocation = get_new_allocation (gen_number);
+
+    if ((gen_number == 0) || (gen_number > max_generation) || 
+        (memory_pressure <= memory_pressure_at_gc[gen_number]))
+    {
+        return new_allocation;
+    }
+
+    size_t growth = memory_pressure - memory_pressure_at_gc[gen_number];
+#ifdef MULTIPLE_HEAPS
+    growth /= n_heaps;
+#endif //MULTIPLE_HEAPS
+
+    return new_allocation - (ptrdiff_t)growth;
+}
+
+// Returns the oldest generation whose budget has run out because of unmanaged memory, 0 if there is
+// none.
+int gc_heap::generation_exhausted_by_memory_pressure ()
+{
+    size_t memory_pressure = get_memory_pressure ();
+
+    for (int gen_number = max_generation; gen_number > 0; gen_number--)
+    {
+#ifdef MULTIPLE_HEAPS
+        for (int i = 0; i < n_heaps; i++)
+        {
+            gc_heap* hp = g_heaps[i];
+#else
+        {
+            gc_heap* hp = pGenGCHeap;
+#endif //MULTIPLE_HEAPS
+            if (hp->get_new_allocation_with_pressure (gen_number, memory_pressure) <= 0)
+                return gen_number;
+        }
+    }
+
+    return 0;
+}
+
 inline
 BOOL grow_mark_stack (mark*& m, size_t& len, size_t init_len)
 {
@@ -6197,6 +6357,130 @@ void gc_heap::make_mark_stack (mark* arr)
 #endif //MH_SC_MARK
 }
 
+// Reserves the address range for the mark stack and commits the initial part of it.
+// Returns 0 if that fails in which case the mark stack is allocated from the native
+// heap like before and can only grow by copying.
+mark* gc_heap::reserve_mark_stack()
+{
+    mark_stack_array_reserved_length = 0;
+
+    size_t reserve_size = align_on_page (MARK_STACK_RESERVE_SIZE);
+    mark* arr = (mark*)GCToOSInterface::VirtualReserve (0, reserve_size, 0, VirtualReserveFlags::None);
+    if (!arr)
+        return 0;
+
+    if (!GCToOSInterface::VirtualCommit (arr, align_on_page (MARK_STACK_INITIAL_LENGTH * sizeof (mark))))
+    {
+        GCToOSInterface::VirtualRelease (arr, reserve_size);
+        return 0;
+    }
+
+    mark_stack_array_reserved_length = reserve_size / sizeof (mark);
+    return arr;
+}
+
+// Commits more of the reserved range so the mark stack has new_length entries
+// (or as many as the reserve allows). The stack doesn't move.
+BOOL gc_heap::grow_mark_stack_in_place (size_t new_length)
+{
+    new_length = min (new_length, mark_stack_array_reserved_length);
+    if (new_length <= mark_stack_array_length)
+        return FALSE;
+
+    size_t committed = align_on_page (mark_stack_array_length * sizeof (mark));
+    size_t new_committed = align_on_page (new_length * sizeof (mark));
+    if ((new_committed > committed) &&
+        !GCToOSInterface::VirtualCommit ((uint8_t*)mark_stack_array + committed, new_committed - committed))
+    {
+        dprintf (1, ("Failed to commit %Id bytes for mark stack", (new_committed - committed)));
+        return FALSE;
+    }
+
+    dprintf (2, ("h%d: mark stack grown from %Id to %Id entries", 
+        heap_number, mark_stack_array_length, new_length));
+    mark_stack_array_length = new_length;
+    return TRUE;
+}
+
+// Doubles the mark stack keeping its contents; the stack may move.
+BOOL gc_heap::grow_mark_stack_array()
+{
+    if (mark_stack_array_reserved_length != 0)
+    {
+        if (grow_mark_stack_in_place (max (MARK_STACK_INITIAL_LENGTH, 2*mark_stack_array_length)))
+            return TRUE;
+
+        // Out of reserve, move the stack to the native heap.
+        size_t new_size = max (MARK_STACK_INITIAL_LENGTH, 2*mark_stack_array_length);
+        mark* tmp = new (nothrow) mark [new_size];
+        if (!tmp)
+        {
+            dprintf (1, ("Failed to allocate %Id bytes for mark stack", (new_size * sizeof (mark))));
+            return FALSE;
+        }
+
+        memcpy (tmp, mark_stack_array, mark_stack_array_length * sizeof (mark));
+        release_mark_stack();
+        mark_stack_array = tmp;
+        mark_stack_array_length = new_size;
+        return TRUE;
+    }
+
+    return grow_mark_stack (mark_stack_array, mark_stack_array_length, MARK_STACK_INITIAL_LENGTH);
+}
+
+// Called by marking when the entries it's about to push don't fit. tos is the current
+// top of the stack and needed_slots the number of pointer sized entries to make room for.
+BOOL gc_heap::make_room_on_mark_stack (uint8_t** tos, size_t needed_slots)
+{
+    size_t used_slots = tos - (uint8_t**)mark_stack_array;
+    size_t needed_length = ((used_slots + needed_slots + 2) * sizeof (uint8_t*) + sizeof (mark) - 1) / sizeof (mark);
+    size_t new_length = max (needed_length, 2*mark_stack_array_length);
+
+    // Same limit as process_mark_overflow - past a tenth of the heap size we'd rather
+    // rescan for the overflowed objects than keep committing memory for the stack.
+    if ((new_length * sizeof (mark)) > 100*1024)
+    {
+        size_t max_length = (get_total_heap_size() / 10) / sizeof (mark);
+        new_length = min (new_length, max (max_length, (size_t)MARK_STACK_INITIAL_LENGTH));
+    }
+
+    return grow_mark_stack_in_place (new_length);
+}
+
+// Decommits what marking grew the mark stack by so a single GC that needed a deep
+// stack doesn't keep the memory committed.
+void gc_heap::decommit_mark_stack()
+{
+    if ((mark_stack_array_reserved_length == 0) || (mark_stack_array_length <= MARK_STACK_INITIAL_LENGTH))
+        return;
+
+    size_t initial_committed = align_on_page (MARK_STACK_INITIAL_LENGTH * sizeof (mark));
+    size_t committed = align_on_page (mark_stack_array_length * sizeof (mark));
+    if (committed > initial_committed)
+    {
+        GCToOSInterface::VirtualDecommit ((uint8_t*)mark_stack_array + initial_committed, committed - initial_committed);
+    }
+
+    dprintf (2, ("h%d: mark stack shrunk from %Id to %Id entries", 
+        heap_number, mark_stack_array_length, (size_t)MARK_STACK_INITIAL_LENGTH));
+    mark_stack_array_length = MARK_STACK_INITIAL_LENGTH;
+}
+
+void gc_heap::release_mark_stack()
+{
+    if (mark_stack_array_reserved_length != 0)
+    {
+        GCToOSInterface::VirtualRelease (mark_stack_array, align_on_page (MARK_STACK_RESERVE_SIZE));
+        mark_stack_array_reserved_length = 0;
+    }
+    else
+    {
+        delete mark_stack_array;
+    }
+    mark_stack_array = 0;
+}
+
 #ifdef BACKGROUND_GC
 inline
 size_t& gc_heap::bpromoted_bytes(int thread)
@@ -6661,6 +6945,14 @@ void gc_heap::mark_array_set_marked (uint8_t* add)
 #ifdef MULTIPLE_HEAPS
     Interlocked::Or (&(mark_array [index]), val);
 #else
+#ifdef BGC_PARALLEL_MARK
+    // Mark helpers may be setting bits in the same word.
+    if (bgc_parallel_mark_p)
+    {
+        Interlocked::Or (&(mark_array [index]), val);
+        return;
+    }
+#endif //BGC_PARALLEL_MARK
     mark_array [index] |= val;
 #endif 
 }
@@ -8954,8 +9246,20 @@ void gc_heap::delete_heap_segment (heap_segment* seg, BOOL consider_hoarding)
     {
         assert ((heap_segment_mem (seg) - (uint8_t*)seg) <= 2*OS_PAGE_SIZE);
         size_t ss = (size_t) (heap_segment_reserved (seg) - (uint8_t*)seg);
-        //Don't keep the big ones.
+        //Don't keep the big ones, and don't keep more than the standby list is allowed to hold.
+        BOOL hoard_p = FALSE;
         if (ss <= INITIAL_ALLOC)
+        {
+            enter_spin_lock (&segment_standby_lock);
+            if (ss <= (segment_standby_limit - segment_standby_size))
+            {
+                segment_standby_size += ss;
+                hoard_p = TRUE;
+            }
+            leave_spin_lock (&segment_standby_lock);
+        }
+
+        if (hoard_p)
         {
             dprintf (2, ("Hoarding segment %Ix", (size_t)seg));
 #ifdef BACKGROUND_GC
@@ -8971,8 +9275,12 @@ void gc_heap::delete_heap_segment (heap_segment* seg, BOOL consider_hoarding)
             seg_mapping_table_remove_segment (seg);
 #endif //SEG_MAPPING_TABLE
 
+            heap_segment_standby_gen2_count (seg) = dd_collection_count (dynamic_data_of (max_generation));
+
+            enter_spin_lock (&segment_standby_lock);
             heap_segment_next (seg) = segment_standby_list;
             segment_standby_list = seg;
+            leave_spin_lock (&segment_standby_lock);
             seg = 0;
         }
     }
@@ -9000,6 +9308,72 @@ void gc_heap::delete_heap_segment (heap_segment* seg, BOOL consider_hoarding)
     }
 }
 
+// Returns the segments that have been on the standby list for segment_standby_max_age
+// gen2 GCs or more to the OS. This is called at the end of every blocking GC.
+void gc_heap::release_aged_standby_segments()
+{
+#ifdef MULTIPLE_HEAPS
+    gc_heap* hp = g_heaps[0];
+#else
+    gc_heap* hp = pGenGCHeap;
+#endif //MULTIPLE_HEAPS
+
+    size_t gen2_count = dd_collection_count (hp->dynamic_data_of (max_generation));
+    heap_segment* aged_list = 0;
+
+    enter_spin_lock (&segment_standby_lock);
+    heap_segment* seg = segment_standby_list;
+    heap_segment* last = 0;
+    while (seg)
+    {
+        heap_segment* next_seg = heap_segment_next (seg);
+        if ((gen2_count - heap_segment_standby_gen2_count (seg)) >= segment_standby_max_age)
+        {
+            if (last)
+            {
+                heap_segment_next (last) = next_seg;
+            }
+            else
+            {
+                segment_standby_list = next_seg;
+            }
+            segment_standby_size -= (size_t)(heap_segment_reserved (seg) - (uint8_t*)seg);
+            heap_segment_next (seg) = aged_list;
+            aged_list = seg;
+        }
+        else
+        {
+            last = seg;
+        }
+        seg = next_seg;
+    }
+    leave_spin_lock (&segment_standby_lock);
+
+    while (aged_list)
+    {
+        heap_segment* next_seg = heap_segment_next (aged_list);
+        dprintf (2, ("Releasing aged standby segment %Ix", (size_t)aged_list));
+        hp->release_standby_segment (aged_list);
+        segment_standby_released++;
+        aged_list = next_seg;
+    }
+}
+
+// Returns a segment taken off the standby list to the OS. Unlike delete_heap_segment this
+// doesn't touch the seg mapping table, the segment was taken out of it when it was hoarded.
+void gc_heap::release_standby_segment (heap_segment* seg)
+{
+#ifdef BACKGROUND_GC
+    decommit_mark_array_by_seg (seg);
+#endif //BACKGROUND_GC
+
+#ifndef SEG_MAPPING_TABLE
+    seg_table->remove ((uint8_t*)seg);
+#endif //!SEG_MAPPING_TABLE
+
+    release_segment (seg);
+}
+
 //resets the pages beyond alloctes size so they won't be swapped out and back in
 
 void gc_heap::reset_heap_segment_pages (heap_segment* seg)
@@ -9096,7 +9470,7 @@ void gc_heap::rearrange_large_heap_segments()
     while (seg)
     {
         heap_segment* next_seg = heap_segment_next (seg);
-        delete_heap_segment (seg, (g_pConfig->GetGCRetainVM() != 0));
+        delete_heap_segment (seg, (segment_standby_limit != 0));
         seg = next_seg;
     }
     freeable_large_heap_segment = 0;
@@ -9139,7 +9513,7 @@ void gc_heap::rearrange_heap_segments(BOOL compacting)
                 assert (prev_seg);
                 assert (seg != ephemeral_heap_segment);
                 heap_segment_next (prev_seg) = next_seg;
-                delete_heap_segment (seg, (g_pConfig->GetGCRetainVM() != 0));
+                delete_heap_segment (seg, (segment_standby_limit != 0));
 
                 dprintf (2, ("Deleting heap segment %Ix", (size_t)seg));
             }
@@ -9636,6 +10010,20 @@ HRESULT gc_heap::initialize_gc (size_t segment_size,
 #endif //BACKGROUND_GC
 #endif //WRITE_WATCH
 
+    // The configured LOH threshold can only raise the default. It is capped at half of gen0's budget: every
+    // small object has to fit in gen0's allocation budget, and END_SPACE_AFTER_GC keeps a threshold's worth of
+    // space at the end of the ephemeral segment, so a bigger threshold would have single allocations trigger
+    // GCs and eat into the segment. gen0's budget is itself at most half the segment (see GetValidGen0MaxSize),
+    // so raising GCgen0size is the way to allow a higher threshold.
+    int config_loh_size_threshold = g_pConfig->GetGCLOHThreshold();
+    size_t max_loh_size_threshold = max (GCHeap::GetValidGen0MaxSize (segment_size) / 2, LARGE_OBJECT_SIZE);
+    loh_size_threshold = LARGE_OBJECT_SIZE;
+    if (config_loh_size_threshold > 0)
+    {
+        loh_size_threshold = min (max ((size_t)config_loh_size_threshold, LARGE_OBJECT_SIZE), max_loh_size_threshold);
+    }
+    dprintf (2, ("LOH threshold: %Id (configured %d, cap %Id)", loh_size_threshold, config_loh_size_threshold, max_loh_size_threshold));
+
     reserved_memory = 0;
     unsigned block_count;
 #ifdef MULTIPLE_HEAPS
@@ -9783,6 +10171,20 @@ gc_heap::init_semi_shared()
 #endif //!SEG_MAPPING_TABLE || FEATURE_BASICFREEZE
 
     segment_standby_list = 0;
+    segment_standby_lock.lock = -1;
+    segment_standby_size = 0;
+    // RetainVM keeps every freed segment that isn't too big for good, otherwise we keep as
+    // many as fit in the configured standby size until they age out.
+    if (g_pConfig->GetGCRetainVM() != 0)
+    {
+        segment_standby_limit = SIZE_T_MAX;
+        segment_standby_max_age = SIZE_T_MAX;
+    }
+    else
+    {
+        segment_standby_limit = (size_t)g_pConfig->GetGCSegmentStandbyMB() * 1024 * 1024;
+        segment_standby_max_age = (size_t)g_pConfig->GetGCSegmentStandbyMaxAge();
+    }
 
     full_gc_approach_event.CreateManualEvent(FALSE);
     if (!full_gc_approach_event.IsValid())
@@ -9807,6 +10209,9 @@ gc_heap::init_semi_shared()
 #ifdef FEATURE_LOH_COMPACTION
     loh_compaction_always_p = (g_pConfig->GetGCLOHCompactionMode() != 0);
     loh_compaction_mode = loh_compaction_default;
+    loh_compaction_frag_pct = (uint32_t)g_pConfig->GetGCLOHCompactFragPercent();
+    loh_compaction_min_frag = (size_t)g_pConfig->GetGCLOHCompactMinFragMB() * 1024 * 1024;
+    loh_compaction_largest_free_pct = (uint32_t)g_pConfig->GetGCLOHCompactLargestFreePercent();
 #endif //FEATURE_LOH_COMPACTION
 
 #ifdef BACKGROUND_GC
@@ -10079,6 +10484,8 @@ gc_heap::init_gc_heap (int  h_number)
 
     mark_stack_array = 0;
 
+    mark_stack_array_reserved_length = 0;
+
     verify_pinned_queue_p = FALSE;
 
     loh_pinned_queue_tos = 0;
@@ -10281,9 +10688,16 @@ gc_heap::init_gc_heap (int  h_number)
 
     fgn_last_alloc = dd_min_gc_size (dynamic_data_of (0));
 
-    mark* arr = new (nothrow) (mark [MARK_STACK_INITIAL_LENGTH]);
+    mark_stack_overflow_count = 0;
+    mark_overflow_rescan_count = 0;
+
+    mark* arr = reserve_mark_stack();
     if (!arr)
-        return 0;
+    {
+        arr = new (nothrow) (mark [MARK_STACK_INITIAL_LENGTH]);
+        if (!arr)
+            return 0;
+    }
 
     make_mark_stack(arr);
 
@@ -10468,7 +10882,7 @@ gc_heap::self_destroy()
     release_card_table (card_table);
 
     // destroy the mark stack
-    delete mark_stack_array;
+    release_mark_stack();
 
 #ifdef FEATURE_PREMORTEM_FINALIZATION
     if (finalize_queue)
@@ -11078,6 +11492,8 @@ void gc_heap::adjust_limit_clr (uint8_t* start, size_t limit_size,
             size_t free_obj_size = size + Align (min_obj_size, align_const);
             make_unused_array (hole, free_obj_size);
             generation_free_obj_space (generation_of (gen_number)) += free_obj_size;
+            // the rest of the old context was never handed out to objects
+            acontext->alloc_bytes -= size;
         }
         acontext->alloc_ptr = start;
     }
@@ -11189,13 +11605,22 @@ void gc_heap::adjust_limit_clr (uint8_t* start, size_t limit_size,
  */
 
 size_t gc_heap::limit_from_size (size_t size, size_t room, int gen_number,
-                                 int align_const)
+                                 int align_const, alloc_context* acontext)
 {
+    size_t quantum = ((gen_number < max_generation+1) ? allocation_quantum : 0);
+
+    if ((gen_number == 0) && (acontext == current_no_gc_region_info.presize_acontext))
+    {
+        // This is the context of the thread that started the no gc region. Hand it the whole SOH budget 
+        // we reserved so its allocations stay on the fast path for the rest of the region.
+        dprintf (2, ("presizing alloc context %Ix for no gc region", (size_t)acontext));
+        quantum = max (quantum, soh_allocation_no_gc);
+        current_no_gc_region_info.presize_acontext = 0;
+    }
+
     size_t new_limit = new_allocation_limit ((size + Align (min_obj_size, align_const)),
                                              min (room,max (size + Align (min_obj_size, align_const),
-                                                            ((gen_number < max_generation+1) ?
-                                                             allocation_quantum :
-                                                             0))),
+                                                            quantum)),
                                              gen_number);
     assert (new_limit >= (size + Align (min_obj_size, align_const)));
     dprintf (100, ("requested to allocate %Id bytes, actual size is %Id", size, new_limit));
@@ -11527,7 +11952,7 @@ BOOL gc_heap::a_fit_free_list_p (int gen_number,
                     // We ask for more Align (min_obj_size)
                     // to make sure that we can insert a free object
                     // in adjust_limit will set the limit lower
-                    size_t limit = limit_from_size (size, free_list_size, gen_number, align_const);
+                    size_t limit = limit_from_size (size, free_list_size, gen_number, align_const, acontext);
 
                     uint8_t*  remain = (free_list + limit);
                     size_t remain_size = (free_list_size - limit);
@@ -11701,7 +12126,7 @@ BOOL gc_heap::a_fit_free_list_large_p (size_t size,
 
                     // Substract min obj size because limit_from_size adds it. Not needed for LOH
                     size_t limit = limit_from_size (size - Align(min_obj_size, align_const), free_list_size, 
-                                                    gen_number, align_const);
+                                                    gen_number, align_const, acontext);
 
 #ifdef FEATURE_LOH_COMPACTION
                     make_unused_array (free_list, loh_pad);
@@ -11790,7 +12215,7 @@ BOOL gc_heap::a_fit_segment_end_p (int gen_number,
     {
         limit = limit_from_size (size, 
                                  (end - allocated), 
-                                 gen_number, align_const);
+                                 gen_number, align_const, acontext);
         goto found_fit;
     }
 
@@ -11800,7 +12225,7 @@ BOOL gc_heap::a_fit_segment_end_p (int gen_number,
     {
         limit = limit_from_size (size, 
                                  (end - allocated), 
-                                 gen_number, align_const);
+                                 gen_number, align_const, acontext);
         if (grow_heap_segment (seg, allocated + limit))
         {
             goto found_fit;
@@ -14286,6 +14711,31 @@ size_t gc_heap::get_total_allocated()
     return total_current_allocated;
 }
 
+// Gets the size of all generations on all heaps from the dynamic data alone: what survived the last GC of each
+// generation plus what was allocated into or promoted into it since. This only reads counters so it doesn't need
+// the gc lock, but the result may be slightly stale while allocation contexts are being handed out or a GC is
+// in progress.
+size_t gc_heap::get_total_current_size()
+{
+    size_t total_current_size = 0;
+#ifdef MULTIPLE_HEAPS
+    for (int i = 0; i < gc_heap::n_heaps; i++)
+    {
+        gc_heap* hp = gc_heap::g_heaps[i];
+        for (int gen_number = 0; gen_number <= (max_generation + 1); gen_number++)
+        {
+            total_current_size += hp->current_generation_size (gen_number);
+        }
+    }
+#else
+    for (int gen_number = 0; gen_number <= (max_generation + 1); gen_number++)
+    {
+        total_current_size += current_generation_size (gen_number);
+    }
+#endif //MULTIPLE_HEAPS
+    return total_current_size;
+}
+
 size_t gc_heap::current_generation_size (int gen_number)
 {
     dynamic_data* dd = dynamic_data_of (gen_number);
@@ -14399,16 +14849,26 @@ int gc_heap::generation_to_condemn (int n_initial,
             }
         }
 
+        size_t memory_pressure = get_memory_pressure ();
+
         //figure out which generation ran out of allocation
         for (i = n+1; i <= (check_max_gen_alloc ? max_generation : (max_generation - 1)); i++)
         {
-            if (get_new_allocation (i) <= 0)
+            if (get_new_allocation_with_pressure (i, memory_pressure) <= 0)
             {
                 n = i;
             }
             else
                 break;
         }
+
+        // Unmanaged memory isn't promoted through the younger generations, so it can use up the
+        // budget of gen2 while gen1 still has room.
+        if (check_max_gen_alloc && (n < max_generation) &&
+            (get_new_allocation_with_pressure (max_generation, memory_pressure) <= 0))
+        {
+            n = max_generation;
+        }
     }
 
     if (n > temp_gen)
@@ -15483,6 +15943,7 @@ void gc_heap::gc1()
             {
                 gc_heap* hp = gc_heap::g_heaps[i];
                 hp->decommit_ephemeral_segment_pages();
+                hp->decommit_mark_stack();
                 hp->rearrange_large_heap_segments();
 #ifdef FEATURE_LOH_COMPACTION
                 all_heaps_compacted_p &= hp->loh_compacted_p;
@@ -15512,6 +15973,7 @@ void gc_heap::gc1()
 
     if (!(settings.concurrent))
     {
+        decommit_mark_stack();
         rearrange_large_heap_segments();
         do_post_gc();
     }
@@ -15540,6 +16002,7 @@ void gc_heap::save_data_for_no_gc()
 void gc_heap::restore_data_for_no_gc()
 {
     gc_heap::settings.pause_mode = current_no_gc_region_info.saved_pause_mode;
+    current_no_gc_region_info.presize_acontext = 0;
 #ifdef MULTIPLE_HEAPS
     for (int i = 0; i < n_heaps; i++)
     {
@@ -15922,18 +16385,23 @@ done:
     }
 }
 
+end_no_gc_region_status gc_heap::get_no_gc_region_status()
+{
+    if (!(current_no_gc_region_info.started))
+        return end_no_gc_not_in_progress;
+    if (current_no_gc_region_info.num_gcs_induced)
+        return end_no_gc_induced;
+    if (current_no_gc_region_info.num_gcs)
+        return end_no_gc_alloc_exceeded;
+
+    return end_no_gc_success;
+}
+
 end_no_gc_region_status gc_heap::end_no_gc_region()
 {
     dprintf (1, ("end no gc called"));
 
-    end_no_gc_region_status status = end_no_gc_success;
-
-    if (!(current_no_gc_region_info.started))
-        status = end_no_gc_not_in_progress;
-    if (current_no_gc_region_info.num_gcs_induced)
-        status = end_no_gc_induced;
-    else if (current_no_gc_region_info.num_gcs)
-        status = end_no_gc_alloc_exceeded;
+    end_no_gc_region_status status = get_no_gc_region_status();
 
     if (settings.pause_mode == pause_no_gc)
         restore_data_for_no_gc();
@@ -15951,9 +16419,12 @@ void gc_heap::update_collection_counts ()
     dd_gc_clock (dd0) += 1;
 
     size_t now = GetHighPrecisionTimeStamp();
+    size_t memory_pressure = get_memory_pressure ();
 
     for (int i = 0; i <= settings.condemned_generation;i++)
     {
+        memory_pressure_at_gc[i] = memory_pressure;
+
         dynamic_data* dd = dynamic_data_of (i);
         dd_collection_count (dd)++;
         //this is needed by the linear allocation model
@@ -16381,6 +16852,17 @@ int gc_heap::garbage_collect (int n)
             }
 #endif //BACKGROUND_GC
 
+#ifdef FEATURE_LOH_COMPACTION
+            // This needs to be decided before we mark so that interior pointers into the LOH get
+            // relocated.
+            if (!settings.loh_compaction && 
+                (settings.condemned_generation == max_generation) && 
+                !settings.concurrent)
+            {
+                settings.loh_compaction = should_compact_loh_for_fragmentation();
+            }
+#endif //FEATURE_LOH_COMPACTION
+
             settings.gc_index = (uint32_t)dd_collection_count (dynamic_data_of (0)) + 1;
 
             // Call the EE for start of GC work
@@ -16456,6 +16938,9 @@ int gc_heap::garbage_collect (int n)
             }
 #else
             prepare_bgc_thread(0);
+#ifdef BGC_PARALLEL_MARK
+            create_bgc_mark_helpers();
+#endif //BGC_PARALLEL_MARK
 #endif //MULTIPLE_HEAPS
 
 #ifdef MULTIPLE_HEAPS
@@ -17147,7 +17632,7 @@ void gc_heap::enque_pinned_plug (uint8_t* plug,
 {
     if (mark_stack_array_length <= mark_stack_tos)
     {
-        if (!grow_mark_stack (mark_stack_array, mark_stack_array_length, MARK_STACK_INITIAL_LENGTH))
+        if (!grow_mark_stack_array())
         {
             // we don't want to continue here due to security
             // risks. This happens very rarely and fixing it in the
@@ -17389,9 +17874,14 @@ void gc_heap::mark_object_simple1 (uint8_t* oo, uint8_t* start THREAD_NUMBER_DCL
                 if (mark_stack_tos + (s) /sizeof (uint8_t*) >= (mark_stack_limit  - 1))
                 {
                     size_t num_components = ((method_table(oo))->HasComponentSize() ? ((CObjectHeader*)oo)->GetNumComponents() : 0);
-                    if (mark_stack_tos + CGCDesc::GetNumPointers(method_table(oo), s, num_components) >= (mark_stack_limit - 1))
+                    size_t num_pointers = CGCDesc::GetNumPointers(method_table(oo), s, num_components);
+                    if (mark_stack_tos + num_pointers >= (mark_stack_limit - 1))
                     {
-                        overflow_p = TRUE;
+                        if (make_room_on_mark_stack ((uint8_t**)mark_stack_tos, num_pointers))
+                        {
+                            mark_stack_limit = (SERVER_SC_MARK_VOLATILE(uint8_t*)*)&mark_stack_array[mark_stack_array_length];
+                        }
+                        overflow_p = (mark_stack_tos + num_pointers >= (mark_stack_limit - 1));
                     }
                 }
                 
@@ -17426,6 +17916,7 @@ void gc_heap::mark_object_simple1 (uint8_t* oo, uint8_t* start THREAD_NUMBER_DCL
                 else
                 {
                     dprintf(3,("mark stack overflow for object %Ix ", (size_t)oo));
+                    mark_stack_overflow_count++;
                     min_overflow_address = min (min_overflow_address, oo);
                     max_overflow_address = max (max_overflow_address, oo);
                 }
@@ -17472,7 +17963,11 @@ void gc_heap::mark_object_simple1 (uint8_t* oo, uint8_t* start THREAD_NUMBER_DCL
             
                 if (mark_stack_tos + (num_partial_refs + 2)  >= mark_stack_limit)
                 {
-                    overflow_p = TRUE;
+                    if (make_room_on_mark_stack ((uint8_t**)mark_stack_tos, (num_partial_refs + 2)))
+                    {
+                        mark_stack_limit = (SERVER_SC_MARK_VOLATILE(uint8_t*)*)&mark_stack_array[mark_stack_array_length];
+                    }
+                    overflow_p = (mark_stack_tos + (num_partial_refs + 2)  >= mark_stack_limit);
                 }
                 if (overflow_p == FALSE)
                 {
@@ -17544,6 +18039,7 @@ more_to_do:
                 else
                 {
                     dprintf(3,("mark stack overflow for object %Ix ", (size_t)oo));
+                    mark_stack_overflow_count++;
                     min_overflow_address = min (min_overflow_address, oo);
                     max_overflow_address = max (max_overflow_address, oo);
                 }
@@ -18032,6 +18528,12 @@ void gc_heap::background_mark_simple1 (uint8_t* oo THREAD_NUMBER_DCL)
                                 *(background_mark_stack_tos++) = o;
 
                             }
+#ifdef BGC_STRING_DEDUP_STATS
+                            else if (string_dedup_budget_left != 0)
+                            {
+                                record_string_dedup (o);
+                            }
+#endif //BGC_STRING_DEDUP_STATS
                         }
                     }
                         );
@@ -18128,6 +18630,12 @@ void gc_heap::background_mark_simple1 (uint8_t* oo THREAD_NUMBER_DCL)
                                 }
 
                             }
+#ifdef BGC_STRING_DEDUP_STATS
+                            else if (string_dedup_budget_left != 0)
+                            {
+                                record_string_dedup (o);
+                            }
+#endif //BGC_STRING_DEDUP_STATS
                         }
 
                     }
@@ -18154,6 +18662,13 @@ void gc_heap::background_mark_simple1 (uint8_t* oo THREAD_NUMBER_DCL)
         }
 #endif //SORT_MARK_STACK
 
+#ifdef BGC_PARALLEL_MARK
+        if (bgc_parallel_mark_p && (bgc_mark_helpers_idle > 0))
+        {
+            share_bgc_mark_stack (background_mark_stack_tos, background_mark_stack_array);
+        }
+#endif //BGC_PARALLEL_MARK
+
         allow_fgc();
 
         if (!(background_mark_stack_tos == background_mark_stack_array))
@@ -18198,6 +18713,12 @@ gc_heap::background_mark_simple (uint8_t* o THREAD_NUMBER_DCL)
             {
                 background_mark_simple1 (o THREAD_NUMBER_ARG);
             }
+#ifdef BGC_STRING_DEDUP_STATS
+            else if (string_dedup_budget_left != 0)
+            {
+                record_string_dedup (o);
+            }
+#endif //BGC_STRING_DEDUP_STATS
         }
     }
 }
@@ -18381,8 +18902,601 @@ gc_heap::scan_background_roots (promote_func* fn, int hn, ScanContext *pSC)
         (*fn) ((Object**)finger, pSC, 0);
         finger++;
     }
+
+#ifdef BGC_PARALLEL_MARK
+    scan_bgc_parallel_mark_roots (fn, pSC);
+#endif //BGC_PARALLEL_MARK
+}
+
+#ifdef BGC_STRING_DEDUP_STATS
+
+// String duplicate statistics
+//
+// When GCStringDedupStatsMB is set, background marking hashes the contents of the gen2
+// strings it marks, up to that many bytes per heap per BGC, and counts how many of them have
+// the same contents as a string seen before. Nothing in the heap is changed - this is only to
+// find out how much memory deduplicating strings would save. The results of the last BGC are
+// available through GCHeap::GetStringDedupStats.
+//
+// Strings are recognized by the method table so only strings in the GC heap are looked at;
+// literals live in frozen segments and are never marked by the BGC.
+
+void gc_heap::init_string_dedup_stats()
+{
+    string_dedup_budget = (size_t)g_pConfig->GetGCStringDedupStatsMB() * 1024 * 1024;
+    string_dedup_budget_left = 0;
+    string_dedup_table = 0;
+    string_dedup_table_used = 0;
+    memset (&string_dedup_current, 0, sizeof (string_dedup_current));
+    memset (&string_dedup_last, 0, sizeof (string_dedup_last));
+#ifdef BGC_PARALLEL_MARK
+    string_dedup_lock.lock = -1;
+#endif //BGC_PARALLEL_MARK
+
+    if (string_dedup_budget != 0)
+    {
+        // If we can't get the table we just don't look for duplicates on this heap.
+        string_dedup_table = new (nothrow) uint64_t [STRING_DEDUP_TABLE_LENGTH];
+    }
+}
+
+void gc_heap::begin_string_dedup_stats()
+{
+    if (!string_dedup_table)
+        return;
+
+    memset (string_dedup_table, 0, STRING_DEDUP_TABLE_LENGTH * sizeof (uint64_t));
+    string_dedup_table_used = 0;
+    memset (&string_dedup_current, 0, sizeof (string_dedup_current));
+    string_dedup_budget_left = string_dedup_budget;
+}
+
+// Called for the objects without references that background marking marks while there's
+// budget left.
+void gc_heap::record_string_dedup (uint8_t* o)
+{
+    if (!method_table (o)->IsString())
+        return;
+
+    // Strings that are still ephemeral may well die young.
+    if ((o >= g_ephemeral_low) && (o < g_ephemeral_high))
+        return;
+
+    size_t length = ((CObjectHeader*)o)->GetNumComponents();
+
+#ifdef BGC_PARALLEL_MARK
+    // The helpers are created before marking starts, so this doesn't change while we mark.
+    if (n_bgc_mark_helpers_created > 0)
+    {
+        enter_spin_lock (&string_dedup_lock);
+        if (string_dedup_budget_left != 0)
+        {
+            add_string_dedup_sample (o, length);
+        }
+        leave_spin_lock (&string_dedup_lock);
+        return;
+    }
+#endif //BGC_PARALLEL_MARK
+
+    add_string_dedup_sample (o, length);
+}
+
+void gc_heap::add_string_dedup_sample (uint8_t* o, size_t length)
+{
+    size_t content_size = length * sizeof (uint16_t);
+    if (content_size > string_dedup_budget_left)
+    {
+        dprintf (3, ("string dedup budget used up at %Ix", (size_t)o));
+        string_dedup_budget_left = 0;
+        return;
+    }
+    string_dedup_budget_left -= content_size;
+
+    // The characters come right after the method table pointer and the length.
+    uint8_t* chars = o + sizeof (uint8_t*) + sizeof (uint32_t);
+
+    // FNV-1a, seeded with the length so strings of different lengths rarely collide.
+    uint64_t hash = 14695981039346656037ULL ^ (uint64_t)length;
+    for (size_t i = 0; i < content_size; i++)
+    {
+        hash = (hash ^ chars[i]) * 1099511628211ULL;
+    }
+    if (hash == 0)
+        hash = 1;
+
+    size_t mask = STRING_DEDUP_TABLE_LENGTH - 1;
+    size_t index = (size_t)hash & mask;
+    while ((string_dedup_table[index] != 0) && (string_dedup_table[index] != hash))
+    {
+        index = (index + 1) & mask;
+    }
+
+    size_t s = size (o);
+    string_dedup_current.sampled_count++;
+    string_dedup_current.sampled_bytes += s;
+
+    if (string_dedup_table[index] == hash)
+    {
+        int bucket = ((length == 0) ? 0 : index_of_set_bit (round_down_power2 (length)));
+        bucket = min (bucket, STRING_DEDUP_LENGTH_BUCKETS - 1);
+        string_dedup_current.dup_count[bucket]++;
+        string_dedup_current.dup_bytes[bucket] += s;
+    }
+    else
+    {
+        string_dedup_table[index] = hash;
+        // Stop before probing gets expensive.
+        if (++string_dedup_table_used >= (STRING_DEDUP_TABLE_LENGTH / 4 * 3))
+        {
+            string_dedup_budget_left = 0;
+        }
+    }
+}
+
+void gc_heap::end_string_dedup_stats()
+{
+    if (!string_dedup_table)
+        return;
+
+    string_dedup_budget_left = 0;
+    string_dedup_last = string_dedup_current;
+
+    dprintf (GTC_LOG, ("h%d: string dedup sampled %Id strings, %Id bytes", 
+        heap_number, string_dedup_last.sampled_count, string_dedup_last.sampled_bytes));
+
+    for (int i = 0; i < STRING_DEDUP_LENGTH_BUCKETS; i++)
+    {
+        if (string_dedup_last.dup_count[i] != 0)
+        {
+            dprintf (GTC_LOG, ("h%d: %Id+ chars: %Id dups, %Id bytes", 
+                heap_number, ((size_t)1 << i), 
+                string_dedup_last.dup_count[i], string_dedup_last.dup_bytes[i]));
+        }
+    }
+}
+
+#endif //BGC_STRING_DEDUP_STATS
+
+#ifdef BGC_PARALLEL_MARK
+
+// Parallel background marking
+//
+// On workstation GC the concurrent part of background marking can be shared with up to
+// GCBgcMarkThreads helper threads. While a marking session is active (between
+// begin_bgc_parallel_mark and end_bgc_parallel_mark) whoever has more than one entry on its mark
+// stack moves some of them to a shared queue when a helper is idle, and idle helpers take them
+// from there.
+//
+// Helpers are GC special threads that stay in cooperative mode while they mark and let foreground
+// GCs in at the same points the BGC thread does, so whenever an FGC happens every object that
+// still needs to be scanned is either on one of the mark stacks or in the shared queue, all of
+// which scan_background_roots reports. Entries are only moved while holding
+// bgc_mark_queue_lock.
+//
+// Helpers don't do partial marking; an object they can't push all the children of is recorded in
+// their own overflow range which gets merged into the background overflow range at the end of the
+// session.
+
+void gc_heap::init_bgc_parallel_mark()
+{
+    n_bgc_mark_helpers = 0;
+    bgc_mark_queue_lock.lock = -1;
+
+    int n_helpers = (int)min ((size_t)g_pConfig->GetGCBgcMarkThreads(), (size_t)MAX_BGC_MARK_HELPERS);
+    n_helpers = min (n_helpers, (int)g_SystemInfo.dwNumberOfProcessors - 1);
+    if (n_helpers <= 0)
+        return;
+
+    // Failing to set up the helpers is not fatal, we just mark with the BGC thread alone.
+    bgc_mark_helpers_start_event.CreateManualEvent(FALSE);
+    if (!bgc_mark_helpers_start_event.IsValid())
+        return;
+
+    bgc_mark_helper_created_event.CreateAutoEvent(FALSE);
+    if (!bgc_mark_helper_created_event.IsValid())
+        goto cleanup;
+
+    bgc_mark_queue = new (nothrow) (uint8_t* [BGC_MARK_QUEUE_LENGTH]);
+    if (!bgc_mark_queue)
+        goto cleanup;
+
+    bgc_mark_helpers = new (nothrow) bgc_mark_helper [n_helpers];
+    if (!bgc_mark_helpers)
+        goto cleanup;
+
+    for (int i = 0; i < n_helpers; i++)
+    {
+        bgc_mark_helper* helper = &bgc_mark_helpers[i];
+        helper->thread = 0;
+        helper->stack = new (nothrow) (uint8_t* [BGC_MARK_HELPER_STACK_LENGTH]);
+        if (!helper->stack)
+        {
+            // Go with the helpers we have stacks for.
+            n_helpers = i;
+            break;
+        }
+        helper->tos = helper->stack;
+        helper->session = 0;
+        helper->min_overflow_address = MAX_PTR;
+        helper->max_overflow_address = 0;
+        helper->overflow_count = 0;
+        helper->promoted_bytes = 0;
+    }
+
+    if (n_helpers > 0)
+    {
+        n_bgc_mark_helpers = n_helpers;
+        dprintf (2, ("%d background mark helpers", n_bgc_mark_helpers));
+        return;
+    }
+
+cleanup:
+    if (bgc_mark_helpers)
+    {
+        delete [] bgc_mark_helpers;
+        bgc_mark_helpers = 0;
+    }
+    if (bgc_mark_queue)
+    {
+        delete [] bgc_mark_queue;
+        bgc_mark_queue = 0;
+    }
+    if (bgc_mark_helper_created_event.IsValid())
+    {
+        bgc_mark_helper_created_event.CloseEvent();
+    }
+    bgc_mark_helpers_start_event.CloseEvent();
+}
+
+// Helpers are created the first time they are needed, the same way as the BGC thread,
+// and are kept around for the lifetime of the process.
+void gc_heap::create_bgc_mark_helpers()
+{
+#ifdef FEATURE_REDHAWK
+    while (n_bgc_mark_helpers_created < n_bgc_mark_helpers)
+    {
+        bgc_mark_helper* helper = &bgc_mark_helpers[n_bgc_mark_helpers_created];
+        if (!PalStartBackgroundGCThread(rh_bgc_mark_helper_stub, helper))
+        {
+            dprintf (2, ("failed to create background mark helper %d", n_bgc_mark_helpers_created));
+            break;
+        }
+
+        bgc_mark_helper_created_event.Wait(INFINITE, FALSE);
+        n_bgc_mark_helpers_created++;
+    }
+#endif //FEATURE_REDHAWK
+}
+
+#ifdef _MSC_VER
+#pragma warning(push)
+#pragma warning(disable:4702) // C4702: unreachable code: bgc_mark_helper_function does not return
+#endif //_MSC_VER
+uint32_t __stdcall gc_heap::bgc_mark_helper_stub (void* arg)
+{
+    bgc_mark_helper* helper = (bgc_mark_helper*)arg;
+
+    ClrFlsSetThreadType (ThreadType_GC);
+    assert (helper->thread != NULL);
+    GCToEEInterface::SetGCSpecial(helper->thread);
+
+#ifndef NO_CATCH_HANDLERS
+    PAL_TRY
+    {
+#endif // NO_CATCH_HANDLERS
+        bgc_mark_helper_function (helper);
+        return 0;
+
+#ifndef NO_CATCH_HANDLERS
+    }
+    PAL_EXCEPT_FILTER(GCUnhandledExceptionFilter, NULL)
+    {
+        ASSERTE(!"Exception caught escaping out of the background mark helper!");
+        EEPOLICY_HANDLE_FATAL_ERROR(CORINFO_EXCEPTION_GC);
+    }
+    PAL_ENDTRY;
+#endif // NO_CATCH_HANDLERS
+}
+#ifdef _MSC_VER
+#pragma warning(pop)
+#endif //_MSC_VER
+
+void gc_heap::bgc_mark_helper_function (bgc_mark_helper* helper)
+{
+    Thread* current_thread = GetThread();
+
+    bgc_mark_helper_created_event.Set();
+
+    while (1)
+    {
+        enable_preemptive (current_thread);
+        bgc_mark_helpers_start_event.Wait(INFINITE, FALSE);
+        disable_preemptive (current_thread, TRUE);
+
+        // We may have woken up after the session we were started for is already over, in
+        // which case the start event has been reset and we just go back to waiting.
+        if (!join_bgc_parallel_mark (helper))
+            continue;
+
+        dprintf (3, ("background mark helper joined session %Id", helper->session));
+
+        while (bgc_mark_helper_get_work (helper))
+        {
+            while (helper->tos != helper->stack)
+            {
+                uint8_t* oo = *(--helper->tos);
+                bgc_mark_helper_scan (helper, oo);
+
+                if (bgc_mark_helpers_idle > 0)
+                {
+                    share_bgc_mark_stack (helper->tos, helper->stack);
+                }
+
+                if (GCToEEInterface::CatchAtSafePoint(current_thread))
+                {
+                    // Let the foreground GC in, it will scan our stack.
+                    enable_preemptive (current_thread);
+                    disable_preemptive (current_thread, TRUE);
+                }
+            }
+        }
+    }
 }
 
+BOOL gc_heap::join_bgc_parallel_mark (bgc_mark_helper* helper)
+{
+    BOOL joined_p = FALSE;
+
+    enter_spin_lock (&bgc_mark_queue_lock);
+    if (bgc_parallel_mark_p && (helper->session != bgc_parallel_mark_session))
+    {
+        helper->session = bgc_parallel_mark_session;
+        helper->tos = helper->stack;
+        helper->min_overflow_address = MAX_PTR;
+        helper->max_overflow_address = 0;
+        helper->overflow_count = 0;
+        helper->promoted_bytes = 0;
+        bgc_mark_helpers_joined++;
+        joined_p = TRUE;
+    }
+    leave_spin_lock (&bgc_mark_queue_lock);
+
+    return joined_p;
+}
+
+// Called by a helper that ran out of work. Moves a chunk of entries from the shared queue
+// onto its stack and returns TRUE, or returns FALSE once the session is over. The helper
+// is counted as idle until it gets more work.
+BOOL gc_heap::bgc_mark_helper_get_work (bgc_mark_helper* helper)
+{
+    Thread* current_thread = GetThread();
+    int spin_count = 0;
+
+    assert (helper->tos == helper->stack);
+
+    enter_spin_lock (&bgc_mark_queue_lock);
+    if (!bgc_parallel_mark_p || (helper->session != bgc_parallel_mark_session))
+    {
+        leave_spin_lock (&bgc_mark_queue_lock);
+        return FALSE;
+    }
+    bgc_mark_helpers_idle++;
+    leave_spin_lock (&bgc_mark_queue_lock);
+
+    while (1)
+    {
+        if ((bgc_mark_queue_count > 0) || !bgc_parallel_mark_p || 
+            (helper->session != bgc_parallel_mark_session))
+        {
+            enter_spin_lock (&bgc_mark_queue_lock);
+
+            if (!bgc_parallel_mark_p || (helper->session != bgc_parallel_mark_session))
+            {
+                leave_spin_lock (&bgc_mark_queue_lock);
+                return FALSE;
+            }
+
+            size_t n = min ((size_t)bgc_mark_queue_count, (size_t)BGC_MARK_SHARE_CHUNK);
+            if (n > 0)
+            {
+                bgc_mark_queue_count -= n;
+                memcpy (helper->stack, &bgc_mark_queue[bgc_mark_queue_count], n * sizeof (uint8_t*));
+                helper->tos = helper->stack + n;
+                bgc_mark_helpers_idle--;
+                leave_spin_lock (&bgc_mark_queue_lock);
+                return TRUE;
+            }
+
+            leave_spin_lock (&bgc_mark_queue_lock);
+        }
+
+        // Nothing to do right now - wait in preemptive mode so we don't hold up foreground GCs.
+        enable_preemptive (current_thread);
+        if (++spin_count < 64)
+        {
+            GCToOSInterface::YieldThread (0);
+        }
+        else
+        {
+            GCToOSInterface::Sleep (1);
+        }
+        disable_preemptive (current_thread, TRUE);
+    }
+}
+
+void gc_heap::bgc_mark_helper_scan (bgc_mark_helper* helper, uint8_t* oo)
+{
+    uint8_t** mark_stack_limit = &helper->stack[BGC_MARK_HELPER_STACK_LENGTH];
+    size_t s = size (oo);
+
+    if (helper->tos + s / sizeof (uint8_t*) >= (mark_stack_limit - 1))
+    {
+        size_t num_components = ((method_table(oo))->HasComponentSize() ? ((CObjectHeader*)oo)->GetNumComponents() : 0);
+        size_t num_pointers = CGCDesc::GetNumPointers(method_table(oo), s, num_components);
+        if (helper->tos + num_pointers >= (mark_stack_limit - 1))
+        {
+            dprintf (3,("mark helper stack overflow for object %Ix ", (size_t)oo));
+            helper->overflow_count++;
+            helper->min_overflow_address = min (helper->min_overflow_address, oo);
+            helper->max_overflow_address = max (helper->max_overflow_address, oo);
+            return;
+        }
+    }
+
+    go_through_object_cl (method_table(oo), oo, s, ppslot,
+    {
+        uint8_t* o = *ppslot;
+        Prefetch(o);
+        if (background_mark (o, 
+                             background_saved_lowest_address, 
+                             background_saved_highest_address))
+        {
+            helper->promoted_bytes += size (o);
+            if (contain_pointers_or_collectible (o))
+            {
+                *(helper->tos++) = o;
+            }
+#ifdef BGC_STRING_DEDUP_STATS
+            else if (string_dedup_budget_left != 0)
+            {
+                record_string_dedup (o);
+            }
+#endif //BGC_STRING_DEDUP_STATS
+        }
+    }
+        );
+}
+
+// Moves up to half of the plain entries at the top of a mark stack to the shared queue.
+// Partial mark pairs and anything below them stay where they are.
+void gc_heap::share_bgc_mark_stack (uint8_t**& tos, uint8_t** stack)
+{
+    if ((tos - stack) < 2)
+        return;
+
+    enter_spin_lock (&bgc_mark_queue_lock);
+
+    size_t n = min ((size_t)(tos - stack) / 2, (size_t)BGC_MARK_SHARE_CHUNK);
+    n = min (n, (size_t)(BGC_MARK_QUEUE_LENGTH - bgc_mark_queue_count));
+
+    for (size_t i = 0; i < n; i++)
+    {
+        uint8_t* o = *(tos - 1);
+        if ((size_t)o & 1)
+            break;
+
+        tos--;
+        // Finished partial mark pairs leave 0s behind.
+        if (o)
+        {
+            bgc_mark_queue[bgc_mark_queue_count++] = o;
+        }
+    }
+
+    leave_spin_lock (&bgc_mark_queue_lock);
+}
+
+void gc_heap::begin_bgc_parallel_mark()
+{
+    if (n_bgc_mark_helpers_created == 0)
+        return;
+
+    enter_spin_lock (&bgc_mark_queue_lock);
+    assert (bgc_mark_queue_count == 0);
+    bgc_parallel_mark_session++;
+    bgc_mark_helpers_joined = 0;
+    bgc_mark_helpers_idle = 0;
+    bgc_parallel_mark_p = TRUE;
+    leave_spin_lock (&bgc_mark_queue_lock);
+
+    dprintf (2, ("starting background mark session %Id", bgc_parallel_mark_session));
+    bgc_mark_helpers_start_event.Set();
+}
+
+// Called by the BGC thread once its own mark stack is empty. Helps with whatever is
+// left in the shared queue and ends the session once all helpers are out of work.
+void gc_heap::end_bgc_parallel_mark()
+{
+    if (n_bgc_mark_helpers_created == 0)
+        return;
+
+    // Helpers that haven't woken up yet won't join anymore.
+    bgc_mark_helpers_start_event.Reset();
+
+    while (1)
+    {
+        uint8_t* o = 0;
+
+        enter_spin_lock (&bgc_mark_queue_lock);
+        if (bgc_mark_queue_count > 0)
+        {
+            o = bgc_mark_queue[--bgc_mark_queue_count];
+        }
+        else if (bgc_mark_helpers_idle == bgc_mark_helpers_joined)
+        {
+            bgc_parallel_mark_p = FALSE;
+            leave_spin_lock (&bgc_mark_queue_lock);
+            break;
+        }
+        leave_spin_lock (&bgc_mark_queue_lock);
+
+        if (o)
+        {
+            background_mark_simple1 (o THREAD_NUMBER_ARG);
+        }
+        else
+        {
+            allow_fgc();
+            GCToOSInterface::YieldThread (0);
+        }
+    }
+
+    // All helpers that joined are idle with empty stacks now so their counters are final.
+    for (int i = 0; i < n_bgc_mark_helpers_created; i++)
+    {
+        bgc_mark_helper* helper = &bgc_mark_helpers[i];
+        if (helper->session != bgc_parallel_mark_session)
+            continue;
+
+        assert (helper->tos == helper->stack);
+        bpromoted_bytes (heap_number) += helper->promoted_bytes;
+        if (helper->overflow_count)
+        {
+            bgc_overflow_count += helper->overflow_count;
+            background_min_overflow_address = min (background_min_overflow_address, helper->min_overflow_address);
+            background_max_overflow_address = max (background_max_overflow_address, helper->max_overflow_address);
+        }
+    }
+
+    dprintf (2, ("background mark session %Id done, %d helpers joined", 
+        bgc_parallel_mark_session, bgc_mark_helpers_joined));
+}
+
+// Reports what's on the helpers' stacks and in the shared queue to a foreground GC.
+void gc_heap::scan_bgc_parallel_mark_roots (promote_func* fn, ScanContext* pSC)
+{
+    if (n_bgc_mark_helpers_created == 0)
+        return;
+
+    for (size_t i = 0; i < bgc_mark_queue_count; i++)
+    {
+        dprintf(3,("background root %Ix", (size_t)bgc_mark_queue[i]));
+        (*fn) ((Object**)&bgc_mark_queue[i], pSC, 0);
+    }
+
+    for (int i = 0; i < n_bgc_mark_helpers_created; i++)
+    {
+        bgc_mark_helper* helper = &bgc_mark_helpers[i];
+        for (uint8_t** finger = helper->stack; finger < helper->tos; finger++)
+        {
+            dprintf(3,("background root %Ix", (size_t)*finger));
+            (*fn) ((Object**)finger, pSC, 0);
+        }
+    }
+}
+
+#endif //BGC_PARALLEL_MARK
+
 #endif //BACKGROUND_GC
 
 
@@ -18875,12 +19989,19 @@ recheck:
         if ((mark_stack_array_length < new_size) && 
             ((new_size - mark_stack_array_length) > (mark_stack_array_length / 2)))
         {
-            mark* tmp = new (nothrow) mark [new_size];
-            if (tmp)
+            if (mark_stack_array_reserved_length != 0)
             {
-                delete mark_stack_array;
-                mark_stack_array = tmp;
-                mark_stack_array_length = new_size;
+                grow_mark_stack_in_place (new_size);
+            }
+            else
+            {
+                mark* tmp = new (nothrow) mark [new_size];
+                if (tmp)
+                {
+                    delete mark_stack_array;
+                    mark_stack_array = tmp;
+                    mark_stack_array_length = new_size;
+                }
             }
         }
 
@@ -18888,6 +20009,9 @@ recheck:
         uint8_t*  max_add = max_overflow_address;
         max_overflow_address = 0;
         min_overflow_address = MAX_PTR;
+        mark_overflow_rescan_count++;
+        dprintf (2, ("h%d: rescanning [%Ix, %Ix] for mark stack overflow, %Id objects overflowed so far", 
+            heap_number, (size_t)min_add, (size_t)max_add, mark_stack_overflow_count));
         process_mark_overflow_internal (condemned_gen_number, min_add, max_add);
         goto recheck;
     }
@@ -20551,6 +21675,69 @@ BOOL gc_heap::should_compact_loh()
     return (loh_compaction_always_p || (loh_compaction_mode != loh_compaction_default));
 }
 
+// Returns the size of the largest item on this heap's LOH free list. The allocator buckets are
+// ordered by size so only the highest non empty bucket needs to be walked.
+size_t gc_heap::loh_largest_free_item()
+{
+    allocator* loh_allocator = generation_allocator (generation_of (max_generation + 1));
+
+    for (int bn = (int)loh_allocator->number_of_buckets() - 1; bn >= 0; bn--)
+    {
+        uint8_t* free_item = loh_allocator->alloc_list_head_of ((unsigned int)bn);
+        if (free_item)
+        {
+            size_t largest = 0;
+            while (free_item)
+            {
+                largest = max (largest, unused_array_size (free_item));
+                free_item = free_list_slot (free_item);
+            }
+            return largest;
+        }
+    }
+
+    return 0;
+}
+
+// Decides whether a blocking gen2 GC should also compact the LOH because it has become too
+// fragmented. We compact when the free space is both large in absolute terms and a large
+// enough portion of the LOH to pay for copying the survivors, and it is scattered, ie, the
+// largest free item is only a small part of it - one big hole is still perfectly usable.
+BOOL gc_heap::should_compact_loh_for_fragmentation()
+{
+    if (loh_compaction_frag_pct == 0)
+    {
+        return FALSE;
+    }
+
+    size_t loh_size = 0;
+    size_t loh_frag = 0;
+    size_t largest_free = 0;
+
+#ifdef MULTIPLE_HEAPS
+    for (int i = 0; i < n_heaps; i++)
+    {
+        gc_heap* hp = g_heaps[i];
+#else //MULTIPLE_HEAPS
+    {
+        gc_heap* hp = pGenGCHeap;
+#endif //MULTIPLE_HEAPS
+        generation* loh = hp->generation_of (max_generation + 1);
+        loh_size += hp->generation_size (max_generation + 1);
+        loh_frag += generation_free_list_space (loh) + generation_free_obj_space (loh);
+        largest_free = max (largest_free, hp->loh_largest_free_item());
+    }
+
+    BOOL compact_p = ((loh_frag >= loh_compaction_min_frag) &&
+                      ((uint64_t)loh_frag * 100 >= (uint64_t)loh_size * loh_compaction_frag_pct) &&
+                      ((uint64_t)largest_free * 100 < (uint64_t)loh_frag * loh_compaction_largest_free_pct));
+
+    dprintf (GTC_LOG, ("LOH size: %Id, frag: %Id, largest free: %Id -> %s LOH", 
+        loh_size, loh_frag, largest_free, (compact_p ? "compacting" : "not compacting")));
+
+    return compact_p;
+}
+
 inline
 void gc_heap::check_loh_compact_mode (BOOL all_heaps_compacted_p)
 {
@@ -21492,7 +22679,7 @@ void gc_heap::plan_phase (int condemned_gen_number)
 
                     dprintf(4, ("+%Ix+", (size_t)xl));
                     assert ((size (xl) > 0));
-                    assert ((size (xl) <= LARGE_OBJECT_SIZE));
+                    assert ((size (xl) <= loh_size_threshold));
 
                     last_object_in_plug = xl;
 
@@ -22096,7 +23283,8 @@ void gc_heap::plan_phase (int condemned_gen_number)
             if (plan_loh())
             {
                 should_compact = TRUE;
-                get_gc_data_per_heap()->set_mechanism (gc_heap_compact, compact_loh_forced);
+                get_gc_data_per_heap()->set_mechanism (gc_heap_compact, 
+                    (should_compact_loh() ? compact_loh_forced : compact_loh_frag));
                 loh_compacted_p = TRUE;
             }
         }
@@ -25554,6 +26742,14 @@ void gc_heap::background_mark_phase ()
 
         disable_preemptive (current_thread, TRUE);
 
+#ifdef BGC_STRING_DEDUP_STATS
+        begin_string_dedup_stats();
+#endif //BGC_STRING_DEDUP_STATS
+
+#ifdef BGC_PARALLEL_MARK
+        begin_bgc_parallel_mark();
+#endif //BGC_PARALLEL_MARK
+
         if (num_sizedrefs > 0)
         {
             GCScan::GcScanSizedRefs(background_promote, max_generation, max_generation, &sc);
@@ -25591,6 +26787,12 @@ void gc_heap::background_mark_phase ()
         //concurrent_print_time_delta ("concurrent marking dirtied pages on LOH");
         concurrent_print_time_delta ("CRre");
 
+#ifdef BGC_PARALLEL_MARK
+        // The overflow processing below needs the helpers' overflow ranges.
+        end_bgc_parallel_mark();
+        concurrent_print_time_delta ("CRpm");
+#endif //BGC_PARALLEL_MARK
+
         enable_preemptive (current_thread);
 
 #ifdef MULTIPLE_HEAPS
@@ -25883,6 +27085,10 @@ void gc_heap::background_mark_phase ()
         mark_time = finish - start;
 #endif //TIME_GC
 
+#ifdef BGC_STRING_DEDUP_STATS
+    end_string_dedup_stats();
+#endif //BGC_STRING_DEDUP_STATS
+
     dprintf (2, ("end of bgc mark: gen2 free list space: %d, free obj space: %d", 
         generation_free_list_space (generation_of (max_generation)), 
         generation_free_obj_space (generation_of (max_generation))));
@@ -26397,7 +27603,7 @@ void gc_heap::background_promote_callback (Object** ppObject, ScanContext* sc,
 #endif //_DEBUG
 
     dprintf (3, ("Concurrent Background Promote %Ix", (size_t)o));
-    if (o && (size (o) > LARGE_OBJECT_SIZE))
+    if (o && (size (o) > loh_size_threshold))
     {
         dprintf (3, ("Brc %Ix", (size_t)o));
     }
@@ -26568,6 +27774,10 @@ BOOL gc_heap::create_bgc_threads_support (int number_of_heaps)
     UNREFERENCED_PARAMETER(number_of_heaps);
 #endif //MULTIPLE_HEAPS
 
+#ifdef BGC_PARALLEL_MARK
+    init_bgc_parallel_mark();
+#endif //BGC_PARALLEL_MARK
+
     ret = TRUE;
 
 cleanup:
@@ -26621,6 +27831,10 @@ BOOL gc_heap::create_bgc_thread_support()
 
     make_c_mark_list (parr);
 
+#ifdef BGC_STRING_DEDUP_STATS
+    init_string_dedup_stats();
+#endif //BGC_STRING_DEDUP_STATS
+
     ret = TRUE;
 
 cleanup:
@@ -33828,7 +35042,7 @@ void GCHeap::Relocate (Object** ppObject, ScanContext* sc,
     // For now we simply look at the size of the object to determine if it in the
     // fixed heap or not. If the bit indicating this gets set at some point
     // we should key off that instead.
-    return size( pObj ) >= LARGE_OBJECT_SIZE;
+    return size( pObj ) >= gc_heap::loh_size_threshold;
 }
 
 #ifndef FEATURE_REDHAWK // Redhawk forces relocation a different way
@@ -34151,7 +35365,7 @@ GCHeap::Alloc( size_t size, uint32_t flags REQD_ALIGN_DCL)
 
         alloc_context* acontext = 0;
 
-        if (size < LARGE_OBJECT_SIZE)
+        if (size < gc_heap::loh_size_threshold)
         {
             acontext = generation_alloc_context (hp->generation_of (0));
 
@@ -34295,7 +35509,7 @@ GCHeap::AllocAlign8Common(void* _hp, alloc_context* acontext, size_t size, uint3
     GCStress<gc_on_alloc>::MaybeTrigger(acontext);
 #endif // FEATURE_REDHAWK
 
-    if (size < LARGE_OBJECT_SIZE)
+    if (size < gc_heap::loh_size_threshold)
     {
 #ifdef TRACE_GC
         AllocSmallCount++;
@@ -34508,7 +35722,7 @@ GCHeap::Alloc(alloc_context* acontext, size_t size, uint32_t flags REQD_ALIGN_DC
 #endif //_PREFAST_
 #endif //MULTIPLE_HEAPS
 
-    if (size < LARGE_OBJECT_SIZE)
+    if (size < gc_heap::loh_size_threshold)
     {
 
 #ifdef TRACE_GC
@@ -34989,6 +36203,11 @@ void gc_heap::do_post_gc()
     
     GCToEEInterface::GcDone(settings.condemned_generation);
 
+    if (!settings.concurrent && (segment_standby_list != 0) && (segment_standby_max_age != SIZE_T_MAX))
+    {
+        release_aged_standby_segments();
+    }
+
 #ifdef GC_PROFILING
     if (!settings.concurrent)
     {
@@ -35269,6 +36488,11 @@ size_t      GCHeap::GetTotalBytesInUse ()
 #endif //MULTIPLE_HEAPS
 }
 
+size_t      GCHeap::GetApproxTotalBytesInUse ()
+{
+    return gc_heap::get_total_current_size();
+}
+
 int GCHeap::CollectionCount (int generation, int get_bgc_fgc_count)
 {
     if (get_bgc_fgc_count != 0)
@@ -35465,6 +36689,121 @@ void GCHeap::SetLOHCompactionMode (int newLOHCompactionyMode)
 #endif //FEATURE_LOH_COMPACTION
 }
 
+size_t GCHeap::GetLOHThreshold()
+{
+    return gc_heap::loh_size_threshold;
+}
+
+void GCHeap::GetMarkStackOverflowStats(size_t* overflowCount, size_t* rescanCount)
+{
+    *overflowCount = 0;
+    *rescanCount = 0;
+
+#ifdef MULTIPLE_HEAPS
+    for (int i = 0; i < gc_heap::n_heaps; i++)
+    {
+        gc_heap* hp = gc_heap::g_heaps[i];
+#else
+    {
+        gc_heap* hp = pGenGCHeap;
+#endif //MULTIPLE_HEAPS
+        *overflowCount += hp->mark_stack_overflow_count;
+        *rescanCount += hp->mark_overflow_rescan_count;
+    }
+}
+
+void GCHeap::GetSegmentStandbyStats(size_t* hitCount, size_t* missCount, size_t* releasedCount)
+{
+    *hitCount = gc_heap::segment_standby_hits;
+    *missCount = gc_heap::segment_standby_misses;
+    *releasedCount = gc_heap::segment_standby_released;
+}
+
+// Threads run on separate stacks, so when the processor number isn't available the stack address
+// still spreads them over the counters.
+inline
+memory_pressure_counter* get_memory_pressure_counter (memory_pressure_counter* counters)
+{
+    if (GCToOSInterface::CanGetCurrentProcessorNumber())
+        return &counters[GCToOSInterface::GetCurrentProcessorNumber() % max_memory_pressure_counters];
+
+    uint8_t stack_marker;
+    uint32_t hash = (uint32_t)((size_t)&stack_marker >> 16) * 2654435769u;
+    return &counters[(hash >> 16) % max_memory_pressure_counters];
+}
+
+inline
+ptrdiff_t get_memory_pressure_bytes (size_t bytes)
+{
+    return (ptrdiff_t)min (bytes, (size_t)SSIZE_T_MAX);
+}
+
+int GCHeap::AddMemoryPressure(size_t bytes)
+{
+    ptrdiff_t add_bytes = get_memory_pressure_bytes (bytes);
+    memory_pressure_counter* counter = get_memory_pressure_counter (gc_heap::memory_pressure_counters);
+
+    ptrdiff_t old_bytes = Interlocked::ExchangeAddPtr (&counter->net_bytes, add_bytes);
+    // Saturate rather than overflow, the counter itself wraps like any interlocked add.
+    ptrdiff_t new_bytes = (old_bytes > SSIZE_T_MAX - add_bytes) ? SSIZE_T_MAX : (old_bytes + add_bytes);
+
+    // Adding up the counters and looking at the budgets is left for every so often.
+    if ((new_bytes >> memory_pressure_check_shift) == (old_bytes >> memory_pressure_check_shift))
+        return -1;
+
+    // Collecting would end the region.
+    if (gc_heap::settings.pause_mode == pause_no_gc)
+        return -1;
+
+    int gen_number = gc_heap::generation_exhausted_by_memory_pressure ();
+    return ((gen_number > 0) ? gen_number : -1);
+}
+
+void GCHeap::RemoveMemoryPressure(size_t bytes)
+{
+    ptrdiff_t remove_bytes = get_memory_pressure_bytes (bytes);
+    memory_pressure_counter* counter = get_memory_pressure_counter (gc_heap::memory_pressure_counters);
+
+    Interlocked::ExchangeAddPtr (&counter->net_bytes, -remove_bytes);
+}
+
+size_t GCHeap::GetMemoryPressure()
+{
+    return gc_heap::get_memory_pressure ();
+}
+
+BOOL GCHeap::GetStringDedupStats(string_dedup_stats* stats)
+{
+#ifdef BGC_STRING_DEDUP_STATS
+    if (gc_heap::string_dedup_budget == 0)
+        return FALSE;
+
+    memset (stats, 0, sizeof (*stats));
+
+#ifdef MULTIPLE_HEAPS
+    for (int i = 0; i < gc_heap::n_heaps; i++)
+    {
+        gc_heap* hp = gc_heap::g_heaps[i];
+#else
+    {
+        gc_heap* hp = pGenGCHeap;
+#endif //MULTIPLE_HEAPS
+        stats->sampled_count += hp->string_dedup_last.sampled_count;
+        stats->sampled_bytes += hp->string_dedup_last.sampled_bytes;
+        for (int j = 0; j < STRING_DEDUP_LENGTH_BUCKETS; j++)
+        {
+            stats->dup_count[j] += hp->string_dedup_last.dup_count[j];
+            stats->dup_bytes[j] += hp->string_dedup_last.dup_bytes[j];
+        }
+    }
+
+    return TRUE;
+#else
+    UNREFERENCED_PARAMETER(stats);
+    return FALSE;
+#endif //BGC_STRING_DEDUP_STATS
+}
+
 BOOL GCHeap::RegisterForFullGCNotification(uint32_t gen2Percentage,
                                            uint32_t lohPercentage)
 {
@@ -35539,6 +36878,27 @@ int GCHeap::EndNoGCRegion()
     return (int)gc_heap::end_no_gc_region();
 }
 
+// Returns end_no_gc_success while a no gc region is in progress and no GC has happened in it yet; otherwise
+// returns the status that EndNoGCRegion would return.
+int GCHeap::GetNoGCRegionStatus()
+{
+    return (int)gc_heap::get_no_gc_region_status();
+}
+
+// The next time acontext needs more space during the current no gc region, it will be given all of the SOH 
+// budget reserved for the region instead of the usual allocation quantum.
+void GCHeap::PresizeAllocContextForNoGCRegion(alloc_context* acontext)
+{
+    AllocLockHolder lh;
+
+    if (gc_heap::current_no_gc_region_info.started && 
+        (gc_heap::settings.pause_mode == pause_no_gc) &&
+        (gc_heap::current_no_gc_region_info.soh_allocation_size != 0))
+    {
+        gc_heap::current_no_gc_region_info.presize_acontext = acontext;
+    }
+}
+
 void GCHeap::PublishObject (uint8_t* Obj)
 {
 #ifdef BACKGROUND_GC
@@ -105,6 +105,8 @@ class Object;
 class GCHeap;
 
 /* misc defines */
+// Objects at least this big are allocated on the LOH. The threshold can be raised (but not
+// lowered) at startup, see GCHeap::GetLOHThreshold.
 #define LARGE_OBJECT_SIZE ((size_t)(85000))
 
 GPTR_DECL(GCHeap, g_pGCHeap);
@@ -325,6 +327,18 @@ enum end_no_gc_region_status
     end_no_gc_alloc_exceeded = 3
 };
 
+// Duplicate gen2 strings found during the last background GC, see GCStringDedupStatsMB.
+// Bucket i counts strings of [2^i, 2^(i+1)) characters, the last bucket everything longer.
+#define STRING_DEDUP_LENGTH_BUCKETS 16
+
+struct string_dedup_stats
+{
+    size_t sampled_count;
+    size_t sampled_bytes;
+    size_t dup_count[STRING_DEDUP_LENGTH_BUCKETS];
+    size_t dup_bytes[STRING_DEDUP_LENGTH_BUCKETS];
+};
+
 enum bgc_state
 {
     bgc_not_in_process = 0,
@@ -593,6 +607,18 @@ public:
 
     virtual int GetLOHCompactionMode() = 0;
     virtual void SetLOHCompactionMode(int newLOHCompactionyMode) = 0;
+    virtual size_t GetLOHThreshold() = 0;
+
+    virtual BOOL GetStringDedupStats(string_dedup_stats* stats) = 0;
+
+    // Number of objects marking couldn't push on the mark stack and number of times the GC
+    // had to rescan the heap for them, since startup.
+    virtual void GetMarkStackOverflowStats(size_t* overflowCount, size_t* rescanCount) = 0;
+
+    // Number of new segments served from the standby list of freed segments, number that had
+    // to reserve fresh address space instead, and number released from the list after aging
+    // out, since startup.
+    virtual void GetSegmentStandbyStats(size_t* hitCount, size_t* missCount, size_t* releasedCount) = 0;
 
     virtual BOOL RegisterForFullGCNotification(uint32_t gen2Percentage,
                                                uint32_t lohPercentage) = 0;
@@ -602,9 +628,20 @@ public:
 
     virtual int StartNoGCRegion(uint64_t totalSize, BOOL lohSizeKnown, uint64_t lohSize, BOOL disallowFullBlockingGC) = 0;
     virtual int EndNoGCRegion() = 0;
+    virtual int GetNoGCRegionStatus() = 0;
+    virtual void PresizeAllocContextForNoGCRegion(alloc_context* acontext) = 0;
+
+    // Unmanaged memory kept alive by managed objects. Growth of the registered total since a generation
+    // was last collected is charged against the allocation budget of generations 1 and up.
+    // AddMemoryPressure returns the generation that should be collected because of it, or -1.
+    virtual int AddMemoryPressure(size_t bytes) = 0;
+    virtual void RemoveMemoryPressure(size_t bytes) = 0;
+    virtual size_t GetMemoryPressure() = 0;
 
     virtual BOOL IsObjectInFixedHeap(Object *pObj) = 0;
     virtual size_t  GetTotalBytesInUse () = 0;
+    // Like GetTotalBytesInUse, but computed from the generation budgets without taking the gc lock.
+    virtual size_t  GetApproxTotalBytesInUse () = 0;
     virtual size_t  GetCurrentObjSize() = 0;
     virtual size_t  GetLastGCStartTime(int generation) = 0;
     virtual size_t  GetLastGCDuration(int generation) = 0;
@@ -620,7 +657,7 @@ public:
     static BOOL IsLargeObject(MethodTable *mt) {
         WRAPPER_NO_CONTRACT;
 
-        return mt->GetBaseSize() >= LARGE_OBJECT_SIZE;
+        return mt->GetBaseSize() >= GetGCHeap()->GetLOHThreshold();
     }
 
     static unsigned GetMaxGeneration() {
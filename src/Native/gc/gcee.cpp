@@ -807,6 +807,21 @@ uint32_t WINAPI gc_heap::rh_bgc_thread_stub(void * pContext)
     return pStartContext->m_pRealStartRoutine(pStartContext->m_pRealContext);
 }
 
+#ifdef BGC_PARALLEL_MARK
+uint32_t WINAPI gc_heap::rh_bgc_mark_helper_stub(void * pContext)
+{
+    bgc_mark_helper * pHelper = (bgc_mark_helper*)pContext;
+
+    // Helpers are created during a garbage collection as well, see rh_bgc_thread_stub.
+    ASSERT(GCHeap::GetGCHeap()->IsGCInProgress());
+    GCToEEInterface::AttachCurrentThread();
+
+    pHelper->thread = GetThread();
+
+    return bgc_mark_helper_stub(pHelper);
+}
+#endif // BGC_PARALLEL_MARK
+
 #endif // BACKGROUND_GC && FEATURE_REDHAWK
 
 #ifdef FEATURE_BASICFREEZE
@@ -90,6 +90,8 @@ public:
     PER_HEAP_ISOLATED   HRESULT Shutdown ();
 
     size_t  GetTotalBytesInUse ();
+    // Gets an estimate of GetTotalBytesInUse without taking the gc lock.
+    size_t  GetApproxTotalBytesInUse ();
     // Gets the amount of bytes objects currently occupy on the GC heap.
     size_t  GetCurrentObjSize();
 
@@ -191,6 +193,17 @@ public:
 
     int GetLOHCompactionMode();
     void SetLOHCompactionMode(int newLOHCompactionyMode);
+    size_t GetLOHThreshold();
+
+    BOOL GetStringDedupStats(string_dedup_stats* stats);
+
+    void GetMarkStackOverflowStats(size_t* overflowCount, size_t* rescanCount);
+
+    void GetSegmentStandbyStats(size_t* hitCount, size_t* missCount, size_t* releasedCount);
+
+    int AddMemoryPressure(size_t bytes);
+    void RemoveMemoryPressure(size_t bytes);
+    size_t GetMemoryPressure();
 
     BOOL RegisterForFullGCNotification(uint32_t gen2Percentage,
                                        uint32_t lohPercentage);
@@ -200,6 +213,8 @@ public:
 
     int StartNoGCRegion(uint64_t totalSize, BOOL lohSizeKnown, uint64_t lohSize, BOOL disallowFullBlockingGC);
     int EndNoGCRegion();
+    int GetNoGCRegionStatus();
+    void PresizeAllocContextForNoGCRegion(alloc_context* acontext);
 
     PER_HEAP_ISOLATED     unsigned GetMaxGeneration();
  
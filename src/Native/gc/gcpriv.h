@@ -71,6 +71,14 @@ inline void FATAL_GC_ERROR()
 
 #define BACKGROUND_GC   //concurrent background GC (requires WRITE_WATCH)
 
+#if defined(BACKGROUND_GC) && !defined(SERVER_GC)
+#define BGC_PARALLEL_MARK //share the concurrent part of background marking with helper threads
+#endif //BACKGROUND_GC && !SERVER_GC
+
+#ifdef BACKGROUND_GC
+#define BGC_STRING_DEDUP_STATS //sample gen2 strings for duplicates during background marking
+#endif //BACKGROUND_GC
+
 #ifdef SERVER_GC
 #define MH_SC_MARK //scalable marking
 //#define SNOOP_STATS //diagnostic
@@ -987,6 +995,19 @@ struct spinlock_info
 
 const unsigned HS_CACHE_LINE_SIZE = 128;
 
+// Net unmanaged memory registered through GCHeap::AddMemoryPressure and RemoveMemoryPressure, in
+// bytes. There is one counter per processor so threads registering at the same time don't contend on
+// a cache line; they are only added up when the total is needed.
+struct memory_pressure_counter
+{
+    ptrdiff_t net_bytes;
+    uint8_t cache_separator[HS_CACHE_LINE_SIZE - sizeof (ptrdiff_t)];
+};
+
+const int max_memory_pressure_counters = 64;
+// Budgets are checked each time a counter crosses a multiple of 1 << memory_pressure_check_shift bytes.
+const int memory_pressure_check_shift = 18;
+
 #ifdef SNOOP_STATS
 struct snoop_stats_data
 {
@@ -1055,8 +1076,27 @@ struct no_gc_region_info
     size_t saved_gen0_min_size;
     size_t saved_gen3_min_size;
     BOOL minimal_gc_p;
+    // the alloc context that gets the whole SOH budget on its next refill
+    alloc_context* presize_acontext;
 };
 
+#ifdef BGC_PARALLEL_MARK
+// State of one background mark helper thread. Helpers never do partial marking
+// so their mark stacks only ever contain plain object pointers.
+struct bgc_mark_helper
+{
+    Thread* thread;
+    uint8_t** stack;
+    uint8_t** tos;
+    // the marking session this helper last joined.
+    size_t session;
+    uint8_t* min_overflow_address;
+    uint8_t* max_overflow_address;
+    size_t overflow_count;
+    size_t promoted_bytes;
+};
+#endif //BGC_PARALLEL_MARK
+
 // if you change these, make sure you update them for sos (strike.cpp) as well.
 // 
 // !!!NOTE!!!
@@ -1403,6 +1443,9 @@ protected:
     PER_HEAP_ISOLATED
     start_no_gc_region_status get_start_no_gc_region_status();
 
+    PER_HEAP_ISOLATED
+    end_no_gc_region_status get_no_gc_region_status();
+
     PER_HEAP_ISOLATED
     end_no_gc_region_status end_no_gc_region();
 
@@ -1417,7 +1460,7 @@ protected:
 
     PER_HEAP
     size_t limit_from_size (size_t size, size_t room, int gen_number,
-                            int align_const);
+                            int align_const, alloc_context* acontext);
     PER_HEAP
     int try_allocate_more_space (alloc_context* acontext, size_t jsize,
                                  int alloc_generation_number);
@@ -1605,6 +1648,10 @@ protected:
     void init_heap_segment (heap_segment* seg);
     PER_HEAP
     void delete_heap_segment (heap_segment* seg, BOOL consider_hoarding=FALSE);
+    PER_HEAP_ISOLATED
+    void release_aged_standby_segments();
+    PER_HEAP
+    void release_standby_segment (heap_segment* seg);
 #ifdef FEATURE_BASICFREEZE
     PER_HEAP
     BOOL insert_ro_segment (heap_segment* seg);
@@ -1872,6 +1919,12 @@ protected:
     PER_HEAP
     ptrdiff_t  get_new_allocation (int gen_number);
     PER_HEAP
+    ptrdiff_t  get_new_allocation_with_pressure (int gen_number, size_t memory_pressure);
+    PER_HEAP_ISOLATED
+    size_t get_memory_pressure ();
+    PER_HEAP_ISOLATED
+    int generation_exhausted_by_memory_pressure ();
+    PER_HEAP
     ptrdiff_t  get_allocation (int gen_number);
     PER_HEAP
     bool new_allocation_allowed (int gen_number);
@@ -1918,6 +1971,18 @@ protected:
     BOOL pinned_plug_que_empty_p ();
     PER_HEAP
     void make_mark_stack (mark* arr);
+    PER_HEAP
+    mark* reserve_mark_stack();
+    PER_HEAP
+    BOOL grow_mark_stack_in_place (size_t new_length);
+    PER_HEAP
+    BOOL grow_mark_stack_array();
+    PER_HEAP
+    BOOL make_room_on_mark_stack (uint8_t** tos, size_t needed_slots);
+    PER_HEAP
+    void decommit_mark_stack();
+    PER_HEAP
+    void release_mark_stack();
 #ifdef MH_SC_MARK
     PER_HEAP
     int& mark_stack_busy();
@@ -1968,6 +2033,42 @@ protected:
     void background_mark_simple (uint8_t* o THREAD_NUMBER_DCL);
     PER_HEAP
     void background_mark_simple1 (uint8_t* o THREAD_NUMBER_DCL);
+#ifdef BGC_STRING_DEDUP_STATS
+    PER_HEAP
+    void init_string_dedup_stats();
+    PER_HEAP
+    void begin_string_dedup_stats();
+    PER_HEAP
+    void record_string_dedup (uint8_t* o);
+    PER_HEAP
+    void add_string_dedup_sample (uint8_t* o, size_t length);
+    PER_HEAP
+    void end_string_dedup_stats();
+#endif //BGC_STRING_DEDUP_STATS
+#ifdef BGC_PARALLEL_MARK
+    PER_HEAP_ISOLATED
+    void init_bgc_parallel_mark();
+    PER_HEAP_ISOLATED
+    void create_bgc_mark_helpers();
+    static
+    uint32_t __stdcall bgc_mark_helper_stub (void* arg);
+    PER_HEAP_ISOLATED
+    void bgc_mark_helper_function (bgc_mark_helper* helper);
+    PER_HEAP_ISOLATED
+    BOOL join_bgc_parallel_mark (bgc_mark_helper* helper);
+    PER_HEAP_ISOLATED
+    BOOL bgc_mark_helper_get_work (bgc_mark_helper* helper);
+    PER_HEAP_ISOLATED
+    void bgc_mark_helper_scan (bgc_mark_helper* helper, uint8_t* oo);
+    PER_HEAP_ISOLATED
+    void share_bgc_mark_stack (uint8_t**& tos, uint8_t** stack);
+    PER_HEAP_ISOLATED
+    void begin_bgc_parallel_mark();
+    PER_HEAP_ISOLATED
+    void end_bgc_parallel_mark();
+    PER_HEAP_ISOLATED
+    void scan_bgc_parallel_mark_roots (promote_func* fn, ScanContext* pSC);
+#endif //BGC_PARALLEL_MARK
     PER_HEAP_ISOLATED
     void background_promote (Object**, ScanContext* , uint32_t);
     PER_HEAP
@@ -2176,6 +2277,12 @@ protected:
     PER_HEAP_ISOLATED
     BOOL should_compact_loh();
 
+    PER_HEAP
+    size_t loh_largest_free_item();
+
+    PER_HEAP_ISOLATED
+    BOOL should_compact_loh_for_fragmentation();
+
     // If the LOH compaction mode is just to compact once,
     // we need to see if we should reset it back to not compact.
     // We would only reset if every heap's LOH was compacted.
@@ -2486,6 +2593,8 @@ protected:
     size_t get_current_allocated();
     PER_HEAP_ISOLATED
     size_t get_total_allocated();
+    PER_HEAP_ISOLATED
+    size_t get_total_current_size();
     PER_HEAP
     size_t current_generation_size (int gen_number);
     PER_HEAP
@@ -2732,6 +2841,11 @@ protected:
         PTHREAD_START_ROUTINE   m_pRealStartRoutine;
         gc_heap *               m_pRealContext;
     };
+
+#ifdef BGC_PARALLEL_MARK
+    // Same as above for background mark helper threads, the context is the helper's bgc_mark_helper.
+    static uint32_t WINAPI rh_bgc_mark_helper_stub(void * pContext);
+#endif //BGC_PARALLEL_MARK
 #endif //FEATURE_REDHAWK
 
 #endif //BACKGROUND_GC
@@ -3003,6 +3117,19 @@ protected:
     PER_HEAP
     mark*       mark_stack_array;
 
+    // If this is not 0 mark_stack_array is at the start of an address range
+    // reserved for this many entries and the stack grows in place.
+    PER_HEAP
+    size_t      mark_stack_array_reserved_length;
+
+    // How many objects marking had to leave to process_mark_overflow and how
+    // many times it rescanned an address range for them, since startup.
+    PER_HEAP
+    size_t      mark_stack_overflow_count;
+
+    PER_HEAP
+    size_t      mark_overflow_rescan_count;
+
     PER_HEAP
     BOOL       verify_pinned_queue_p;
 
@@ -3033,6 +3160,17 @@ protected:
     PER_HEAP_ISOLATED
     gc_loh_compaction_mode loh_compaction_mode;
 
+    // Thresholds for compacting the LOH when it gets fragmented, see 
+    // should_compact_loh_for_fragmentation. A zero percentage turns this off.
+    PER_HEAP_ISOLATED
+    uint32_t    loh_compaction_frag_pct;
+
+    PER_HEAP_ISOLATED
+    size_t      loh_compaction_min_frag;
+
+    PER_HEAP_ISOLATED
+    uint32_t    loh_compaction_largest_free_pct;
+
     // We may not compact LOH on every heap if we can't
     // grow the pinned queue. This is to indicate whether
     // this heap's LOH is compacted or not. So even if
@@ -3261,6 +3399,77 @@ protected:
 
     PER_HEAP
     size_t          c_mark_list_index;
+
+#ifdef BGC_STRING_DEDUP_STATS
+    // How many bytes of gen2 string contents each heap hashes per BGC
+    // looking for duplicates; 0 means we don't look.
+    PER_HEAP_ISOLATED
+    size_t          string_dedup_budget;
+
+    PER_HEAP
+    size_t          string_dedup_budget_left;
+
+    // Open addressed set of the hashes of the strings seen so far in this BGC.
+    PER_HEAP
+    uint64_t*       string_dedup_table;
+
+    PER_HEAP
+    size_t          string_dedup_table_used;
+
+    PER_HEAP
+    string_dedup_stats string_dedup_current;
+
+    PER_HEAP
+    string_dedup_stats string_dedup_last;
+
+#ifdef BGC_PARALLEL_MARK
+    // Background mark helpers sample the strings they mark as well; this
+    // protects the budget, the table and the counts once there are helpers.
+    PER_HEAP_ISOLATED
+    GCSpinLock      string_dedup_lock;
+#endif //BGC_PARALLEL_MARK
+#endif //BGC_STRING_DEDUP_STATS
+
+#ifdef BGC_PARALLEL_MARK
+    // Number of helper threads that share the concurrent part of background
+    // marking with the BGC thread; 0 means the BGC thread marks by itself.
+    PER_HEAP_ISOLATED
+    int             n_bgc_mark_helpers;
+
+    PER_HEAP_ISOLATED
+    int             n_bgc_mark_helpers_created;
+
+    PER_HEAP_ISOLATED
+    bgc_mark_helper* bgc_mark_helpers;
+
+    PER_HEAP_ISOLATED
+    CLREvent        bgc_mark_helpers_start_event;
+
+    PER_HEAP_ISOLATED
+    CLREvent        bgc_mark_helper_created_event;
+
+    // Protects the shared queue and the session bookkeeping below.
+    PER_HEAP_ISOLATED
+    GCSpinLock      bgc_mark_queue_lock;
+
+    PER_HEAP_ISOLATED
+    uint8_t**       bgc_mark_queue;
+
+    PER_HEAP_ISOLATED
+    VOLATILE(size_t) bgc_mark_queue_count;
+
+    PER_HEAP_ISOLATED
+    VOLATILE(BOOL)  bgc_parallel_mark_p;
+
+    PER_HEAP_ISOLATED
+    size_t          bgc_parallel_mark_session;
+
+    PER_HEAP_ISOLATED
+    int             bgc_mark_helpers_joined;
+
+    PER_HEAP_ISOLATED
+    VOLATILE(int)   bgc_mark_helpers_idle;
+#endif //BGC_PARALLEL_MARK
 #endif //BACKGROUND_GC
 
 #ifdef MARK_LIST
@@ -3560,6 +3769,42 @@ protected:
     PER_HEAP_ISOLATED
     heap_segment* segment_standby_list;
 
+    // Protects segment_standby_list; segments are taken off it by allocating threads
+    // while GCs put them on and age them out.
+    PER_HEAP_ISOLATED
+    GCSpinLock segment_standby_lock;
+
+    // Reserved bytes of the segments on segment_standby_list.
+    PER_HEAP_ISOLATED
+    size_t segment_standby_size;
+
+    // Most reserved bytes segment_standby_list may hold, 0 means freed segments are
+    // always returned to the OS.
+    PER_HEAP_ISOLATED
+    size_t segment_standby_limit;
+
+    // Number of gen2 GCs a segment can stay on segment_standby_list before it's released,
+    // SIZE_T_MAX with RetainVM, which keeps them for good.
+    PER_HEAP_ISOLATED
+    size_t segment_standby_max_age;
+
+    PER_HEAP_ISOLATED
+    size_t segment_standby_hits;
+
+    PER_HEAP_ISOLATED
+    size_t segment_standby_misses;
+
+    PER_HEAP_ISOLATED
+    size_t segment_standby_released;
+
+    PER_HEAP_ISOLATED
+    memory_pressure_counter memory_pressure_counters[max_memory_pressure_counters];
+
+    // get_memory_pressure () when each generation was last collected. What was registered since
+    // then is charged against the generation's budget.
+    PER_HEAP_ISOLATED
+    size_t memory_pressure_at_gc[max_generation + 1];
+
     PER_HEAP
     size_t ordered_free_space_indices[MAX_NUM_BUCKETS];
 
@@ -3685,6 +3930,10 @@ public:
     size_t reserved_memory;
     static
     size_t reserved_memory_limit;
+    // Objects this big or bigger go on the LOH. Never less than LARGE_OBJECT_SIZE, nor more than half of
+    // gen0's max size.
+    static
+    size_t loh_size_threshold;
     static
     BOOL      g_low_memory_status;
 
@@ -4173,6 +4422,8 @@ public:
 #ifdef MULTIPLE_HEAPS
     gc_heap*        heap;
 #endif //MULTIPLE_HEAPS
+    // gen2 GC count when the segment was put on the standby list.
+    size_t          standby_gen2_count;
 
 #ifdef _MSC_VER
 // Disable this warning - we intentionally want __declspec(align()) to insert padding for us
@@ -4254,6 +4505,11 @@ uint8_t*& heap_segment_plan_allocated (heap_segment* inst)
 {
   return inst->plan_allocated;
 }
+inline
+size_t& heap_segment_standby_gen2_count (heap_segment* inst)
+{
+  return inst->standby_gen2_count;
+}
 
 #ifdef BACKGROUND_GC
 inline
@@ -237,7 +237,8 @@ enum gc_heap_compact_reason
     compact_high_mem_frag = 8, 
     compact_vhigh_mem_frag = 9,
     compact_no_gc_mode = 10,
-    max_compact_reasons_count = 11
+    compact_loh_frag = 11,
+    max_compact_reasons_count = 12
 };
 
 #ifndef DACCESS_COMPILE
@@ -253,7 +254,8 @@ static BOOL gc_heap_compact_reason_mandatory_p[] =
     FALSE, //compact_high_mem_load = 7, 
     TRUE, //compact_high_mem_frag = 8, 
     TRUE, //compact_vhigh_mem_frag = 9,
-    TRUE //compact_no_gc_mode = 10
+    TRUE, //compact_no_gc_mode = 10
+    TRUE //compact_loh_frag = 11
 };
 
 static BOOL gc_expand_mechanism_mandatory_p[] =
@@ -280,7 +282,8 @@ static char* str_heap_compact_reasons[] =
     "high memory load (ephemeral GC)",
     "high memory load and frag",
     "very high memory load and frag",
-    "no gc mode"
+    "no gc mode",
+    "fragmented LOH"
 };
 #endif //DT_LOG
 
@@ -393,6 +396,7 @@ enum gc_global_mechanism_p
     global_demotion = 3,
     global_card_bundles = 4,
     global_elevation = 5,
+    global_loh_compaction = 6,
     max_global_mechanisms_count
 };
 
@@ -1185,6 +1185,9 @@ void Ref_TraceNormalRoots(uint32_t condemned, uint32_t maxgen, ScanContext* sc,
         // promote ref-counted handles
         uint32_t type = HNDTYPE_REFCOUNTED;
 
+        // set up the EE for the callbacks once rather than for every handle
+        bool cookie = GCToEEInterface::BeginRefCountedHandleScan();
+
         walk = &g_HandleTableMap;
         while (walk) {
             for (uint32_t i = 0; i < INITIAL_HANDLE_TABLE_ARRAY_SIZE; i ++)
@@ -1196,6 +1199,8 @@ void Ref_TraceNormalRoots(uint32_t condemned, uint32_t maxgen, ScanContext* sc,
                 }
             walk = walk->pNext;
         }
+
+        GCToEEInterface::EndRefCountedHandleScan(cookie);
     }
 #endif // FEATURE_COMINTEROP || FEATURE_REDHAWK
 }
@@ -609,7 +609,7 @@ inline void DestroyGlobalPinningHandle(OBJECTHANDLE handle)
     HndDestroyHandle(HndGetHandleTable(handle), HNDTYPE_PINNED, handle);
 }
 
-#ifdef FEATURE_COMINTEROP
+#if defined(FEATURE_COMINTEROP) || defined(FEATURE_REDHAWK)
 inline OBJECTHANDLE CreateGlobalRefcountedHandle(OBJECTREF object)
 { 
     WRAPPER_NO_CONTRACT;
@@ -623,7 +623,7 @@ inline void DestroyGlobalRefcountedHandle(OBJECTHANDLE handle)
 
     HndDestroyHandle(HndGetHandleTable(handle), HNDTYPE_REFCOUNTED, handle);
 }
-#endif // FEATURE_COMINTEROP
+#endif // FEATURE_COMINTEROP || FEATURE_REDHAWK
 
 inline void ResetOBJECTHANDLE(OBJECTHANDLE handle)
 {
@@ -79,6 +79,34 @@ Object * AllocateObject(MethodTable * pMT)
     return pObject;
 }
 
+Object * AllocateArray(MethodTable * pMT, uint32_t numComponents)
+{
+    alloc_context * acontext = GetThread()->GetAllocContext();
+    Object * pObject;
+
+    size_t size = pMT->GetBaseSize() + (size_t)numComponents * pMT->RawGetComponentSize();
+    size = (size + sizeof(intptr_t) - 1) & ~(sizeof(intptr_t) - 1);
+
+    uint8_t* result = acontext->alloc_ptr;
+    uint8_t* advance = result + size;
+    if (advance <= acontext->alloc_limit)
+    {
+        acontext->alloc_ptr = advance;
+        pObject = (Object *)result;
+    }
+    else
+    {
+        pObject = GCHeap::GetGCHeap()->Alloc(acontext, size, 0);
+        if (pObject == NULL)
+            return NULL;
+    }
+
+    pObject->RawSetMethodTable(pMT);
+    *(uint32_t *)((uint8_t *)pObject + ArrayBase::GetOffsetOfNumComponents()) = numComponents;
+
+    return pObject;
+}
+
 #if defined(BIT64)
 // Card byte shift is different on 64bit.
 #define card_byte_shift     11
@@ -111,6 +139,733 @@ void WriteBarrier(Object ** dst, Object * ref)
     ErectWriteBarrier(dst, ref);
 }
 
+//
+// Allocates up to the budget of a no GC region and verifies that no GC happened in the meantime.
+//
+bool TestNoGCRegion(GCHeap * pGCHeap, MethodTable * pMT)
+{
+    const uint64_t totalSize = 16 * 1024 * 1024;
+
+    if (pGCHeap->StartNoGCRegion(totalSize, FALSE, 0, FALSE) != start_no_gc_success)
+        return false;
+
+    // Hand the whole budget to this thread's allocation context, the way the runtime does for the thread that
+    // started the region.
+    pGCHeap->PresizeAllocContextForNoGCRegion(GetThread()->GetAllocContext());
+
+    int gcCount = pGCHeap->CollectionCount(0);
+
+    for (size_t allocated = 0; allocated + pMT->GetBaseSize() <= totalSize; allocated += pMT->GetBaseSize())
+    {
+        if (AllocateObject(pMT) == NULL)
+            return false;
+    }
+
+    if (pGCHeap->CollectionCount(0) != gcCount)
+        return false;
+
+    if (pGCHeap->GetNoGCRegionStatus() != end_no_gc_success)
+        return false;
+
+    return (pGCHeap->EndNoGCRegion() == end_no_gc_success);
+}
+
+//
+// Consumes the gen2 budget by allocating objects that survive into gen2 and verifies that the full GC
+// notifications fire in order: approach before the full GC happens, complete after it is done.
+//
+bool TestFullGCNotification(GCHeap * pGCHeap, MethodTable * pMT, size_t offsetOfNext)
+{
+    const int maxAllocations = 4 * 1024 * 1024;
+
+    if (!pGCHeap->RegisterForFullGCNotification(99, 99))
+        return false;
+
+    // Nothing is approaching yet, so waiting with no timeout has to time out.
+    if (pGCHeap->WaitForFullGCApproach(0) != wait_full_gc_timeout)
+        return false;
+
+    OBJECTHANDLE ohHead = CreateGlobalHandle(NULL);
+    if (ohHead == NULL)
+        return false;
+
+    int gen2Count = pGCHeap->CollectionCount(GCHeap::GetMaxGeneration());
+    bool approachSeen = false;
+    bool completeSeen = false;
+
+    for (int i = 0; (i < maxAllocations) && !completeSeen; i++)
+    {
+        Object * p = AllocateObject(pMT);
+        if (p == NULL)
+            return false;
+
+        // Chain the new object to the list so that everything allocated so far survives and gets promoted.
+        WriteBarrier((Object **)((uint8_t *)p + offsetOfNext), ObjectFromHandle(ohHead));
+        StoreObjectInHandle(ohHead, p);
+
+        bool fullGCHappened = (pGCHeap->CollectionCount(GCHeap::GetMaxGeneration()) != gen2Count);
+
+        if (!approachSeen)
+        {
+            int status = pGCHeap->WaitForFullGCApproach(0);
+            if (status == wait_full_gc_success)
+            {
+                // The approach has to be announced before the full GC it announces.
+                if (fullGCHappened)
+                    return false;
+
+                approachSeen = true;
+            }
+            else if ((status != wait_full_gc_timeout) || fullGCHappened)
+            {
+                return false;
+            }
+        }
+        else
+        {
+            int status = pGCHeap->WaitForFullGCComplete(0);
+            if ((status == wait_full_gc_success) || (status == wait_full_gc_na))
+            {
+                // Complete must not be signalled until the full GC has actually happened.
+                if (!fullGCHappened)
+                    return false;
+
+                completeSeen = true;
+            }
+            else if (status != wait_full_gc_timeout)
+            {
+                return false;
+            }
+        }
+    }
+
+    DestroyGlobalHandle(ohHead);
+
+    if (!completeSeen)
+        return false;
+
+    // Once cancelled, waiting is no longer applicable.
+    if (!pGCHeap->CancelFullGCNotification())
+        return false;
+
+    return (pGCHeap->WaitForFullGCApproach(0) == wait_full_gc_na);
+}
+
+inline Object ** ArraySlots(Object * pArray)
+{
+    return (Object **)((uint8_t *)pArray + sizeof(ArrayBase));
+}
+
+//
+// Builds a graph that is both deep and wide - a chain of arrays where every array holds a lot of leaf objects
+// besides the link to the next one, which is in the last slot so it gets marked first - and verifies that a full
+// GC marks all of it without falling back to rescanning the heap for mark stack overflow.
+//
+bool TestMarkStackGrowth(GCHeap * pGCHeap, MethodTable * pArrayMT, MethodTable * pMT)
+{
+    // Keep the arrays below the size at which marking switches to pushing them a few references at a time.
+    const uint32_t width = 90;
+    const int depth = 4000;
+    // The mark stack may only grow to a tenth of the heap size, and a graph like this one needs more. An array
+    // of nulls stands in for the rest of a real heap.
+    const uint32_t ballastLength = 8 * 1024 * 1024;
+
+    OBJECTHANDLE ohRoot = CreateGlobalHandle(NULL);
+    OBJECTHANDLE ohCurrent = CreateGlobalHandle(NULL);
+    OBJECTHANDLE ohBallast = CreateGlobalHandle(NULL);
+    if ((ohRoot == NULL) || (ohCurrent == NULL) || (ohBallast == NULL))
+        return false;
+
+    Object * pBallast = AllocateArray(pArrayMT, ballastLength);
+    if (pBallast == NULL)
+        return false;
+    StoreObjectInHandle(ohBallast, pBallast);
+
+    for (int level = 0; level < depth; level++)
+    {
+        Object * pArray = AllocateArray(pArrayMT, width);
+        if (pArray == NULL)
+            return false;
+
+        if (level == 0)
+            StoreObjectInHandle(ohRoot, pArray);
+        else
+            WriteBarrier(&ArraySlots(ObjectFromHandle(ohCurrent))[width - 1], pArray);
+        StoreObjectInHandle(ohCurrent, pArray);
+
+        for (uint32_t i = 0; i < width - 1; i++)
+        {
+            Object * p = AllocateObject(pMT);
+            if (p == NULL)
+                return false;
+
+            // Allocating may have moved the array.
+            WriteBarrier(&ArraySlots(ObjectFromHandle(ohCurrent))[i], p);
+        }
+    }
+
+    DestroyGlobalHandle(ohCurrent);
+
+    size_t overflowsBefore, rescansBefore;
+    pGCHeap->GetMarkStackOverflowStats(&overflowsBefore, &rescansBefore);
+
+    pGCHeap->GarbageCollect();
+
+    size_t overflowsAfter, rescansAfter;
+    pGCHeap->GetMarkStackOverflowStats(&overflowsAfter, &rescansAfter);
+
+    // Everything has to have survived.
+    int levels = 0;
+    for (Object * pArray = ObjectFromHandle(ohRoot); pArray != NULL; pArray = ArraySlots(pArray)[width - 1])
+    {
+        if ((pArray->RawGetMethodTable() != pArrayMT) || (((ArrayBase *)pArray)->GetNumComponents() != width))
+            return false;
+
+        for (uint32_t i = 0; i < width - 1; i++)
+        {
+            Object * p = ArraySlots(pArray)[i];
+            if ((p == NULL) || (p->RawGetMethodTable() != pMT))
+                return false;
+        }
+
+        levels++;
+    }
+
+    DestroyGlobalHandle(ohRoot);
+    DestroyGlobalHandle(ohBallast);
+
+    if (levels != depth)
+        return false;
+
+    // The mark stack should have grown instead of overflowing.
+    return (overflowsAfter == overflowsBefore) && (rescansAfter == rescansBefore);
+}
+
+//
+// Registers unmanaged memory for small objects the way wrappers of native buffers do, and unregisters it once
+// the GC has found the object dead, like its finalizer would. Verifies that the GC collects gen2 because of
+// the unmanaged memory, and at a steady rate: once the budget has settled, the unmanaged memory registered
+// between two gen2 GCs shouldn't vary by much.
+//
+bool TestMemoryPressure(GCHeap * pGCHeap, MethodTable * pMT)
+{
+    const size_t bufferSize = 64 * 1024;
+    // Number of iterations a wrapper stays reachable, long enough for some of them to get promoted to gen2.
+    const int liveWrappers = 256;
+    const int trackedWrappers = 16 * 1024;
+    const int garbagePerWrapper = 16;
+    const int maxIterations = 1000000;
+    const int warmupGen2GCs = 3;
+    const int measuredGen2GCs = 8;
+
+    static OBJECTHANDLE liveHandles[liveWrappers];
+    static OBJECTHANDLE trackedHandles[trackedWrappers];
+    static bool tracked[trackedWrappers];
+    static int freeSlots[trackedWrappers];
+    int freeCount = 0;
+
+    for (int i = 0; i < liveWrappers; i++)
+    {
+        liveHandles[i] = CreateGlobalHandle(NULL);
+        if (liveHandles[i] == NULL)
+            return false;
+    }
+
+    for (int i = 0; i < trackedWrappers; i++)
+    {
+        trackedHandles[i] = CreateGlobalWeakHandle(NULL);
+        if (trackedHandles[i] == NULL)
+            return false;
+        tracked[i] = false;
+        freeSlots[freeCount++] = i;
+    }
+
+    size_t pressureBefore = pGCHeap->GetMemoryPressure();
+
+    int gen0Count = pGCHeap->CollectionCount(0);
+    int gen2Count = pGCHeap->CollectionCount(GCHeap::GetMaxGeneration());
+    int gen2GCs = 0;
+    size_t registeredSinceGen2 = 0;
+    size_t minRegistered = SIZE_MAX;
+    size_t maxRegistered = 0;
+
+    for (int iteration = 0; (iteration < maxIterations) && (gen2GCs < warmupGen2GCs + measuredGen2GCs); iteration++)
+    {
+        // Run the "finalizers" of the wrappers the last GCs found dead.
+        if (pGCHeap->CollectionCount(0) != gen0Count)
+        {
+            gen0Count = pGCHeap->CollectionCount(0);
+
+            for (int i = 0; i < trackedWrappers; i++)
+            {
+                if (tracked[i] && (ObjectFromHandle(trackedHandles[i]) == NULL))
+                {
+                    pGCHeap->RemoveMemoryPressure(bufferSize);
+                    tracked[i] = false;
+                    freeSlots[freeCount++] = i;
+                }
+            }
+        }
+
+        if (pGCHeap->CollectionCount(GCHeap::GetMaxGeneration()) != gen2Count)
+        {
+            gen2Count = pGCHeap->CollectionCount(GCHeap::GetMaxGeneration());
+            gen2GCs++;
+
+            if (gen2GCs > warmupGen2GCs)
+            {
+                minRegistered = min(minRegistered, registeredSinceGen2);
+                maxRegistered = max(maxRegistered, registeredSinceGen2);
+            }
+            registeredSinceGen2 = 0;
+        }
+
+        // Dead wrappers are piling up faster than the GC reclaims them.
+        if (freeCount == 0)
+            return false;
+
+        Object * pWrapper = AllocateObject(pMT);
+        if (pWrapper == NULL)
+            return false;
+
+        int slot = freeSlots[--freeCount];
+        StoreObjectInHandle(trackedHandles[slot], pWrapper);
+        tracked[slot] = true;
+        StoreObjectInHandle(liveHandles[iteration % liveWrappers], pWrapper);
+
+        int generation = pGCHeap->AddMemoryPressure(bufferSize);
+        registeredSinceGen2 += bufferSize;
+        if (generation >= 0)
+            pGCHeap->GarbageCollect(generation, FALSE, collection_non_blocking);
+
+        for (int i = 0; i < garbagePerWrapper; i++)
+        {
+            if (AllocateObject(pMT) == NULL)
+                return false;
+        }
+    }
+
+    for (int i = 0; i < liveWrappers; i++)
+        DestroyGlobalHandle(liveHandles[i]);
+
+    for (int i = 0; i < trackedWrappers; i++)
+    {
+        if (tracked[i])
+            pGCHeap->RemoveMemoryPressure(bufferSize);
+        DestroyGlobalHandle(trackedHandles[i]);
+    }
+
+    if (pGCHeap->GetMemoryPressure() != pressureBefore)
+        return false;
+
+    if (gen2GCs < warmupGen2GCs + measuredGen2GCs)
+        return false;
+
+    return (maxRegistered <= 4 * minRegistered);
+}
+
+//
+// Allocates enough small objects to go through many allocation contexts and several GCs. Verifies that the
+// per-thread allocated bytes only count what was handed out to objects, and that the lock-free estimate of the
+// heap size agrees with the one computed under the gc lock.
+//
+bool TestAllocatedBytes(GCHeap * pGCHeap, MethodTable * pMT)
+{
+    const int objectCount = 1000000;
+
+    alloc_context * acontext = GetThread()->GetAllocContext();
+    size_t objectSize = pMT->GetBaseSize();
+
+    int64_t allocatedBefore = acontext->alloc_bytes + acontext->alloc_bytes_loh - (acontext->alloc_limit - acontext->alloc_ptr);
+    int gen0Count = pGCHeap->CollectionCount(0);
+
+    for (int i = 0; i < objectCount; i++)
+    {
+        if (AllocateObject(pMT) == NULL)
+            return false;
+    }
+
+    if (pGCHeap->CollectionCount(0) == gen0Count)
+        return false;
+
+    int64_t allocated = acontext->alloc_bytes + acontext->alloc_bytes_loh - (acontext->alloc_limit - acontext->alloc_ptr) - allocatedBefore;
+
+    // Allocations from the free list leave a minimal object's worth of space at the end of the context.
+    int64_t expected = (int64_t)objectCount * objectSize;
+    if ((allocated < expected) || (allocated > expected + expected / 8))
+        return false;
+
+    pGCHeap->GarbageCollect();
+
+    size_t totalBytes = pGCHeap->GetTotalBytesInUse();
+    size_t approxTotalBytes = pGCHeap->GetApproxTotalBytesInUse();
+    if ((approxTotalBytes > 2 * totalBytes) || (totalBytes > 2 * approxTotalBytes))
+        return false;
+
+    return true;
+}
+
+//
+// Fills a second LOH segment with arrays and frees it, twice. Verifies that the second time the segment comes
+// from the standby list, and that it's released once it has stayed unused for the maximum age.
+//
+bool TestSegmentStandby(GCHeap * pGCHeap, MethodTable * pArrayMT)
+{
+    // 4MB arrays, enough of them to not fit in the first LOH segment.
+    const uint32_t arrayLength = 512 * 1024;
+    const uint32_t arrayCount = 48;
+    // GetGCSegmentStandbyMaxAge
+    const int maxAge = 4;
+
+    OBJECTHANDLE oh = CreateGlobalHandle(NULL);
+    if (oh == NULL)
+        return false;
+
+    size_t hits, misses, released;
+    size_t hitsBefore = 0;
+
+    for (int round = 0; round < 2; round++)
+    {
+        pGCHeap->GetSegmentStandbyStats(&hitsBefore, &misses, &released);
+
+        Object * pHolder = AllocateArray(pArrayMT, arrayCount);
+        if (pHolder == NULL)
+            return false;
+        StoreObjectInHandle(oh, pHolder);
+
+        for (uint32_t i = 0; i < arrayCount; i++)
+        {
+            Object * pArray = AllocateArray(pArrayMT, arrayLength);
+            if (pArray == NULL)
+                return false;
+
+            WriteBarrier(&ArraySlots(ObjectFromHandle(oh))[i], pArray);
+        }
+
+        // The segment is empty after this and goes on the standby list.
+        StoreObjectInHandle(oh, NULL);
+        pGCHeap->GarbageCollect();
+    }
+
+    DestroyGlobalHandle(oh);
+
+    pGCHeap->GetSegmentStandbyStats(&hits, &misses, &released);
+    if (hits == hitsBefore)
+        return false;
+
+    size_t releasedBefore = released;
+
+    for (int i = 0; i <= maxAge; i++)
+    {
+        pGCHeap->GarbageCollect();
+    }
+
+    pGCHeap->GetSegmentStandbyStats(&hits, &misses, &released);
+    return (released > releasedBefore);
+}
+
+// The GC latency modes the sample uses, as in GCLatencyMode.
+#define GC_LATENCY_MODE_BATCH       0
+#define GC_LATENCY_MODE_INTERACTIVE 1
+
+//
+// Makes copies of a set of strings, gets them promoted to gen2 and runs a background GC. Verifies that the GC
+// looked at every string and found all the copies, and only in the length bucket of the strings.
+//
+bool TestStringDedupStats(GCHeap * pGCHeap, MethodTable * pStringMT, MethodTable * pArrayMT)
+{
+    const uint32_t distinctStrings = 100;
+    const uint32_t copies = 10;
+    const uint32_t length = 20;
+    const int lengthBucket = 4;
+
+    // Background GCs need write watch.
+    if (!GCToOSInterface::SupportsWriteWatch())
+        return true;
+
+    string_dedup_stats stats;
+    if (!pGCHeap->GetStringDedupStats(&stats))
+        return false;
+
+    Object * pArray = AllocateArray(pArrayMT, distinctStrings * copies);
+    if (pArray == NULL)
+        return false;
+
+    OBJECTHANDLE oh = CreateGlobalHandle(pArray);
+    if (oh == NULL)
+        return false;
+
+    for (uint32_t i = 0; i < distinctStrings * copies; i++)
+    {
+        Object * pString = AllocateArray(pStringMT, length);
+        if (pString == NULL)
+            return false;
+
+        // The characters follow the length, like in System.String.
+        uint16_t * pChars = (uint16_t *)((uint8_t *)pString + ArrayBase::GetOffsetOfNumComponents() + sizeof(uint32_t));
+        for (uint32_t j = 0; j < length; j++)
+        {
+            pChars[j] = (uint16_t)('a' + (i % distinctStrings) + j);
+        }
+
+        WriteBarrier(&ArraySlots(ObjectFromHandle(oh))[i], pString);
+    }
+
+    // Get the strings out of the ephemeral generations.
+    pGCHeap->GarbageCollect();
+    pGCHeap->GarbageCollect();
+
+    // The thread only waits while the background GC runs, so it doesn't matter that the sample doesn't suspend it.
+    int bgcCount = pGCHeap->CollectionCount(GCHeap::GetMaxGeneration(), 1);
+    pGCHeap->SetGcLatencyMode(GC_LATENCY_MODE_INTERACTIVE);
+    pGCHeap->GarbageCollect(GCHeap::GetMaxGeneration(), FALSE, collection_non_blocking);
+    HRESULT hr = pGCHeap->WaitUntilConcurrentGCCompleteAsync(INFINITE);
+    pGCHeap->SetGcLatencyMode(GC_LATENCY_MODE_BATCH);
+
+    if (FAILED(hr) || (pGCHeap->CollectionCount(GCHeap::GetMaxGeneration(), 1) == bgcCount))
+        return false;
+
+    DestroyGlobalHandle(oh);
+
+    if (!pGCHeap->GetStringDedupStats(&stats))
+        return false;
+
+    if (stats.sampled_count != distinctStrings * copies)
+        return false;
+
+    for (int i = 0; i < STRING_DEDUP_LENGTH_BUCKETS; i++)
+    {
+        size_t expected = (i == lengthBucket) ? (distinctStrings * (copies - 1)) : 0;
+        if (stats.dup_count[i] != expected)
+            return false;
+    }
+
+    return (stats.dup_bytes[lengthBucket] == stats.sampled_bytes / copies * (copies - 1));
+}
+
+//
+// Keeps replacing the set of types whose ref counted handles are strong while a background GC scans the
+// handles. The sample doesn't suspend its thread, so the replacements race with the scan. Objects of the type
+// that's in every set must survive; a GC reading a set after it was freed would let them go.
+//
+bool TestRefCountedHandles(GCHeap * pGCHeap, MethodTable * pMT, MethodTable * pStringMT)
+{
+    const uint32_t objects = 1000;
+
+    // Background GCs need write watch.
+    if (!GCToOSInterface::SupportsWriteWatch())
+        return true;
+
+    MethodTable * rgTypes[] = { pMT, pStringMT };
+    if (!SetRefCountedHandleTypes(rgTypes, 2))
+        return false;
+
+    // Even handles hold objects of pMT, odd ones strings.
+    OBJECTHANDLE rgHandles[objects];
+    for (uint32_t i = 0; i < objects; i++)
+    {
+        Object * pObject = (i % 2 == 0) ? AllocateObject(pMT) : AllocateArray(pStringMT, 0);
+        if (pObject == NULL)
+            return false;
+
+        rgHandles[i] = CreateGlobalRefcountedHandle(pObject);
+        if (rgHandles[i] == NULL)
+            return false;
+    }
+
+    // Get the objects out of the ephemeral generations.
+    pGCHeap->GarbageCollect();
+    pGCHeap->GarbageCollect();
+
+    int bgcCount = pGCHeap->CollectionCount(GCHeap::GetMaxGeneration(), 1);
+    pGCHeap->SetGcLatencyMode(GC_LATENCY_MODE_INTERACTIVE);
+    pGCHeap->GarbageCollect(GCHeap::GetMaxGeneration(), FALSE, collection_non_blocking);
+
+    uint32_t replacements = 0;
+    while (pGCHeap->IsConcurrentGCInProgress())
+    {
+        if (!SetRefCountedHandleTypes(rgTypes, 1 + (replacements++ % 2)))
+            return false;
+    }
+
+    HRESULT hr = pGCHeap->WaitUntilConcurrentGCCompleteAsync(INFINITE);
+    pGCHeap->SetGcLatencyMode(GC_LATENCY_MODE_BATCH);
+
+    if (FAILED(hr) || (pGCHeap->CollectionCount(GCHeap::GetMaxGeneration(), 1) == bgcCount))
+        return false;
+
+    for (uint32_t i = 0; i < objects; i += 2)
+    {
+        if (ObjectFromHandle(rgHandles[i]) == NULL)
+            return false;
+    }
+
+    // Now with nothing racing: only the objects of pMT are kept, and then nothing is.
+    if (!SetRefCountedHandleTypes(rgTypes, 1))
+        return false;
+    pGCHeap->GarbageCollect();
+
+    for (uint32_t i = 0; i < objects; i++)
+    {
+        if ((ObjectFromHandle(rgHandles[i]) == NULL) != (i % 2 != 0))
+            return false;
+    }
+
+    if (!SetRefCountedHandleTypes(rgTypes, 0))
+        return false;
+    pGCHeap->GarbageCollect();
+
+    for (uint32_t i = 0; i < objects; i++)
+    {
+        if (ObjectFromHandle(rgHandles[i]) != NULL)
+            return false;
+
+        DestroyGlobalRefcountedHandle(rgHandles[i]);
+    }
+
+    return true;
+}
+
+//
+// Runs a background GC with mark helper threads over a graph that gives the BGC thread plenty to share with them:
+// an array of chains of objects, each of which also points to a string. Every chain that's still referenced
+// has to survive intact, both the background GC and a compacting GC after it, and the chains that were dropped
+// before it have to be collected. The helpers attach to the sample's thread store like the BGC thread does,
+// which shows that they were started.
+//
+bool TestBgcParallelMark(GCHeap * pGCHeap, MethodTable * pArrayMT, MethodTable * pMT, MethodTable * pStringMT,
+                         size_t offsetOfNext, size_t offsetOfString)
+{
+    const uint32_t chains = 256;
+    const uint32_t length = 200;
+    const uint32_t stringLength = 8;
+
+    // Background GCs need write watch.
+    if (!GCToOSInterface::SupportsWriteWatch())
+        return true;
+
+    OBJECTHANDLE ohArray = CreateGlobalHandle(NULL);
+    OBJECTHANDLE ohNode = CreateGlobalHandle(NULL);
+    OBJECTHANDLE rgWeakHandles[chains / 2];
+    if ((ohArray == NULL) || (ohNode == NULL))
+        return false;
+
+    Object * pArray = AllocateArray(pArrayMT, chains);
+    if (pArray == NULL)
+        return false;
+    StoreObjectInHandle(ohArray, pArray);
+
+    for (uint32_t j = 0; j < length; j++)
+    {
+        for (uint32_t i = 0; i < chains; i++)
+        {
+            Object * p = AllocateObject(pMT);
+            if (p == NULL)
+                return false;
+            StoreObjectInHandle(ohNode, p);
+
+            Object * pString = AllocateArray(pStringMT, stringLength);
+            if (pString == NULL)
+                return false;
+
+            uint16_t * pChars = (uint16_t *)((uint8_t *)pString + ArrayBase::GetOffsetOfNumComponents() + sizeof(uint32_t));
+            pChars[0] = (uint16_t)i;
+            pChars[1] = (uint16_t)j;
+
+            // Allocating may have moved the node and the array.
+            Object * pNode = ObjectFromHandle(ohNode);
+            Object ** ppHead = &ArraySlots(ObjectFromHandle(ohArray))[i];
+            WriteBarrier((Object **)((uint8_t *)pNode + offsetOfString), pString);
+            WriteBarrier((Object **)((uint8_t *)pNode + offsetOfNext), *ppHead);
+            WriteBarrier(ppHead, pNode);
+        }
+    }
+
+    DestroyGlobalHandle(ohNode);
+
+    // Get everything into gen2, then drop every other chain.
+    pGCHeap->GarbageCollect();
+    pGCHeap->GarbageCollect();
+
+    for (uint32_t i = 1; i < chains; i += 2)
+    {
+        Object ** ppHead = &ArraySlots(ObjectFromHandle(ohArray))[i];
+        rgWeakHandles[i / 2] = CreateGlobalWeakHandle(*ppHead);
+        if (rgWeakHandles[i / 2] == NULL)
+            return false;
+        WriteBarrier(ppHead, NULL);
+    }
+
+    // The thread only waits while the background GC runs, so it doesn't matter that the sample doesn't suspend it.
+    int bgcCount = pGCHeap->CollectionCount(GCHeap::GetMaxGeneration(), 1);
+    pGCHeap->SetGcLatencyMode(GC_LATENCY_MODE_INTERACTIVE);
+    pGCHeap->GarbageCollect(GCHeap::GetMaxGeneration(), FALSE, collection_non_blocking);
+    HRESULT hr = pGCHeap->WaitUntilConcurrentGCCompleteAsync(INFINITE);
+    pGCHeap->SetGcLatencyMode(GC_LATENCY_MODE_BATCH);
+
+    if (FAILED(hr) || (pGCHeap->CollectionCount(GCHeap::GetMaxGeneration(), 1) == bgcCount))
+        return false;
+
+    for (uint32_t i = 0; i < chains / 2; i++)
+    {
+        if (ObjectFromHandle(rgWeakHandles[i]) != NULL)
+            return false;
+
+        DestroyGlobalWeakHandle(rgWeakHandles[i]);
+    }
+
+    // Check the chains after the background GC, which doesn't move anything, and again after a compacting GC,
+    // which would spread any object the background GC missed and swept.
+    for (int pass = 0; pass < 2; pass++)
+    {
+        for (uint32_t i = 0; i < chains; i++)
+        {
+            Object * pNode = ArraySlots(ObjectFromHandle(ohArray))[i];
+            if ((i % 2) != 0)
+            {
+                if (pNode != NULL)
+                    return false;
+                continue;
+            }
+
+            for (uint32_t j = length; j-- > 0; )
+            {
+                if ((pNode == NULL) || (pNode->RawGetMethodTable() != pMT))
+                    return false;
+
+                Object * pString = *(Object **)((uint8_t *)pNode + offsetOfString);
+                if ((pString == NULL) || (pString->RawGetMethodTable() != pStringMT) ||
+                    (((ArrayBase *)pString)->GetNumComponents() != stringLength))
+                    return false;
+
+                uint16_t * pChars = (uint16_t *)((uint8_t *)pString + ArrayBase::GetOffsetOfNumComponents() + sizeof(uint32_t));
+                if ((pChars[0] != (uint16_t)i) || (pChars[1] != (uint16_t)j))
+                    return false;
+
+                pNode = *(Object **)((uint8_t *)pNode + offsetOfNext);
+            }
+
+            if (pNode != NULL)
+                return false;
+        }
+
+        if (pass == 0)
+            pGCHeap->GarbageCollect(GCHeap::GetMaxGeneration(), FALSE, collection_blocking | collection_compacting);
+    }
+
+    DestroyGlobalHandle(ohArray);
+
+    // The main thread, the BGC thread and the helpers, as many as the GC may use on this machine.
+    uint32_t expectedHelpers = min((uint32_t)g_pConfig->GetGCBgcMarkThreads(), g_SystemInfo.dwNumberOfProcessors - 1);
+    uint32_t threads = 0;
+    for (Thread * pThread = ThreadStore::GetThreadList(NULL); pThread != NULL; pThread = ThreadStore::GetThreadList(pThread))
+    {
+        threads++;
+    }
+
+    return (threads == 2 + expectedHelpers);
+}
+
 int __cdecl main(int argc, char* argv[])
 {
     //
@@ -150,6 +905,11 @@ int __cdecl main(int argc, char* argv[])
     //
     ThreadStore::AttachCurrentThread();
 
+    // The sample doesn't suspend its thread for GCs, so it can't keep allocating while a background GC runs.
+    // Only TestStringDedupStats, TestRefCountedHandles and TestBgcParallelMark allow background GCs, and they wait
+    // for them to complete.
+    pGCHeap->SetGcLatencyMode(GC_LATENCY_MODE_BATCH);
+
     //
     // Create a Methodtable with GCDesc
     //
@@ -195,6 +955,47 @@ int __cdecl main(int argc, char* argv[])
 
     MethodTable * pMyMethodTable = &My_MethodTable.m_MT;
 
+    //
+    // Create a Methodtable for arrays of object references
+    //
+    static struct ObjArray_MethodTable
+    {
+        // GCDesc
+        CGCDescSeries m_series[1];
+        size_t m_numSeries;
+
+        // The actual methodtable
+        MethodTable m_MT;
+    }
+    ObjArray_MethodTable;
+
+    uint32_t arrayBaseSize = sizeof(ArrayBase) + sizeof(ObjHeader);
+    ObjArray_MethodTable.m_MT.m_baseSize = max(arrayBaseSize, MIN_OBJECT_SIZE);
+    ObjArray_MethodTable.m_MT.m_componentSize = sizeof(Object *);
+    ObjArray_MethodTable.m_MT.m_flags = MTFlag_ContainsPointers | MTFlag_IsArray;
+
+    ObjArray_MethodTable.m_numSeries = 1;
+
+    // A single series that covers all the elements, whatever the length of the array is.
+    ObjArray_MethodTable.m_series[0].SetSeriesOffset(sizeof(ArrayBase));
+    ObjArray_MethodTable.m_series[0].SetSeriesCount(0);
+    ObjArray_MethodTable.m_series[0].seriessize -= ObjArray_MethodTable.m_MT.m_baseSize;
+
+    MethodTable * pObjArrayMethodTable = &ObjArray_MethodTable.m_MT;
+
+    //
+    // Create a Methodtable for strings
+    //
+    static MethodTable String_MethodTable;
+
+    // Room for the length and the terminating null character.
+    uint32_t stringBaseSize = sizeof(Object) + sizeof(uint32_t) + sizeof(uint16_t) + sizeof(ObjHeader);
+    String_MethodTable.m_baseSize = max(stringBaseSize, MIN_OBJECT_SIZE);
+    String_MethodTable.m_componentSize = sizeof(uint16_t);
+    String_MethodTable.m_flags = 0;
+
+    MethodTable * pStringMethodTable = &String_MethodTable;
+
     // Allocate instance of MyObject
     Object * pObj = AllocateObject(pMyMethodTable);
     if (pObj == NULL)
@@ -237,6 +1038,34 @@ int __cdecl main(int argc, char* argv[])
     // Verify that the weak handle got cleared by the GC
     assert(ObjectFromHandle(ohWeak) == NULL);
 
+    if (!TestNoGCRegion(pGCHeap, pMyMethodTable))
+        return -1;
+
+    if (!TestFullGCNotification(pGCHeap, pMyMethodTable, offsetof(My, m_pOther2)))
+        return -1;
+
+    if (!TestMarkStackGrowth(pGCHeap, pObjArrayMethodTable, pMyMethodTable))
+        return -1;
+
+    if (!TestMemoryPressure(pGCHeap, pMyMethodTable))
+        return -1;
+
+    if (!TestAllocatedBytes(pGCHeap, pMyMethodTable))
+        return -1;
+
+    if (!TestStringDedupStats(pGCHeap, pStringMethodTable, pObjArrayMethodTable))
+        return -1;
+
+    if (!TestSegmentStandby(pGCHeap, pObjArrayMethodTable))
+        return -1;
+
+    if (!TestRefCountedHandles(pGCHeap, pMyMethodTable, pStringMethodTable))
+        return -1;
+
+    if (!TestBgcParallelMark(pGCHeap, pObjArrayMethodTable, pMyMethodTable, pStringMethodTable,
+                             offsetof(My, m_pOther1), offsetof(My, m_pOther2)))
+        return -1;
+
     printf("Done\n");
 
     return 0;
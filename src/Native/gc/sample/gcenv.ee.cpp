@@ -157,11 +157,82 @@ void GCToEEInterface::GcDone(int condemned)
 {
 }
 
+// The types whose ref counted handles are strong. Like the runtime's ref counted handle callouts, a set is
+// never changed once it's published: SetRefCountedHandleTypes swaps in a new one, and the old ones are only
+// freed once no scan of the handles can still be reading them.
+struct RefCountedHandleTypes
+{
+    RefCountedHandleTypes * m_pNextRetired;
+    uint32_t m_cTypes;
+    MethodTable * m_rgTypes[1];
+};
+
+static RefCountedHandleTypes * volatile s_pRefCountedHandleTypes;
+static RefCountedHandleTypes * s_pRetiredRefCountedHandleTypes;
+static volatile int32_t s_cRefCountedHandleScans;
+
+bool SetRefCountedHandleTypes(MethodTable ** rgTypes, uint32_t cTypes)
+{
+    size_t cbTypes = sizeof(RefCountedHandleTypes) + cTypes * sizeof(MethodTable *);
+    RefCountedHandleTypes * pTypes = (RefCountedHandleTypes *)new (nothrow) uint8_t[cbTypes];
+    if (pTypes == NULL)
+        return false;
+
+    pTypes->m_pNextRetired = NULL;
+    pTypes->m_cTypes = cTypes;
+    memcpy(pTypes->m_rgTypes, rgTypes, cTypes * sizeof(MethodTable *));
+
+    // The exchange orders the store before the read of the scan count, and a scan counts itself before it
+    // reads the set. So if there's no scan now, none can be using a retired set.
+    RefCountedHandleTypes * pOldTypes = Interlocked::ExchangePointer(&s_pRefCountedHandleTypes, pTypes);
+    if (pOldTypes != NULL)
+    {
+        pOldTypes->m_pNextRetired = s_pRetiredRefCountedHandleTypes;
+        s_pRetiredRefCountedHandleTypes = pOldTypes;
+    }
+
+    if (s_cRefCountedHandleScans != 0)
+        return true;
+
+    while (s_pRetiredRefCountedHandleTypes != NULL)
+    {
+        RefCountedHandleTypes * pRetiredTypes = s_pRetiredRefCountedHandleTypes;
+        s_pRetiredRefCountedHandleTypes = pRetiredTypes->m_pNextRetired;
+
+        // Scribble over the set, so that if a GC still used it its handles would go weak.
+        memset(pRetiredTypes, 0, sizeof(RefCountedHandleTypes) + pRetiredTypes->m_cTypes * sizeof(MethodTable *));
+        delete [] (uint8_t *)pRetiredTypes;
+    }
+
+    return true;
+}
+
 bool GCToEEInterface::RefCountedHandleCallbacks(Object * pObject)
 {
+    RefCountedHandleTypes * pTypes = s_pRefCountedHandleTypes;
+    if (pTypes == NULL)
+        return false;
+
+    for (uint32_t i = 0; i < pTypes->m_cTypes; i++)
+    {
+        if (pTypes->m_rgTypes[i] == pObject->RawGetMethodTable())
+            return true;
+    }
+
+    return false;
+}
+
+bool GCToEEInterface::BeginRefCountedHandleScan()
+{
+    Interlocked::Increment(&s_cRefCountedHandleScans);
     return false;
 }
 
+void GCToEEInterface::EndRefCountedHandleScan(bool cookie)
+{
+    Interlocked::Decrement(&s_cRefCountedHandleScans);
+}
+
 bool GCToEEInterface::IsPreemptiveGCDisabled(Thread * pThread)
 {
     return pThread->PreemptiveGCDisabled();
@@ -232,8 +303,12 @@ bool FinalizerThread::HaveExtraWorkForFinalizer()
 
 bool REDHAWK_PALAPI PalStartBackgroundGCThread(BackgroundCallback callback, void* pCallbackContext)
 {
-    // TODO: Implement for background GC
-    return false;
+    HANDLE hThread = ::CreateThread(NULL, 0, (LPTHREAD_START_ROUTINE)callback, pCallbackContext, 0, NULL);
+    if (hThread == NULL)
+        return false;
+
+    CloseHandle(hThread);
+    return true;
 }
 
 bool IsGCSpecialThread()
@@ -91,6 +91,11 @@ public:
     static void AttachCurrentThread();
 };
 
+// Ref counted handles to objects of the given types act as strong handles, the rest as weak ones. Replaces
+// the previous set of types, which may be in use by a GC on another thread. Returns false if insufficient
+// memory was available.
+bool SetRefCountedHandleTypes(MethodTable ** rgTypes, uint32_t cTypes);
+
 // -----------------------------------------------------------------------------------------------------------
 // Config file enumulation
 //
@@ -141,7 +146,15 @@ public:
     int     GetGCForceCompact()             const { return 0; }
     int     GetGCRetainVM()                const { return 0; }
     int     GetGCTrimCommit()               const { return 0; }
+    int     GetGCBgcMarkThreads()           const { return 2; }
+    int     GetGCStringDedupStatsMB()       const { return 16; }
+    int     GetGCLOHThreshold()             const { return 0; }
     int     GetGCLOHCompactionMode()        const { return 0; }
+    int     GetGCLOHCompactFragPercent()    const { return 50; }
+    int     GetGCLOHCompactMinFragMB()      const { return 32; }
+    int     GetGCLOHCompactLargestFreePercent() const { return 50; }
+    int     GetGCSegmentStandbyMB()         const { return 256; }
+    int     GetGCSegmentStandbyMaxAge()     const { return 4; }
 
     bool    GetGCAllowVeryLargeObjects()   const { return false; }
 
@@ -219,7 +219,7 @@ bool GCToOSInterface::VirtualReset(void * address, size_t size, bool unlock)
 // Check if the OS supports write watching
 bool GCToOSInterface::SupportsWriteWatch()
 {
-    return false;
+    return true;
 }
 
 // Reset the write tracking state for the specified virtual memory range.
@@ -228,6 +228,7 @@ bool GCToOSInterface::SupportsWriteWatch()
 //  size    - size of the virtual memory range
 void GCToOSInterface::ResetWriteWatch(void* address, size_t size)
 {
+    ::ResetWriteWatch(address, size);
 }
 
 // Retrieve addresses of the pages that are written to in a region of virtual memory
@@ -242,7 +243,10 @@ void GCToOSInterface::ResetWriteWatch(void* address, size_t size)
 //  true if it has succeeded, false if it has failed
 bool GCToOSInterface::GetWriteWatch(bool resetState, void* address, size_t size, void** pageAddresses, uintptr_t* pageAddressesCount)
 {
-    return false;
+    uint32_t flags = resetState ? 1 : 0;
+    ULONG granularity;
+
+    return ::GetWriteWatch(flags, address, size, pageAddresses, (ULONG_PTR*)pageAddressesCount, &granularity) == 0;
 }
 
 // Get size of the largest cache on the processor die
@@ -268,11 +268,11 @@ namespace System.Runtime
             RH_EH_FIRST_RETHROW_FRAME = 2,
         }
 
-        internal unsafe static void AppendExceptionStackFrameViaClasslib(
-            Exception exception, IntPtr IP, bool isFirstRethrowFrame, IntPtr classlibAddress, bool isFirstFrame)
+        // Reports a frame to the classlib's AppendExceptionStackFrame helper. Dispatch looks the helper up once
+        // per throw rather than once per frame and passes it in.
+        private static void AppendExceptionStackFrame(
+            IntPtr pAppendStackFrame, Exception exception, IntPtr IP, bool isFirstRethrowFrame, bool isFirstFrame)
         {
-            IntPtr pAppendStackFrame = (IntPtr)InternalCalls.RhpGetClasslibFunction(classlibAddress,
-                                                               ClassLibFunctionId.AppendExceptionStackFrame);
             int flags = (isFirstFrame ? (int)RhEHFrameType.RH_EH_FIRST_FRAME : 0) |
                         (isFirstRethrowFrame ? (int)RhEHFrameType.RH_EH_FIRST_RETHROW_FRAME : 0);
 
@@ -655,6 +655,10 @@ namespace System.Runtime
             UIntPtr prevFramePtr = UIntPtr.Zero;
             bool unwoundReversePInvoke = false;
 
+            // Every frame is reported to the same classlib, the one the throwing code was compiled against.
+            IntPtr pAppendStackFrame = (IntPtr)InternalCalls.RhpGetClasslibFunction(exInfo._pExContext->IP,
+                                                               ClassLibFunctionId.AppendExceptionStackFrame);
+
             bool isValid = frameIter.Init(exInfo._pExContext);
             Debug.Assert(isValid, "RhThrowEx called with an unexpected context");
             DebuggerNotify.BeginFirstPass(exceptionObj, frameIter.ControlPC, frameIter.SP);
@@ -673,7 +677,7 @@ namespace System.Runtime
                 if (exInfo._notifyDebuggerSP == frameIter.SP)
                     DebuggerNotify.FirstPassFrameEntered(exceptionObj, frameIter.ControlPC, frameIter.SP);
 
-                UpdateStackTrace(exceptionObj, ref exInfo, ref isFirstRethrowFrame, ref prevFramePtr, ref isFirstFrame);
+                UpdateStackTrace(exceptionObj, ref exInfo, pAppendStackFrame, ref isFirstRethrowFrame, ref prevFramePtr, ref isFirstFrame);
 
                 byte* pHandler;
                 if (FindFirstPassHandler(exceptionObj, startIdx, ref frameIter,
@@ -759,7 +763,8 @@ namespace System.Runtime
                 "Handling frame must have a valid stack frame pointer");
         }
 
-        private static void UpdateStackTrace(Exception exceptionObj, ref ExInfo exInfo, ref bool isFirstRethrowFrame, ref UIntPtr prevFramePtr, ref bool isFirstFrame)
+        private static void UpdateStackTrace(Exception exceptionObj, ref ExInfo exInfo, IntPtr pAppendStackFrame,
+                                             ref bool isFirstRethrowFrame, ref UIntPtr prevFramePtr, ref bool isFirstFrame)
         {
             // We use the fact that all funclet stack frames belonging to the same logical method activation 
             // will have the same FramePointer value.  Additionally, the stackwalker will return a sequence of
@@ -770,8 +775,8 @@ namespace System.Runtime
             UIntPtr curFramePtr = exInfo._frameIter.FramePointer;
             if ((prevFramePtr == UIntPtr.Zero) || (curFramePtr != prevFramePtr))
             {
-                AppendExceptionStackFrameViaClasslib(exceptionObj, (IntPtr)exInfo._frameIter.ControlPC,
-                                                     isFirstRethrowFrame, exInfo._pExContext->IP, isFirstFrame);
+                AppendExceptionStackFrame(pAppendStackFrame, exceptionObj, (IntPtr)exInfo._frameIter.ControlPC,
+                                          isFirstRethrowFrame, isFirstFrame);
             }
             prevFramePtr = curFramePtr;
             isFirstRethrowFrame = false;
@@ -104,6 +104,46 @@ namespace System.Runtime
         [ManuallyManaged(GcPollPolicy.Sometimes)]
         internal unsafe extern static void RhUnbox(object obj, void* pData, EEType* pUnboxToEEType);
 
+        [RuntimeImport(Redhawk.BaseName, "RhpNewBoxed1")]
+        [MethodImpl(MethodImplOptions.InternalCall)]
+        [ManuallyManaged(GcPollPolicy.Sometimes)]
+        internal unsafe extern static object RhpNewBoxed1(EEType* pEEType, void* pData);
+
+        [RuntimeImport(Redhawk.BaseName, "RhpNewBoxed2")]
+        [MethodImpl(MethodImplOptions.InternalCall)]
+        [ManuallyManaged(GcPollPolicy.Sometimes)]
+        internal unsafe extern static object RhpNewBoxed2(EEType* pEEType, void* pData);
+
+        [RuntimeImport(Redhawk.BaseName, "RhpNewBoxed4")]
+        [MethodImpl(MethodImplOptions.InternalCall)]
+        [ManuallyManaged(GcPollPolicy.Sometimes)]
+        internal unsafe extern static object RhpNewBoxed4(EEType* pEEType, void* pData);
+
+        [RuntimeImport(Redhawk.BaseName, "RhpNewBoxed8")]
+        [MethodImpl(MethodImplOptions.InternalCall)]
+        [ManuallyManaged(GcPollPolicy.Sometimes)]
+        internal unsafe extern static object RhpNewBoxed8(EEType* pEEType, void* pData);
+
+        [RuntimeImport(Redhawk.BaseName, "RhpUnbox1")]
+        [MethodImpl(MethodImplOptions.InternalCall)]
+        [ManuallyManaged(GcPollPolicy.Sometimes)]
+        internal unsafe extern static void RhpUnbox1(object obj, void* pData, EEType* pUnboxToEEType);
+
+        [RuntimeImport(Redhawk.BaseName, "RhpUnbox2")]
+        [MethodImpl(MethodImplOptions.InternalCall)]
+        [ManuallyManaged(GcPollPolicy.Sometimes)]
+        internal unsafe extern static void RhpUnbox2(object obj, void* pData, EEType* pUnboxToEEType);
+
+        [RuntimeImport(Redhawk.BaseName, "RhpUnbox4")]
+        [MethodImpl(MethodImplOptions.InternalCall)]
+        [ManuallyManaged(GcPollPolicy.Sometimes)]
+        internal unsafe extern static void RhpUnbox4(object obj, void* pData, EEType* pUnboxToEEType);
+
+        [RuntimeImport(Redhawk.BaseName, "RhpUnbox8")]
+        [MethodImpl(MethodImplOptions.InternalCall)]
+        [ManuallyManaged(GcPollPolicy.Sometimes)]
+        internal unsafe extern static void RhpUnbox8(object obj, void* pData, EEType* pUnboxToEEType);
+
         [RuntimeImport(Redhawk.BaseName, "RhpCopyObjectContents")]
         [MethodImpl(MethodImplOptions.InternalCall)]
         [ManuallyManaged(GcPollPolicy.Never)]
@@ -144,16 +144,57 @@ namespace System.Runtime
             if (ptrEEType->RequiresAlign8)
             {
                 result = InternalCalls.RhpNewFastMisalign(ptrEEType);
+                InternalCalls.RhpBox(result, pData);
+                return result;
             }
-            else
 #endif // FEATURE_64BIT_ALIGNMENT
+
+            // Primitives and enums allocate and copy in a single call.
+            switch (GetPrimitiveValueSize(ptrEEType))
             {
-                result = InternalCalls.RhpNewFast(ptrEEType);
+                case 1: return InternalCalls.RhpNewBoxed1(ptrEEType, pData);
+                case 2: return InternalCalls.RhpNewBoxed2(ptrEEType, pData);
+                case 4: return InternalCalls.RhpNewBoxed4(ptrEEType, pData);
+                case 8: return InternalCalls.RhpNewBoxed8(ptrEEType, pData);
             }
+
+            result = InternalCalls.RhpNewFast(ptrEEType);
             InternalCalls.RhpBox(result, pData);
             return result;
         }
 
+        // Returns the size of the value of primitives and enums (whose EEType carries the underlying primitive
+        // CorElementType), the shapes the fixed size RhpNewBoxed<N> and RhpUnbox<N> helpers handle. Returns 0
+        // for every other type, including native ints and other structs.
+        private static unsafe int GetPrimitiveValueSize(EEType* pEEType)
+        {
+            switch (pEEType->CorElementType)
+            {
+                case TypeCast.CorElementType.ELEMENT_TYPE_BOOLEAN:
+                case TypeCast.CorElementType.ELEMENT_TYPE_I1:
+                case TypeCast.CorElementType.ELEMENT_TYPE_U1:
+                    return 1;
+
+                case TypeCast.CorElementType.ELEMENT_TYPE_CHAR:
+                case TypeCast.CorElementType.ELEMENT_TYPE_I2:
+                case TypeCast.CorElementType.ELEMENT_TYPE_U2:
+                    return 2;
+
+                case TypeCast.CorElementType.ELEMENT_TYPE_I4:
+                case TypeCast.CorElementType.ELEMENT_TYPE_U4:
+                case TypeCast.CorElementType.ELEMENT_TYPE_R4:
+                    return 4;
+
+                case TypeCast.CorElementType.ELEMENT_TYPE_I8:
+                case TypeCast.CorElementType.ELEMENT_TYPE_U8:
+                case TypeCast.CorElementType.ELEMENT_TYPE_R8:
+                    return 8;
+
+                default:
+                    return 0;
+            }
+        }
+
         // this serves as a kind of union where:
         // - the field o is used if the struct wraps a reference type
         // - the field p is used together with pointer arithmetic if the struct is a valuetype
@@ -211,7 +252,16 @@ namespace System.Runtime
 
                         BinderIntrinsics.TailCall_RhpThrowEx(e);
                     }
-                    InternalCalls.RhUnbox(o, pData - 1, ptrUnboxToEEType);
+                    // The type check above guarantees o is a primitive or enum of the target's size unless
+                    // the target is Nullable.
+                    switch (ptrUnboxToEEType->IsNullable ? 0 : GetPrimitiveValueSize(ptrUnboxToEEType))
+                    {
+                        case 1: InternalCalls.RhpUnbox1(o, pData - 1, ptrUnboxToEEType); break;
+                        case 2: InternalCalls.RhpUnbox2(o, pData - 1, ptrUnboxToEEType); break;
+                        case 4: InternalCalls.RhpUnbox4(o, pData - 1, ptrUnboxToEEType); break;
+                        case 8: InternalCalls.RhpUnbox8(o, pData - 1, ptrUnboxToEEType); break;
+                        default: InternalCalls.RhUnbox(o, pData - 1, ptrUnboxToEEType); break;
+                    }
                 }
             }
             else
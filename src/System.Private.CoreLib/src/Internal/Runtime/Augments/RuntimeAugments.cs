@@ -154,6 +154,23 @@ namespace Internal.Runtime.Augments
             return RuntimeImports.RhGetRuntimeHelperForType(CreateEETypePtr(type), RuntimeImports.RuntimeHelperKind.CheckArrayElementType);
         }
 
+        //
+        // Returns a helper with the signature object(EETypePtr, void*) that allocates and boxes values of the
+        // given type, or IntPtr.Zero if the type isn't one of the shapes the runtime specializes.
+        //
+        public static IntPtr GetBoxHelperForType(RuntimeTypeHandle type)
+        {
+            return RuntimeImports.RhGetRuntimeHelperForType(CreateEETypePtr(type), RuntimeImports.RuntimeHelperKind.Box);
+        }
+
+        //
+        // Returns a helper with the same signature as RhUnbox for unboxing to the given type.
+        //
+        public static IntPtr GetUnboxHelperForType(RuntimeTypeHandle type)
+        {
+            return RuntimeImports.RhGetRuntimeHelperForType(CreateEETypePtr(type), RuntimeImports.RuntimeHelperKind.Unbox);
+        }
+
         public static IntPtr GetDispatchMapForType(RuntimeTypeHandle typeHandle)
         {
             return RuntimeImports.RhGetDispatchMapForType(CreateEETypePtr(typeHandle));
@@ -144,8 +144,8 @@ namespace System
 
         internal unsafe static void ZeroMemory(byte* src, long len)
         {
-            while (len-- > 0)
-                *(src + len) = 0;
+            if (len > 0)
+                _ZeroMemory(src, (nuint)len);
         }
 
         public static int ByteLength(Array array)
@@ -241,7 +241,7 @@ namespace System
         [System.Security.SecurityCritical]
         internal unsafe static void Memmove(byte* dest, byte* src, nuint len)
         {
-            // P/Invoke into the native version when the buffers are overlapping and the copy needs to be performed backwards
+            // Call the native version when the buffers are overlapping and the copy needs to be performed backwards
             // This check can produce false positives for lengths greater than Int32.MaxInt. It is fine because we want to use PInvoke path for the large lengths anyway.
             if ((nuint)dest - (nuint)src < len)
             {
@@ -377,7 +377,7 @@ namespace System
                     break;
             }
 
-            // P/Invoke into the native version for large lengths.
+            // Call the native version for large lengths.
             if (len >= 200)
             {
                 _Memmove(dest, src, len);
@@ -457,13 +457,30 @@ namespace System
 #endif // ALIGN_ACCESS
         }
 
-        // Non-inlinable wrapper around the QCall that avoids poluting the fast path
+        // Copies and fills up to this size call the runtime without a transition frame. Larger ones take long enough
+        // that the p/invoke transition doesn't matter, and it lets the GC suspend the thread in the meantime.
+        private const nuint MaxCooperativeMemoryOperationLength = 64 * 1024;
+
+        // Non-inlinable wrapper around the native calls that avoids poluting the fast path
         // with P/Invoke prolog/epilog.
         [System.Security.SecurityCritical]
         [MethodImplAttribute(MethodImplOptions.NoInlining)]
         private unsafe static void _Memmove(byte* dest, byte* src, nuint len)
         {
-            RuntimeImports.memmove(dest, src, len);
+            if (len <= MaxCooperativeMemoryOperationLength)
+                RuntimeImports.RhpMemoryMove(dest, src, (UIntPtr)len);
+            else
+                RuntimeImports.RhMemoryMove(dest, src, (UIntPtr)len);
+        }
+
+        [System.Security.SecurityCritical]
+        [MethodImplAttribute(MethodImplOptions.NoInlining)]
+        private unsafe static void _ZeroMemory(byte* dest, nuint len)
+        {
+            if (len <= MaxCooperativeMemoryOperationLength)
+                RuntimeImports.RhpMemoryFill(dest, 0, (UIntPtr)len);
+            else
+                RuntimeImports.RhMemoryFill(dest, 0, (UIntPtr)len);
         }
     }
 }
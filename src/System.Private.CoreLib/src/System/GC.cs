@@ -35,6 +35,37 @@ namespace System
         Optimized = 0x00000004,
     }
 
+    // !!!!!!!!!!!!!!!!!!!!!!!
+    // Make sure you change the def in gc\gc.h if you change this!
+    internal enum StartNoGCRegionStatus
+    {
+        Succeeded = 0,
+        NotEnoughMemory = 1,
+        AmountTooLarge = 2,
+        AlreadyInProgress = 3
+    }
+
+    // !!!!!!!!!!!!!!!!!!!!!!!
+    // Make sure you change the def in gc\gc.h if you change this!
+    internal enum EndNoGCRegionStatus
+    {
+        Succeeded = 0,
+        NotInProgress = 1,
+        GCInduced = 2,
+        AllocationExceeded = 3
+    }
+
+    // !!!!!!!!!!!!!!!!!!!!!!!
+    // Make sure you change the def in gc\gc.h (wait_full_gc_status) if you change this!
+    public enum GCNotificationStatus
+    {
+        Succeeded = 0,
+        Failed = 1,
+        Canceled = 2,
+        Timeout = 3,
+        NotApplicable = 4
+    }
+
     public static class GC
     {
         public static int GetGeneration(Object obj)
@@ -141,82 +172,38 @@ namespace System
             return RuntimeImports.RhGetGcCollectionCount(generation, false);
         }
 
-        // Support for AddMemoryPressure and RemoveMemoryPressure below.
-        private const uint PressureCount = 4;
-#if BIT64
-        private const uint MinGCMemoryPressureBudget = 4 * 1024 * 1024;
-#else
-        private const uint MinGCMemoryPressureBudget = 3 * 1024 * 1024;
-#endif
-
-        private const uint MaxGCMemoryPressureRatio = 10;
-
-        private static int[] s_gcCounts = new int[] { 0, 0, 0 };
-
-        private static long[] s_addPressure = new long[] { 0, 0, 0, 0 };
-        private static long[] s_removePressure = new long[] { 0, 0, 0, 0 };
-        private static uint s_iteration = 0;
-
         /// <summary>
-        /// Resets the pressure accounting after a gen2 GC has occured.
+        /// Informs the GC of unmanaged memory kept alive by a managed object. The GC charges the unmanaged
+        /// memory registered since a generation was last collected against that generation's allocation
+        /// budget, so the collections it triggers follow its own tuning.
         /// </summary>
-        private static void CheckCollectionCount()
+        /// <param name="bytesAllocated"></param>
+        [SecurityCritical] // required to match contract
+        public static void AddMemoryPressure(long bytesAllocated)
         {
-            if (s_gcCounts[2] != CollectionCount(2))
+            if (bytesAllocated <= 0)
             {
-                for (int i = 0; i < 3; i++)
-                {
-                    s_gcCounts[i] = CollectionCount(i);
-                }
-
-                s_iteration++;
-
-                uint p = s_iteration % PressureCount;
-
-                s_addPressure[p] = 0;
-                s_removePressure[p] = 0;
+                throw new ArgumentOutOfRangeException("bytesAllocated",
+                        SR.ArgumentOutOfRange_NeedPosNum);
             }
-        }
-
-        private static long InterlockedAddMemoryPressure(ref long pAugend, long addend)
-        {
-            long oldMemValue;
-            long newMemValue;
 
-            do
+#if !BIT64
+            if (bytesAllocated > Int32.MaxValue)
             {
-                oldMemValue = pAugend;
-                newMemValue = oldMemValue + addend;
-
-                // check for overflow
-                if (newMemValue < oldMemValue)
-                {
-                    newMemValue = long.MaxValue;
-                }
-            } while (Interlocked.CompareExchange(ref pAugend, newMemValue, oldMemValue) != oldMemValue);
+                throw new ArgumentOutOfRangeException("bytesAllocated",
+                        SR.ArgumentOutOfRange_MustBeNonNegInt32);
+            }
+#endif
 
-            return newMemValue;
+            int generation = RuntimeImports.RhAddMemoryPressure(bytesAllocated);
+            if (generation >= 0)
+            {
+                RuntimeImports.RhCollect(generation, InternalGCCollectionMode.NonBlocking);
+            }
         }
 
-        /// <summary>
-        /// New AddMemoryPressure implementation (used by RCW and the CLRServicesImpl class)
-        /// 1. Less sensitive than the original implementation (start budget 3 MB)
-        /// 2. Focuses more on newly added memory pressure
-        /// 3. Budget adjusted by effectiveness of last 3 triggered GC (add / remove ratio, max 10x)
-        /// 4. Budget maxed with 30% of current managed GC size
-        /// 5. If Gen2 GC is happening naturally, ignore past pressure
-        /// 
-        /// Here's a brief description of the ideal algorithm for Add/Remove memory pressure:
-        /// Do a GC when (HeapStart is less than X * MemPressureGrowth) where
-        /// - HeapStart is GC Heap size after doing the last GC
-        /// - MemPressureGrowth is the net of Add and Remove since the last GC
-        /// - X is proportional to our guess of the ummanaged memory death rate per GC interval,
-        /// and would be calculated based on historic data using standard exponential approximation:
-        /// Xnew = UMDeath/UMTotal * 0.5 + Xprev
-        /// </summary>
-        /// <param name="bytesAllocated"></param>
         [SecurityCritical] // required to match contract
-        public static void AddMemoryPressure(long bytesAllocated)
+        public static void RemoveMemoryPressure(long bytesAllocated)
         {
             if (bytesAllocated <= 0)
             {
@@ -232,79 +219,150 @@ namespace System
             }
 #endif
 
-            CheckCollectionCount();
-            uint p = s_iteration % PressureCount;
-            long newMemValue = InterlockedAddMemoryPressure(ref s_addPressure[p], bytesAllocated);
+            RuntimeImports.RhRemoveMemoryPressure(bytesAllocated);
+        }
 
-            Debug.Assert(PressureCount == 4, "GC.AddMemoryPressure contains unrolled loops which depend on the PressureCount");
+        [SecurityCritical] // required to match contract
+        public static bool TryStartNoGCRegion(long totalSize)
+        {
+            return StartNoGCRegionWorker(totalSize, false, 0, false);
+        }
 
-            if (newMemValue >= MinGCMemoryPressureBudget)
-            {
-                long add = s_addPressure[0] + s_addPressure[1] + s_addPressure[2] + s_addPressure[3] - s_addPressure[p];
-                long rem = s_removePressure[0] + s_removePressure[1] + s_removePressure[2] + s_removePressure[3] - s_removePressure[p];
+        [SecurityCritical] // required to match contract
+        public static bool TryStartNoGCRegion(long totalSize, long lohSize)
+        {
+            return StartNoGCRegionWorker(totalSize, true, lohSize, false);
+        }
 
-                long budget = MinGCMemoryPressureBudget;
+        [SecurityCritical] // required to match contract
+        public static bool TryStartNoGCRegion(long totalSize, bool disallowFullBlockingGC)
+        {
+            return StartNoGCRegionWorker(totalSize, false, 0, disallowFullBlockingGC);
+        }
 
-                if (s_iteration >= PressureCount)  // wait until we have enough data points
+        [SecurityCritical] // required to match contract
+        public static bool TryStartNoGCRegion(long totalSize, long lohSize, bool disallowFullBlockingGC)
+        {
+            return StartNoGCRegionWorker(totalSize, true, lohSize, disallowFullBlockingGC);
+        }
+
+        private static bool StartNoGCRegionWorker(long totalSize, bool hasLohSize, long lohSize, bool disallowFullBlockingGC)
+        {
+            if (totalSize <= 0)
+            {
+                throw new ArgumentOutOfRangeException("totalSize", SR.ArgumentOutOfRange_NeedPosNum);
+            }
+
+            if (hasLohSize)
+            {
+                if (lohSize <= 0)
                 {
-                    // Adjust according to effectiveness of GC
-                    // Scale budget according to past m_addPressure / m_remPressure ratio
-                    if (add >= rem * MaxGCMemoryPressureRatio)
-                    {
-                        budget = MinGCMemoryPressureBudget * MaxGCMemoryPressureRatio;
-                    }
-                    else if (add > rem)
-                    {
-                        Debug.Assert(rem != 0);
-
-                        // Avoid overflow by calculating addPressure / remPressure as fixed point (1 = 1024)
-                        budget = (add * 1024 / rem) * budget / 1024;
-                    }
+                    throw new ArgumentOutOfRangeException("lohSize", SR.ArgumentOutOfRange_NeedPosNum);
                 }
 
-                // If still over budget, check current managed heap size
-                if (newMemValue >= budget)
+                if (lohSize > totalSize)
                 {
-                    long heapOver3 = RuntimeImports.RhGetCurrentObjSize() / 3;
-
-                    if (budget < heapOver3)  //Max
-                    {
-                        budget = heapOver3;
-                    }
-
-                    if (newMemValue >= budget)
-                    {
-                        // last check - if we would exceed 20% of GC "duty cycle", do not trigger GC at this time
-                        if ((RuntimeImports.RhGetGCNow() - RuntimeImports.RhGetLastGCStartTime(2)) > (RuntimeImports.RhGetLastGCDuration(2) * 5))
-                        {
-                            RuntimeImports.RhCollect(2, InternalGCCollectionMode.NonBlocking);
-                            CheckCollectionCount();
-                        }
-                    }
+                    throw new ArgumentOutOfRangeException("lohSize", SR.ArgumentOutOfRange_NoGCLohSizeGreaterTotalSize);
                 }
             }
+
+            StartNoGCRegionStatus status = (StartNoGCRegionStatus)RuntimeImports.RhStartNoGCRegion(totalSize,
+                hasLohSize ? 1 : 0, lohSize, disallowFullBlockingGC ? 1 : 0);
+
+            switch (status)
+            {
+                case StartNoGCRegionStatus.NotEnoughMemory:
+                    return false;
+                case StartNoGCRegionStatus.AlreadyInProgress:
+                    throw new InvalidOperationException(SR.InvalidOperation_NoGCRegionInProgress);
+                case StartNoGCRegionStatus.AmountTooLarge:
+                    throw new ArgumentOutOfRangeException("totalSize", SR.ArgumentOutOfRange_NoGCRegionSizeTooLarge);
+            }
+
+            Debug.Assert(status == StartNoGCRegionStatus.Succeeded);
+            return true;
         }
 
         [SecurityCritical] // required to match contract
-        public static void RemoveMemoryPressure(long bytesAllocated)
+        public static void EndNoGCRegion()
         {
-            if (bytesAllocated <= 0)
+            EndNoGCRegionStatus status = (EndNoGCRegionStatus)RuntimeImports.RhEndNoGCRegion();
+
+            switch (status)
             {
-                throw new ArgumentOutOfRangeException("bytesAllocated",
-                        SR.ArgumentOutOfRange_NeedPosNum);
+                case EndNoGCRegionStatus.NotInProgress:
+                    throw new InvalidOperationException(SR.InvalidOperation_NoGCRegionNotInProgress);
+                case EndNoGCRegionStatus.GCInduced:
+                    throw new InvalidOperationException(SR.InvalidOperation_NoGCRegionInduced);
+                case EndNoGCRegionStatus.AllocationExceeded:
+                    throw new InvalidOperationException(SR.InvalidOperation_NoGCRegionAllocationExceeded);
             }
 
-#if !BIT64
-            if (bytesAllocated > Int32.MaxValue)
+            Debug.Assert(status == EndNoGCRegionStatus.Succeeded);
+        }
+
+        [SecurityCritical] // required to match contract
+        public static void RegisterForFullGCNotification(int maxGenerationThreshold, int largeObjectHeapThreshold)
+        {
+            if ((maxGenerationThreshold <= 0) || (maxGenerationThreshold >= 100))
             {
-                throw new ArgumentOutOfRangeException("bytesAllocated",
-                        SR.ArgumentOutOfRange_MustBeNonNegInt32);
+                throw new ArgumentOutOfRangeException("maxGenerationThreshold",
+                    SR.Format(SR.ArgumentOutOfRange_Bounds_Lower_Upper, 1, 99));
+            }
+
+            if ((largeObjectHeapThreshold <= 0) || (largeObjectHeapThreshold >= 100))
+            {
+                throw new ArgumentOutOfRangeException("largeObjectHeapThreshold",
+                    SR.Format(SR.ArgumentOutOfRange_Bounds_Lower_Upper, 1, 99));
+            }
+
+            if (!RuntimeImports.RhRegisterForFullGCNotification(maxGenerationThreshold, largeObjectHeapThreshold))
+            {
+                throw new InvalidOperationException(SR.InvalidOperation_NotWithConcurrentGC);
+            }
+        }
+
+        [SecurityCritical] // required to match contract
+        public static void CancelFullGCNotification()
+        {
+            if (!RuntimeImports.RhCancelFullGCNotification())
+            {
+                throw new InvalidOperationException(SR.InvalidOperation_NotWithConcurrentGC);
+            }
+        }
+
+        [SecurityCritical] // required to match contract
+        public static GCNotificationStatus WaitForFullGCApproach()
+        {
+            return (GCNotificationStatus)RuntimeImports.RhWaitForFullGCApproach(-1);
+        }
+
+        [SecurityCritical] // required to match contract
+        public static GCNotificationStatus WaitForFullGCApproach(int millisecondsTimeout)
+        {
+            if (millisecondsTimeout < -1)
+            {
+                throw new ArgumentOutOfRangeException("millisecondsTimeout", SR.ArgumentOutOfRange_NeedNonNegOrNegative1);
+            }
+
+            return (GCNotificationStatus)RuntimeImports.RhWaitForFullGCApproach(millisecondsTimeout);
+        }
+
+        [SecurityCritical] // required to match contract
+        public static GCNotificationStatus WaitForFullGCComplete()
+        {
+            return (GCNotificationStatus)RuntimeImports.RhWaitForFullGCComplete(-1);
+        }
+
+        [SecurityCritical] // required to match contract
+        public static GCNotificationStatus WaitForFullGCComplete(int millisecondsTimeout)
+        {
+            if (millisecondsTimeout < -1)
+            {
+                throw new ArgumentOutOfRangeException("millisecondsTimeout", SR.ArgumentOutOfRange_NeedNonNegOrNegative1);
             }
-#endif
 
-            CheckCollectionCount();
-            uint p = s_iteration % PressureCount;
-            InterlockedAddMemoryPressure(ref s_removePressure[p], bytesAllocated);
+            return (GCNotificationStatus)RuntimeImports.RhWaitForFullGCComplete(millisecondsTimeout);
         }
 
         public static long GetTotalMemory(bool forceFullCollection)
@@ -49,67 +49,9 @@ namespace System.Runtime.CompilerServices
             return RuntimeImports.RhMemberwiseClone(obj);
         }
 
-        private const int HASHCODE_BITS = 26;
-        private const int MASK_HASHCODE = (1 << (int)HASHCODE_BITS) - 1;
-
-        [ThreadStatic]
-        private static int t_hashSeed;
-
-        private static int GetNewHashCode()
-        {
-            int multiplier = Environment.CurrentManagedThreadId * 4 + 5;
-            // Every thread has its own generator for hash codes so that we won't get into a situation
-            // where two threads consistently give out the same hash codes.
-            // Choice of multiplier guarantees period of 2**32 - see Knuth Vol 2 p16 (3.2.1.2 Theorem A).
-            t_hashSeed = t_hashSeed * multiplier + 1;
-            return t_hashSeed;
-        }
-
-        public static unsafe int GetHashCode(Object o)
-        {
-            if (o == null)
-                return 0;
-
-            fixed (IntPtr* pEEType = &o.m_pEEType)
-            {
-                int* pSyncBlockIndex = (int*)((byte*)pEEType - 4); // skipping exactly 4 bytes for the SyncTableEntry (exactly 4 bytes not a pointer size).
-                int hash = *pSyncBlockIndex & MASK_HASHCODE;
-
-                if (hash == 0)
-                    return MakeHashCode(o, pSyncBlockIndex);
-                else
-                    return hash;
-            }
-        }
-
-        private static unsafe int MakeHashCode(Object o, int* pSyncBlockIndex)
+        public static int GetHashCode(Object o)
         {
-            int hash = GetNewHashCode() & MASK_HASHCODE;
-
-            if (hash == 0)
-                hash = 1;
-
-            while (true)
-            {
-                int oldIndex = Volatile.Read(ref *pSyncBlockIndex);
-
-                int currentHash = oldIndex & MASK_HASHCODE;
-                if (currentHash != 0)
-                {
-                    // Someone else set the hash code.
-                    hash = currentHash;
-                    break;
-                }
-
-                int newIndex = oldIndex | hash;
-
-                if (Interlocked.CompareExchange(ref *pSyncBlockIndex, newIndex, oldIndex) == oldIndex)
-                    break;
-                // If we get here someone else modified the header.  They may have set the hash code, or maybe some
-                // other bits.  Let's try again.
-            }
-
-            return (int)hash;
+            return ObjectHeader.GetHashCode(o);
         }
 
         public static int OffsetToStringData
@@ -92,20 +92,52 @@ namespace System.Runtime
         internal static extern void RhSetLohCompactionMode(int newLohCompactionMode);
 
         [MethodImpl(MethodImplOptions.InternalCall)]
-        [RuntimeImport(RuntimeLibrary, "RhGetCurrentObjSize")]
-        internal static extern long RhGetCurrentObjSize();
+        [RuntimeImport(RuntimeLibrary, "RhGetApproxGcTotalMemory")]
+        internal static extern long RhGetApproxGcTotalMemory();
 
         [MethodImpl(MethodImplOptions.InternalCall)]
-        [RuntimeImport(RuntimeLibrary, "RhGetGCNow")]
-        internal static extern long RhGetGCNow();
+        [RuntimeImport(RuntimeLibrary, "RhGetAllocatedBytesForCurrentThread")]
+        internal static extern long RhGetAllocatedBytesForCurrentThread();
 
+        // Bucket -1 gets the totals of all the strings the last background GC looked at.
         [MethodImpl(MethodImplOptions.InternalCall)]
-        [RuntimeImport(RuntimeLibrary, "RhGetLastGCStartTime")]
-        internal static extern long RhGetLastGCStartTime(int generation);
+        [RuntimeImport(RuntimeLibrary, "RhGetStringDedupStats")]
+        internal static unsafe extern bool RhGetStringDedupStats(int bucket, long* pCount, long* pBytes);
 
+        // Returns the generation to collect because of the added pressure, or -1.
         [MethodImpl(MethodImplOptions.InternalCall)]
-        [RuntimeImport(RuntimeLibrary, "RhGetLastGCDuration")]
-        internal static extern long RhGetLastGCDuration(int generation);
+        [RuntimeImport(RuntimeLibrary, "RhAddMemoryPressure")]
+        internal static extern int RhAddMemoryPressure(long bytesAllocated);
+
+        [MethodImpl(MethodImplOptions.InternalCall)]
+        [RuntimeImport(RuntimeLibrary, "RhRemoveMemoryPressure")]
+        internal static extern void RhRemoveMemoryPressure(long bytesAllocated);
+
+        // Start and end a no GC region. These must be p/invokes since starting the region performs a GC.
+        [DllImport(RuntimeLibrary, ExactSpelling = true)]
+        internal static extern int RhStartNoGCRegion(long totalSize, int hasLohSize, long lohSize, int disallowFullBlockingGC);
+
+        [DllImport(RuntimeLibrary, ExactSpelling = true)]
+        internal static extern int RhEndNoGCRegion();
+
+        [MethodImpl(MethodImplOptions.InternalCall)]
+        [RuntimeImport(RuntimeLibrary, "RhGetNoGCRegionStatus")]
+        internal static extern int RhGetNoGCRegionStatus();
+
+        [MethodImpl(MethodImplOptions.InternalCall)]
+        [RuntimeImport(RuntimeLibrary, "RhRegisterForFullGCNotification")]
+        internal static extern bool RhRegisterForFullGCNotification(int maxGenerationThreshold, int largeObjectHeapThreshold);
+
+        [MethodImpl(MethodImplOptions.InternalCall)]
+        [RuntimeImport(RuntimeLibrary, "RhCancelFullGCNotification")]
+        internal static extern bool RhCancelFullGCNotification();
+
+        // Wait for full GC notifications. These must be p/invokes since they block the calling thread.
+        [DllImport(RuntimeLibrary, ExactSpelling = true)]
+        internal static extern int RhWaitForFullGCApproach(int millisecondsTimeout);
+
+        [DllImport(RuntimeLibrary, ExactSpelling = true)]
+        internal static extern int RhWaitForFullGCComplete(int millisecondsTimeout);
         //
         // calls for GCHandle.
         // These methods are needed to implement GCHandle class like functionality (optional)
@@ -247,6 +279,17 @@ namespace System.Runtime
         [RuntimeImport(RuntimeLibrary, "RhYield")]
         internal static extern bool RhYield();
 
+        // Block while *address equals comparand, until RhWakeByAddress is called for the address or the timeout
+        // expires. Returns 0 on timeout. Can return early, so callers have to check the value again. The memory
+        // must stay pinned while waiting. This must be a p/invoke since it blocks.
+        [DllImport(RuntimeLibrary, ExactSpelling = true)]
+        internal static unsafe extern int RhWaitOnAddress(int* address, int comparand, int millisecondsTimeout);
+
+        // Wake one or all of the threads blocked in RhWaitOnAddress on the address.
+        [MethodImpl(MethodImplOptions.InternalCall)]
+        [RuntimeImport(RuntimeLibrary, "RhWakeByAddress")]
+        internal static unsafe extern void RhWakeByAddress(int* address, bool wakeAll);
+
         // Wait for any object to be signalled, in a way that's compatible with the CLR's behavior in an STA.
         // ExactSpelling = 'true' to force MCG to resolve it to default
         [DllImport(RuntimeLibrary, ExactSpelling = true)]
@@ -405,6 +448,8 @@ namespace System.Runtime
             CastClass,
             AllocateArray,
             CheckArrayElementType,
+            Box,        // IntPtr.Zero if the type has no specialized box helper, use RhBox then
+            Unbox,
         }
 
         [MethodImplAttribute(MethodImplOptions.InternalCall)]
@@ -469,6 +514,10 @@ namespace System.Runtime
         [RuntimeImport(RuntimeLibrary, "RhGetLoadedModules")]
         internal static extern uint RhGetLoadedModules(IntPtr[] resultArray);
 
+        [MethodImplAttribute(MethodImplOptions.InternalCall)]
+        [RuntimeImport(RuntimeLibrary, "RhGetRuntimeHeapBytes")]
+        internal static unsafe extern void RhGetRuntimeHeapBytes(ulong* pLiveBytes, ulong* pReservedBytes);
+
         [MethodImplAttribute(MethodImplOptions.InternalCall)]
         [RuntimeImport(RuntimeLibrary, "RhGetModuleFromPointer")]
         internal static extern IntPtr RhGetModuleFromPointer(IntPtr pointerVal);
@@ -691,13 +740,22 @@ namespace System.Runtime
         [DllImport(RuntimeImports.RuntimeLibrary, ExactSpelling = true)]
         internal static unsafe extern void _ecvt_s(byte* buffer, int sizeInBytes, double value, int count, int* dec, int* sign);
 
-#if BIT64
+        // Copy and fill memory without a transition frame. The GC can't suspend the thread until they return, so only
+        // use them for sizes that take a short time.
+        [MethodImpl(MethodImplOptions.InternalCall)]
+        [RuntimeImport(RuntimeLibrary, "RhpMemoryMove")]
+        internal static unsafe extern void RhpMemoryMove(byte* dmem, byte* smem, UIntPtr size);
+
+        [MethodImpl(MethodImplOptions.InternalCall)]
+        [RuntimeImport(RuntimeLibrary, "RhpMemoryFill")]
+        internal static unsafe extern void RhpMemoryFill(byte* dmem, int value, UIntPtr size);
+
+        // P/invoke versions of the above for large sizes.
         [DllImport(RuntimeImports.RuntimeLibrary, ExactSpelling = true)]
-        internal static unsafe extern void memmove(byte* dmem, byte* smem, ulong size);
-#else
+        internal static unsafe extern void RhMemoryMove(byte* dmem, byte* smem, UIntPtr size);
+
         [DllImport(RuntimeImports.RuntimeLibrary, ExactSpelling = true)]
-        internal static unsafe extern void memmove(byte* dmem, byte* smem, uint size);
-#endif
+        internal static unsafe extern void RhMemoryFill(byte* dmem, int value, UIntPtr size);
 
         [MethodImpl(MethodImplOptions.InternalCall)]
         [RuntimeImport(RuntimeLibrary, "RhpArrayCopy")]
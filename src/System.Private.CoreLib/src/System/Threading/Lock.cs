@@ -20,6 +20,15 @@ namespace System.Threading
         [PreInitialized]
         private static int s_maxSpinCount = -1; // -1 means the spin count has not yet beeen determined.
 
+        //
+        // Contended acquires spin for twice the number of iterations it recently took for the lock to be released
+        // (_spinEstimate), to ride out typical hold times without blocking. When the lock is typically held for
+        // longer than is worth spinning, they only spin briefly before waiting. Every SpinSampleInterval-th
+        // contended acquire spins for the maximum, so the estimate keeps up with changing hold times.
+        //
+        private const int MinSpinCount = 64;
+        private const int SpinSampleInterval = 16;
+
         //
         // IsLock is faster that "obj as Lock()", as it avoids the overhead of the full
         // casting logic in the runtime.  This is only safe because a) EETypePtr
@@ -41,10 +50,12 @@ namespace System.Threading
         //
         // bit 0: True if the lock is held, false otherwise.
         //
-        // bit 1: True if we've set the event to wake a waiting thread.  The waiter resets this to false when it 
-        //        wakes up.  This avoids the overhead of setting the event multiple times.
+        // bit 1: True if we've woken a waiting thread.  The waiter resets this to false when it wakes up.  This
+        //        avoids the overhead of waking threads multiple times.
+        //
+        // everything else: A count of the number of threads waiting for the lock.
         //
-        // everything else: A count of the number of threads waiting on the event.
+        // Waiting threads block on the address of _state itself (see WaitForStateChange).
         //
         private const int Locked = 1;
         private const int WaiterWoken = 2;
@@ -56,22 +67,8 @@ namespace System.Threading
 
         private int _owningThreadId;
         private uint _recursionCount;
-        private volatile AutoResetEvent _lazyEvent;
-
-        private AutoResetEvent Event
-        {
-            get
-            {
-                //
-                // Can't use LazyInitializer.EnsureInitialized because Lock needs to stay low level enough
-                // for the purposes of lazy generic lookups. LazyInitializer uses a generic delegate.
-                //
-                if (_lazyEvent == null)
-                    Interlocked.CompareExchange(ref _lazyEvent, new AutoResetEvent(false), null);
-
-                return _lazyEvent;
-            }
-        }
+        private int _spinEstimate;
+        private int _contendedAcquireCount;
 
         /// <remarks>Inlined version of Lock.Acquire has CurrentManagedThreadId not inlined, non-inlined version has it inlined.
         /// So it saves code to keep this function non inlining while keep the same runtime cost</remarks>
@@ -147,31 +144,33 @@ namespace System.Threading
             if (millisecondsTimeout == 0)
                 return false;
 
+            int spinLimit = GetSpinLimit();
+            int spun = 0;
             int spins = 1;
 
-            if (s_maxSpinCount < 0)
-            {
-                s_maxSpinCount = (Environment.ProcessorCount > 1) ? 10000 : 0;
-            }
-
             while (true)
             {
                 //
                 // Try to grab the lock.  We may take the lock here even if there are existing waiters.  This creates the possibility
                 // of starvation of waiters, but it also prevents lock convoys from destroying perf. 
-                // The starvation issue is largely mitigated by the priority boost the OS gives to a waiter when we set 
-                // the event, after we release the lock.  Eventually waiters will be boosted high enough to preempt this thread.
+                // The starvation issue is largely mitigated by the priority boost the OS gives to a waiter when we wake
+                // it, after we release the lock.  Eventually waiters will be boosted high enough to preempt this thread.
                 //
                 int oldState = _state;
                 if ((oldState & Locked) == 0 && Interlocked.CompareExchange(ref _state, oldState | Locked, oldState) == oldState)
+                {
+                    UpdateSpinEstimate(spun);
                     goto GotTheLock;
+                }
 
                 //
-                // Back off by a factor of 2 for each attempt, up to MaxSpinCount
+                // Back off by a factor of 2 for each attempt, up to the spin limit
                 //
-                if (spins <= s_maxSpinCount)
+                if (spun < spinLimit)
                 {
-                    System.Runtime.RuntimeImports.RhSpinWait(spins);
+                    int iterations = (spins < spinLimit - spun) ? spins : spinLimit - spun;
+                    System.Runtime.RuntimeImports.RhSpinWait(iterations);
+                    spun += iterations;
                     spins *= 2;
                 }
                 else
@@ -184,7 +183,11 @@ namespace System.Threading
                     //
                     int newState = (oldState + WaiterCountIncrement) & ~WaiterWoken;
                     if (Interlocked.CompareExchange(ref _state, newState, oldState) == oldState)
+                    {
+                        // All we know is that the lock was held for longer than we spun.
+                        UpdateSpinEstimate(spun * 2);
                         break;
+                    }
                 }
             }
 
@@ -192,13 +195,19 @@ namespace System.Threading
             // Now we wait.
             //
             TimeoutTracker timeoutTracker = TimeoutTracker.Start(millisecondsTimeout);
-            AutoResetEvent ev = Event;
 
             while (true)
             {
-                Contract.Assert(_state >= WaiterCountIncrement);
+                int state = _state;
+                Contract.Assert(state >= WaiterCountIncrement);
 
-                bool waitSucceeded = ev.WaitOne(timeoutTracker.Remaining);
+                //
+                // Don't go to sleep if the lock was released since we last looked, nobody would wake us. Don't go to
+                // sleep if WaiterWoken is set either: the wake may have happened before anyone was asleep, and unlike
+                // the event we used to wait on, a wake-up on an address isn't remembered. Releases don't wake anybody
+                // while the bit is set, so clear it below and look again.
+                //
+                bool waitSucceeded = ((state & (Locked | WaiterWoken)) != Locked) || WaitForStateChange(state, timeoutTracker.Remaining);
 
                 while (true)
                 {
@@ -242,6 +251,55 @@ namespace System.Threading
             return true;
         }
 
+        private int GetSpinLimit()
+        {
+            if (s_maxSpinCount < 0)
+            {
+                s_maxSpinCount = (Environment.ProcessorCount > 1) ? 10000 : 0;
+            }
+
+            int maxSpinCount = s_maxSpinCount;
+            if (maxSpinCount == 0)
+                return 0;
+
+            if ((_contendedAcquireCount++ & (SpinSampleInterval - 1)) == 0)
+                return maxSpinCount;
+
+            int spinLimit = _spinEstimate * 2;
+            if (spinLimit > maxSpinCount)
+                return MinSpinCount;
+
+            return (spinLimit < MinSpinCount) ? MinSpinCount : spinLimit;
+        }
+
+        private void UpdateSpinEstimate(int spun)
+        {
+            //
+            // Moving average weighing the new sample by 1/8.  Racing updates from several threads can lose a sample,
+            // which is fine for an estimate.
+            //
+            _spinEstimate += (spun - _spinEstimate) / 8;
+        }
+
+        private unsafe bool WaitForStateChange(int state, int millisecondsTimeout)
+        {
+            //
+            // The Lock stays pinned while we sleep, so that releasing it wakes the address we're sleeping on.
+            //
+            fixed (int* pState = &_state)
+            {
+                return System.Runtime.RuntimeImports.RhWaitOnAddress(pState, state, millisecondsTimeout) != 0;
+            }
+        }
+
+        private unsafe void WakeWaiter()
+        {
+            fixed (int* pState = &_state)
+            {
+                System.Runtime.RuntimeImports.RhWakeByAddress(pState, false);
+            }
+        }
+
         public bool IsAcquired
         {
             get
@@ -330,7 +388,7 @@ namespace System.Threading
                     newState |= WaiterWoken;
                     if (Interlocked.CompareExchange(ref _state, newState, oldState) == oldState)
                     {
-                        Event.Set();
+                        WakeWaiter();
                         return;
                     }
                 }
@@ -343,6 +401,19 @@ namespace System.Threading
             }
         }
 
+        //
+        // Used by SyncTable to move a thin lock out of an object header. The Lock isn't visible to other threads yet,
+        // so it can be set up without synchronization.
+        //
+        internal void InitializeLocked(int owningThreadId, uint recursionCount)
+        {
+            Contract.Assert(_state == Uncontended || _state == Locked);
+
+            _state = (owningThreadId != 0) ? Locked : Uncontended;
+            _owningThreadId = owningThreadId;
+            _recursionCount = recursionCount;
+        }
+
         internal void Reacquire(uint previousRecursionCount)
         {
             Acquire();
@@ -21,38 +21,38 @@ namespace System.Threading
     {
         #region Object->Lock mappings
 
-        private static ConditionalWeakTable<object, Lock> s_lockTable;
-        private static ConditionalWeakTable<object, Condition> s_conditionTable;
-
-        private static Lock GetLockFromTable(Object obj)
-        {
-            ConditionalWeakTable<object, Lock> table = LazyInitializer.EnsureInitialized(ref s_lockTable, () => new ConditionalWeakTable<object, Lock>());
-            return table.GetValue(obj, (o) => new Lock());
-        }
+        //
+        // Objects other than Lock are locked with a thin lock in their header (see ObjectHeader). They only get a
+        // Lock of their own once the thin lock isn't enough: on contention, Wait/Pulse, or when the object needs a
+        // hash code while it's locked.
+        //
 
         private static Lock GetLock(Object obj)
         {
-            if (obj == null)
-                throw new ArgumentNullException("obj");
-
             if (Lock.IsLock(obj))
                 return (Lock)obj;
 
-            return GetLockFromTable(obj);
-        }
-
-        private static Condition GetConditionFromTable(Object obj)
-        {
-            ConditionalWeakTable<object, Condition> table = LazyInitializer.EnsureInitialized(ref s_conditionTable, () => new ConditionalWeakTable<object, Condition>());
-            return table.GetValue(obj, (o) => new Condition(GetLock(o)));
+            return ObjectHeader.GetLockObject(obj);
         }
 
         private static Condition GetCondition(Object obj)
         {
+            if (obj == null)
+                throw new ArgumentNullException("obj");
+
             Debug.Assert(
                 !(obj is Condition || obj is Lock),
                 "Do not use Monitor.Pulse or Wait on a Lock or Condition instance; use the methods on Condition instead.");
-            return GetConditionFromTable(obj);
+            return ObjectHeader.GetCondition(obj);
+        }
+
+        [MethodImpl(MethodImplOptions.AggressiveInlining)]
+        private static bool TryAcquireThinLock(Object obj)
+        {
+            if (obj == null)
+                throw new ArgumentNullException("obj");
+
+            return !Lock.IsLock(obj) && ObjectHeader.TryAcquireThinLock(obj, Environment.CurrentManagedThreadId);
         }
         #endregion
 
@@ -60,6 +60,9 @@ namespace System.Threading
 
         public static void Enter(Object obj)
         {
+            if (TryAcquireThinLock(obj))
+                return;
+
             Lock lck = GetLock(obj);
             if (lck.TryAcquire(0))
                 return;
@@ -71,6 +74,12 @@ namespace System.Threading
             if (lockTaken)
                 throw new ArgumentException(SR.Argument_MustBeFalse, "lockTaken");
 
+            if (TryAcquireThinLock(obj))
+            {
+                lockTaken = true;
+                return;
+            }
+
             Lock lck = GetLock(obj);
             if (lck.TryAcquire(0))
             {
@@ -83,6 +92,9 @@ namespace System.Threading
 
         public static bool TryEnter(Object obj)
         {
+            if (TryAcquireThinLock(obj))
+                return true;
+
             return GetLock(obj).TryAcquire(0);
         }
 
@@ -91,7 +103,7 @@ namespace System.Threading
             if (lockTaken)
                 throw new ArgumentException(SR.Argument_MustBeFalse, "lockTaken");
 
-            lockTaken = GetLock(obj).TryAcquire(0);
+            lockTaken = TryEnter(obj);
         }
 
         public static bool TryEnter(Object obj, int millisecondsTimeout)
@@ -99,6 +111,9 @@ namespace System.Threading
             if (millisecondsTimeout < -1)
                 throw new ArgumentOutOfRangeException("millisecondsTimeout", SR.ArgumentOutOfRange_NeedNonNegOrNegative1);
 
+            if (TryAcquireThinLock(obj))
+                return true;
+
             Lock lck = GetLock(obj);
             if (lck.TryAcquire(0))
                 return true;
@@ -109,16 +124,8 @@ namespace System.Threading
         {
             if (lockTaken)
                 throw new ArgumentException(SR.Argument_MustBeFalse, "lockTaken");
-            if (millisecondsTimeout < -1)
-                throw new ArgumentOutOfRangeException("millisecondsTimeout", SR.ArgumentOutOfRange_NeedNonNegOrNegative1);
 
-            Lock lck = GetLock(obj);
-            if (lck.TryAcquire(0))
-            {
-                lockTaken = true;
-                return;
-            }
-            lockTaken = TryAcquireContended(lck, obj, millisecondsTimeout);
+            lockTaken = TryEnter(obj, millisecondsTimeout);
         }
 
         public static bool TryEnter(Object obj, TimeSpan timeout)
@@ -128,6 +135,9 @@ namespace System.Threading
                 throw new ArgumentOutOfRangeException("timeout", SR.ArgumentOutOfRange_NeedNonNegOrNegative1);
             int millisecondsTimeout = (int)tm;
 
+            if (TryAcquireThinLock(obj))
+                return true;
+
             Lock lck = GetLock(obj);
             if (lck.TryAcquire(0))
                 return true;
@@ -138,29 +148,44 @@ namespace System.Threading
         {
             if (lockTaken)
                 throw new ArgumentException(SR.Argument_MustBeFalse, "lockTaken");
-            long tm = (long)timeout.TotalMilliseconds;
-            if (tm < -1 || tm > (long)Int32.MaxValue)
-                throw new ArgumentOutOfRangeException("timeout", SR.ArgumentOutOfRange_NeedNonNegOrNegative1);
-            int millisecondsTimeout = (int)tm;
 
-            Lock lck = GetLock(obj);
-            if (lck.TryAcquire(0))
+            lockTaken = TryEnter(obj, timeout);
+        }
+
+        public static void Exit(Object obj)
+        {
+            if (obj == null)
+                throw new ArgumentNullException("obj");
+
+            if (Lock.IsLock(obj))
             {
-                lockTaken = true;
+                ((Lock)obj).Release();
                 return;
             }
 
-            lockTaken = TryAcquireContended(lck, obj, millisecondsTimeout);
-        }
+            if (ObjectHeader.TryReleaseThinLock(obj, Environment.CurrentManagedThreadId))
+                return;
 
-        public static void Exit(Object obj)
-        {
-            GetLock(obj).Release();
+            // Only an inflated object can be locked without a thin lock.
+            Lock lck = ObjectHeader.TryGetLockObject(obj);
+            if (lck == null)
+                throw new SynchronizationLockException();
+            lck.Release();
         }
 
         public static bool IsEntered(Object obj)
         {
-            return GetLock(obj).IsAcquired;
+            if (obj == null)
+                throw new ArgumentNullException("obj");
+
+            if (Lock.IsLock(obj))
+                return ((Lock)obj).IsAcquired;
+
+            if (ObjectHeader.IsThinLockHeld(obj, Environment.CurrentManagedThreadId))
+                return true;
+
+            Lock lck = ObjectHeader.TryGetLockObject(obj);
+            return (lck != null) && lck.IsAcquired;
         }
 
         #endregion
@@ -0,0 +1,270 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+using System.Diagnostics;
+using System.Runtime.CompilerServices;
+
+namespace System.Threading
+{
+    //
+    // Manipulates the header word in front of the EEType pointer of every object. Keep in sync with
+    // ObjectLayout.h. The layout of the 32-bit word is:
+    //
+    // bits 28-31: reserved for the runtime and the GC (BIT_SBLK_GC_RESERVE, BIT_SBLK_FINALIZER_RUN).
+    //
+    // bit 27:     set if bits 0-25 hold a hash code or a SyncTable index.
+    //
+    // bit 26:     if bit 27 is set, set for a hash code and clear for a SyncTable index.
+    //
+    // bits 0-25:  if bit 27 is clear, a thin lock: the managed ID of the owning thread in bits 0-15 (0 when the
+    //             lock isn't held) and the recursion count in bits 16-25.
+    //
+    // A hash code and a held thin lock don't both fit, so whichever comes second moves the object to a
+    // SyncTable entry ("inflates" it), as do contention, waiting, Pulse, recursion overflow and managed thread
+    // IDs that don't fit in 16 bits. Once inflated an object stays inflated.
+    //
+    // The runtime and GC only change their bits with interlocked operations or while managed code is
+    // suspended, and the GC moves the header along with the object when it compacts, so all the state here is
+    // updated with compare-exchange of the whole word.
+    //
+    internal static class ObjectHeader
+    {
+        private const int IS_HASH_OR_SYNCBLKINDEX = 0x08000000;
+        private const int IS_HASHCODE = 0x04000000;
+        private const int HASHCODE_BITS = 26;
+        private const int MASK_HASHCODE_INDEX = (1 << HASHCODE_BITS) - 1;
+
+        private const int MASK_LOCK_THREADID = 0x0000FFFF;
+        private const int MASK_LOCK_RECLEVEL = 0x03FF0000;
+        private const int SHIFT_LOCK_RECLEVEL = 16;
+        private const int LOCK_RECLEVEL_INC = 1 << SHIFT_LOCK_RECLEVEL;
+
+        // All the bits owned by the classlib
+        private const int MASK_HEADER_STATE = IS_HASH_OR_SYNCBLKINDEX | IS_HASHCODE | MASK_HASHCODE_INDEX;
+
+        [ThreadStatic]
+        private static int t_hashSeed;
+
+        private static int GetNewHashCode()
+        {
+            int multiplier = Environment.CurrentManagedThreadId * 4 + 5;
+            // Every thread has its own generator for hash codes so that we won't get into a situation
+            // where two threads consistently give out the same hash codes.
+            // Choice of multiplier guarantees period of 2**32 - see Knuth Vol 2 p16 (3.2.1.2 Theorem A).
+            t_hashSeed = t_hashSeed * multiplier + 1;
+            return t_hashSeed;
+        }
+
+        private static unsafe int* GetHeaderPtr(IntPtr* ppEEType)
+        {
+            // skipping exactly 4 bytes for the SyncTableEntry (exactly 4 bytes not a pointer size).
+            return (int*)((byte*)ppEEType - sizeof(int));
+        }
+
+        public static unsafe int GetHashCode(object o)
+        {
+            if (o == null)
+                return 0;
+
+            fixed (IntPtr* ppEEType = &o.m_pEEType)
+            {
+                int bits = *GetHeaderPtr(ppEEType);
+                if ((bits & (IS_HASH_OR_SYNCBLKINDEX | IS_HASHCODE)) == (IS_HASH_OR_SYNCBLKINDEX | IS_HASHCODE))
+                    return bits & MASK_HASHCODE_INDEX;
+            }
+
+            return AssignHashCode(o);
+        }
+
+        private static unsafe int AssignHashCode(object o)
+        {
+            int newHash = GetNewHashCode() & MASK_HASHCODE_INDEX;
+
+            // 0 means no hash code has been assigned.
+            if (newHash == 0)
+                newHash = 1;
+
+            fixed (IntPtr* ppEEType = &o.m_pEEType)
+            {
+                int* pHeader = GetHeaderPtr(ppEEType);
+
+                while (true)
+                {
+                    int oldBits = Volatile.Read(ref *pHeader);
+
+                    if ((oldBits & IS_HASH_OR_SYNCBLKINDEX) != 0)
+                    {
+                        if ((oldBits & IS_HASHCODE) != 0)
+                        {
+                            // Someone else set the hash code.
+                            return oldBits & MASK_HASHCODE_INDEX;
+                        }
+
+                        return SyncTable.GetHashCode(oldBits & MASK_HASHCODE_INDEX, newHash);
+                    }
+
+                    // The thin lock is held, so the hash code has to go in a SyncTable entry.
+                    if ((oldBits & MASK_HEADER_STATE) != 0)
+                        break;
+
+                    int newBits = oldBits | IS_HASH_OR_SYNCBLKINDEX | IS_HASHCODE | newHash;
+                    if (Interlocked.CompareExchange(ref *pHeader, newBits, oldBits) == oldBits)
+                        return newHash;
+
+                    // If we get here someone else modified the header.  They may have set the hash code, or maybe some
+                    // other bits.  Let's try again.
+                }
+            }
+
+            return SyncTable.GetHashCode(GetSyncIndex(o), newHash);
+        }
+
+        //
+        // Attempts to take the thin lock of an object that hasn't been inflated. Returns false if the lock is held by
+        // another thread or can't be represented in the header, in which case the caller should use GetLockObject.
+        //
+        [MethodImpl(MethodImplOptions.AggressiveInlining)]
+        public static unsafe bool TryAcquireThinLock(object obj, int currentThreadId)
+        {
+            Debug.Assert(currentThreadId != 0);
+
+            if ((currentThreadId & ~MASK_LOCK_THREADID) != 0)
+                return false;
+
+            fixed (IntPtr* ppEEType = &obj.m_pEEType)
+            {
+                int* pHeader = GetHeaderPtr(ppEEType);
+                int oldBits = *pHeader;
+
+                if ((oldBits & MASK_HEADER_STATE) == 0)
+                    return Interlocked.CompareExchange(ref *pHeader, oldBits | currentThreadId, oldBits) == oldBits;
+
+                if (((oldBits & (IS_HASH_OR_SYNCBLKINDEX | MASK_LOCK_THREADID)) == currentThreadId) &&
+                    ((oldBits & MASK_LOCK_RECLEVEL) != MASK_LOCK_RECLEVEL))
+                {
+                    return Interlocked.CompareExchange(ref *pHeader, oldBits + LOCK_RECLEVEL_INC, oldBits) == oldBits;
+                }
+            }
+
+            return false;
+        }
+
+        //
+        // Releases one level of the thin lock if the current thread holds it. Returns false if it doesn't, which
+        // includes the lock having been inflated.
+        //
+        [MethodImpl(MethodImplOptions.AggressiveInlining)]
+        public static unsafe bool TryReleaseThinLock(object obj, int currentThreadId)
+        {
+            fixed (IntPtr* ppEEType = &obj.m_pEEType)
+            {
+                int* pHeader = GetHeaderPtr(ppEEType);
+
+                while (true)
+                {
+                    int oldBits = Volatile.Read(ref *pHeader);
+
+                    if ((oldBits & (IS_HASH_OR_SYNCBLKINDEX | MASK_LOCK_THREADID)) != currentThreadId)
+                        return false;
+
+                    int newBits = ((oldBits & MASK_LOCK_RECLEVEL) != 0) ?
+                        oldBits - LOCK_RECLEVEL_INC :
+                        oldBits & ~MASK_LOCK_THREADID;
+
+                    // Only fails if another thread inflated the lock or the runtime changed its bits.
+                    if (Interlocked.CompareExchange(ref *pHeader, newBits, oldBits) == oldBits)
+                        return true;
+                }
+            }
+        }
+
+        //
+        // Returns true if the current thread holds the thin lock of the object.
+        //
+        public static unsafe bool IsThinLockHeld(object obj, int currentThreadId)
+        {
+            fixed (IntPtr* ppEEType = &obj.m_pEEType)
+            {
+                int bits = *GetHeaderPtr(ppEEType);
+                return (bits & (IS_HASH_OR_SYNCBLKINDEX | MASK_LOCK_THREADID)) == currentThreadId;
+            }
+        }
+
+        //
+        // Returns the Lock of the object, inflating it first if needed.
+        //
+        public static Lock GetLockObject(object obj)
+        {
+            return SyncTable.GetLockObject(GetSyncIndex(obj));
+        }
+
+        //
+        // Returns the Lock of the object if it's been inflated, null otherwise.
+        //
+        public static unsafe Lock TryGetLockObject(object obj)
+        {
+            fixed (IntPtr* ppEEType = &obj.m_pEEType)
+            {
+                int bits = Volatile.Read(ref *GetHeaderPtr(ppEEType));
+                if ((bits & (IS_HASH_OR_SYNCBLKINDEX | IS_HASHCODE)) != IS_HASH_OR_SYNCBLKINDEX)
+                    return null;
+
+                return SyncTable.GetLockObject(bits & MASK_HASHCODE_INDEX);
+            }
+        }
+
+        //
+        // Returns the Condition of the object, inflating it first if needed.
+        //
+        public static Condition GetCondition(object obj)
+        {
+            return SyncTable.GetCondition(GetSyncIndex(obj));
+        }
+
+        //
+        // Returns the SyncTable index of the object, moving the hash code or thin lock in the header into a new
+        // entry first if the object hasn't been inflated yet.
+        //
+        private static unsafe int GetSyncIndex(object obj)
+        {
+            fixed (IntPtr* ppEEType = &obj.m_pEEType)
+            {
+                int* pHeader = GetHeaderPtr(ppEEType);
+
+                int bits = Volatile.Read(ref *pHeader);
+                if ((bits & (IS_HASH_OR_SYNCBLKINDEX | IS_HASHCODE)) == IS_HASH_OR_SYNCBLKINDEX)
+                    return bits & MASK_HASHCODE_INDEX;
+
+                int index = SyncTable.AssignEntry(obj);
+                Debug.Assert((index & ~MASK_HASHCODE_INDEX) == 0);
+
+                while (true)
+                {
+                    int oldBits = Volatile.Read(ref *pHeader);
+
+                    if ((oldBits & (IS_HASH_OR_SYNCBLKINDEX | IS_HASHCODE)) == IS_HASH_OR_SYNCBLKINDEX)
+                    {
+                        // Another thread inflated the object first.
+                        SyncTable.FreeEntry(index);
+                        return oldBits & MASK_HASHCODE_INDEX;
+                    }
+
+                    if ((oldBits & IS_HASH_OR_SYNCBLKINDEX) != 0)
+                    {
+                        SyncTable.InitializeEntry(index, oldBits & MASK_HASHCODE_INDEX, 0, 0);
+                    }
+                    else
+                    {
+                        SyncTable.InitializeEntry(index, 0, oldBits & MASK_LOCK_THREADID,
+                            (uint)((oldBits & MASK_LOCK_RECLEVEL) >> SHIFT_LOCK_RECLEVEL));
+                    }
+
+                    // The entry isn't visible to other threads until this succeeds.
+                    int newBits = (oldBits & ~MASK_HEADER_STATE) | IS_HASH_OR_SYNCBLKINDEX | index;
+                    if (Interlocked.CompareExchange(ref *pHeader, newBits, oldBits) == oldBits)
+                        return index;
+                }
+            }
+        }
+    }
+}
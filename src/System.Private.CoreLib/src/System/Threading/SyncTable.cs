@@ -0,0 +1,220 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+using System.Diagnostics;
+using System.Runtime;
+using System.Runtime.CompilerServices;
+using System.Runtime.InteropServices;
+
+namespace System.Threading
+{
+    //
+    // Holds the state of objects whose header has been inflated (see ObjectHeader): the hash code, the Lock and the
+    // Condition used by Monitor. The header stores the index of the object's entry.
+    //
+    // Entries refer to their object through a long weak handle, so they don't keep it alive and are only reused
+    // once it can't be reached anymore, not even by a finalizer. Dead entries are collected when the table runs
+    // out of free entries, before growing it.
+    //
+    // Entries are never moved, and the array is only replaced by a bigger copy, so they can be read without
+    // taking the lock.
+    //
+    internal static class SyncTable
+    {
+        private sealed class Entry
+        {
+            public IntPtr OwnerHandle;
+            public Lock Lock;
+            public Condition Condition;
+            public int HashCode;
+            public int NextFreeIndex;
+        }
+
+        private const int InitialSize = 64;
+
+        // Largest index that fits in the header next to the flag bits
+        private const int MaxIndex = (1 << 26) - 1;
+
+        private static Lock s_lock;
+        private static volatile Entry[] s_entries;
+
+        // Index 0 is never used
+        [PreInitialized]
+        private static int s_nextUnusedIndex = 1;
+        private static int s_firstFreeIndex;
+
+        private static Lock TableLock
+        {
+            get
+            {
+                //
+                // Can't use LazyInitializer.EnsureInitialized for the same reasons Lock can't, and can't have a class
+                // constructor since Monitor must not depend on class construction.
+                //
+                if (s_lock == null)
+                    Interlocked.CompareExchange(ref s_lock, new Lock(), null);
+
+                return s_lock;
+            }
+        }
+
+        private static Entry GetEntry(int index)
+        {
+            Entry entry = s_entries[index];
+            Debug.Assert(entry != null && entry.OwnerHandle != IntPtr.Zero);
+            return entry;
+        }
+
+        //
+        // Returns an entry for obj. It isn't associated with the object until the object's header is changed to
+        // refer to it, the caller must either do that or call FreeEntry.
+        //
+        public static int AssignEntry(object obj)
+        {
+            IntPtr handle = RuntimeImports.RhHandleAlloc(obj, GCHandleType.WeakTrackResurrection);
+            if (handle == IntPtr.Zero)
+                throw new OutOfMemoryException();
+
+            Lock tableLock = TableLock;
+            tableLock.Acquire();
+            try
+            {
+                if (s_firstFreeIndex == 0)
+                {
+                    try
+                    {
+                        MakeFreeEntries();
+                    }
+                    catch
+                    {
+                        RuntimeImports.RhHandleFree(handle);
+                        throw;
+                    }
+                }
+
+                int index = s_firstFreeIndex;
+                Entry entry = s_entries[index];
+                s_firstFreeIndex = entry.NextFreeIndex;
+
+                entry.OwnerHandle = handle;
+                entry.NextFreeIndex = 0;
+                return index;
+            }
+            finally
+            {
+                tableLock.Release();
+            }
+        }
+
+        //
+        // Sets up an entry returned by AssignEntry with the state moved out of the object's header.
+        //
+        public static void InitializeEntry(int index, int hashCode, int ownerThreadId, uint recursionCount)
+        {
+            Entry entry = GetEntry(index);
+            entry.HashCode = hashCode;
+            entry.Lock.InitializeLocked(ownerThreadId, recursionCount);
+        }
+
+        public static void FreeEntry(int index)
+        {
+            Lock tableLock = TableLock;
+            tableLock.Acquire();
+            try
+            {
+                FreeEntryLocked(s_entries[index], index);
+            }
+            finally
+            {
+                tableLock.Release();
+            }
+        }
+
+        private static void FreeEntryLocked(Entry entry, int index)
+        {
+            RuntimeImports.RhHandleFree(entry.OwnerHandle);
+
+            // The Lock and Condition may still be referenced by a thread that was looking at a dead object, so
+            // give the next owner new ones.
+            entry.OwnerHandle = IntPtr.Zero;
+            entry.Lock = new Lock();
+            entry.Condition = null;
+            entry.HashCode = 0;
+            entry.NextFreeIndex = s_firstFreeIndex;
+            s_firstFreeIndex = index;
+        }
+
+        private static void MakeFreeEntries()
+        {
+            Entry[] entries = s_entries;
+
+            // Reclaim the entries of dead objects first.
+            if (entries != null)
+            {
+                int freed = 0;
+                for (int i = 1; i < s_nextUnusedIndex; i++)
+                {
+                    Entry entry = entries[i];
+                    if (entry.OwnerHandle != IntPtr.Zero && RuntimeImports.RhHandleGet(entry.OwnerHandle) == null)
+                    {
+                        FreeEntryLocked(entry, i);
+                        freed++;
+                    }
+                }
+
+                // Grow anyway if only a few were freed so the table isn't scanned on every assignment.
+                if (freed > (s_nextUnusedIndex / 8))
+                    return;
+            }
+
+            Debug.Assert(entries == null || s_nextUnusedIndex == entries.Length);
+
+            int newSize = (entries == null) ? InitialSize : Math.Min(entries.Length * 2, MaxIndex + 1);
+            if (entries != null && newSize == entries.Length)
+            {
+                // The header can't refer to more entries, make do with whatever was reclaimed.
+                if (s_firstFreeIndex == 0)
+                    throw new OutOfMemoryException();
+                return;
+            }
+
+            Entry[] newEntries = new Entry[newSize];
+            if (entries != null)
+                Array.Copy(entries, newEntries, entries.Length);
+            s_entries = newEntries;
+            entries = newEntries;
+
+            // Add the rest of the unused part of the table to the free list.
+            for (int i = entries.Length - 1; i >= s_nextUnusedIndex; i--)
+            {
+                Entry entry = new Entry();
+                entry.Lock = new Lock();
+                entry.NextFreeIndex = s_firstFreeIndex;
+                entries[i] = entry;
+                s_firstFreeIndex = i;
+            }
+            s_nextUnusedIndex = entries.Length;
+        }
+
+        public static int GetHashCode(int index, int newHashCode)
+        {
+            Entry entry = GetEntry(index);
+            int hashCode = Interlocked.CompareExchange(ref entry.HashCode, newHashCode, 0);
+            return (hashCode != 0) ? hashCode : newHashCode;
+        }
+
+        public static Lock GetLockObject(int index)
+        {
+            return GetEntry(index).Lock;
+        }
+
+        public static Condition GetCondition(int index)
+        {
+            Entry entry = GetEntry(index);
+            if (entry.Condition == null)
+                Interlocked.CompareExchange(ref entry.Condition, new Condition(entry.Lock), null);
+
+            return entry.Condition;
+        }
+    }
+}
@@ -291,16 +291,20 @@ namespace System.Threading
 
         #region T
 
+        [Intrinsic]
         public static T Read<T>(ref T location) where T : class
         {
-            //@TODO: need intrinsic implementation of Volatile.Read<T>, or some way to take the address of a reference.
-            return Interlocked.CompareExchange(ref location, null, null);
+            // This method is implemented elsewhere in the toolchain for now
+            // Replace with regular implementation once ref locals are available in C# (https://github.com/dotnet/roslyn/issues/118)
+            throw new PlatformNotSupportedException();
         }
 
+        [Intrinsic]
         public static void Write<T>(ref T location, T value) where T : class
         {
-            //@TODO: need intrinsic implementation of Volatile.Write<T>, or some way to take the address of a reference.
-            Interlocked.Exchange(ref location, value);
+            // This method is implemented elsewhere in the toolchain for now
+            // Replace with regular implementation once ref locals are available in C# (https://github.com/dotnet/roslyn/issues/118)
+            throw new PlatformNotSupportedException();
         }
         #endregion
     }
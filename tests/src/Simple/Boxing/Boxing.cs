@@ -0,0 +1,146 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+//
+
+
+using System;
+
+// Round-trips 1, 2, 4 and 8 byte primitives, enums of each underlying size and structs that don't fit the
+// fixed size box helpers (a padded one and a 3 byte one) through the runtime's boxing paths: Array.GetValue,
+// Array.SetValue, Array.Copy between value type and object arrays and Enum.ToObject. Then prints how long
+// boxing and unboxing an element takes through Array.Copy.
+public class BringUpTest
+{
+    const int Pass = 100;
+    const int Fail = -1;
+
+    enum ByteEnum : byte { A = 1, B = 0xFE }
+    enum ShortEnum : short { A = -2, B = 0x1234 }
+    enum IntEnum { A = -3, B = 0x12345678 }
+    enum LongEnum : long { A = -4, B = 0x123456789ABCDEF }
+
+    struct Padded
+    {
+        public long L;
+        public byte B;
+
+        public Padded(long l, byte b) { L = l; B = b; }
+        public override bool Equals(object o) { return o is Padded && ((Padded)o).L == L && ((Padded)o).B == B; }
+        public override int GetHashCode() { return (int)L ^ B; }
+    }
+
+    struct ThreeBytes
+    {
+        public byte X, Y, Z;
+
+        public ThreeBytes(byte x, byte y, byte z) { X = x; Y = y; Z = z; }
+        public override bool Equals(object o) { return o is ThreeBytes && ((ThreeBytes)o).X == X && ((ThreeBytes)o).Y == Y && ((ThreeBytes)o).Z == Z; }
+        public override int GetHashCode() { return X | (Y << 8) | (Z << 16); }
+    }
+
+    static bool RoundTrip<T>(T[] values)
+    {
+        // Box each element through GetValue, then unbox into a new array through SetValue
+        T[] copy = new T[values.Length];
+        for (int i = 0; i < values.Length; i++)
+        {
+            object boxed = values.GetValue(i);
+            if (boxed.GetType() != typeof(T) || !boxed.Equals(values[i]))
+            {
+                Console.WriteLine(typeof(T) + ": GetValue(" + i + ") returned " + boxed);
+                return false;
+            }
+            copy.SetValue(boxed, i);
+        }
+
+        // And the same through Array.Copy in both directions
+        object[] objects = new object[values.Length];
+        Array.Copy(values, objects, values.Length);
+        T[] back = new T[values.Length];
+        Array.Copy(objects, back, values.Length);
+
+        for (int i = 0; i < values.Length; i++)
+        {
+            if (!copy[i].Equals(values[i]) || !objects[i].Equals(values[i]) || !back[i].Equals(values[i]))
+            {
+                Console.WriteLine(typeof(T) + ": element " + i + " didn't survive the round trip");
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    static bool TestEnumToObject()
+    {
+        if ((ByteEnum)Enum.ToObject(typeof(ByteEnum), 0xFE) != ByteEnum.B)
+            return false;
+        if ((ShortEnum)Enum.ToObject(typeof(ShortEnum), -2) != ShortEnum.A)
+            return false;
+        if ((IntEnum)Enum.ToObject(typeof(IntEnum), 0x12345678) != IntEnum.B)
+            return false;
+        if ((LongEnum)Enum.ToObject(typeof(LongEnum), 0x123456789ABCDEF) != LongEnum.B)
+            return false;
+        return true;
+    }
+
+    static bool TestRoundTrips()
+    {
+        return RoundTrip(new bool[] { true, false, true })
+            && RoundTrip(new byte[] { 0, 1, 0x7F, 0xFF })
+            && RoundTrip(new sbyte[] { -128, -1, 0, 127 })
+            && RoundTrip(new char[] { 'a', '\0', '\uffff' })
+            && RoundTrip(new short[] { short.MinValue, -1, 0x1234, short.MaxValue })
+            && RoundTrip(new ushort[] { 0, 0x8001, ushort.MaxValue })
+            && RoundTrip(new int[] { int.MinValue, -1, 0, 0x12345678, int.MaxValue })
+            && RoundTrip(new uint[] { 0, 0x80000001, uint.MaxValue })
+            && RoundTrip(new float[] { -1.5f, 0.0f, 3.25e10f })
+            && RoundTrip(new long[] { long.MinValue, -1, 0x123456789ABCDEF, long.MaxValue })
+            && RoundTrip(new ulong[] { 0, 0x8000000000000001, ulong.MaxValue })
+            && RoundTrip(new double[] { -1.5, 0.0, 6.02e23 })
+            && RoundTrip(new ByteEnum[] { ByteEnum.A, ByteEnum.B })
+            && RoundTrip(new ShortEnum[] { ShortEnum.A, ShortEnum.B })
+            && RoundTrip(new IntEnum[] { IntEnum.A, IntEnum.B })
+            && RoundTrip(new LongEnum[] { LongEnum.A, LongEnum.B })
+            && RoundTrip(new Padded[] { new Padded(-1, 0xAB), new Padded(0x123456789ABCDEF, 1) })
+            && RoundTrip(new ThreeBytes[] { new ThreeBytes(1, 2, 3), new ThreeBytes(0xFF, 0, 0x80) });
+    }
+
+    static void PrintTimings()
+    {
+        const int Length = 1024 * 1024;
+        const int Iterations = 20;
+
+        int[] ints = new int[Length];
+        for (int i = 0; i < Length; i++)
+            ints[i] = i;
+        object[] objects = new object[Length];
+
+        int start = Environment.TickCount;
+        for (int i = 0; i < Iterations; i++)
+            Array.Copy(ints, objects, Length);
+        int boxElapsed = Environment.TickCount - start;
+
+        start = Environment.TickCount;
+        for (int i = 0; i < Iterations; i++)
+            Array.Copy(objects, ints, Length);
+        int unboxElapsed = Environment.TickCount - start;
+
+        long elements = (long)Length * Iterations;
+        Console.WriteLine("Box:   " + (boxElapsed * 1000000L / elements) + " ns/element");
+        Console.WriteLine("Unbox: " + (unboxElapsed * 1000000L / elements) + " ns/element");
+    }
+
+    public static int Main()
+    {
+        if (!TestRoundTrips())
+            return Fail;
+
+        if (!TestEnumToObject())
+            return Fail;
+
+        PrintTimings();
+
+        return Pass;
+    }
+}
@@ -0,0 +1,221 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+//
+
+
+using System;
+using System.Runtime.CompilerServices;
+using System.Threading;
+
+// Checks that the GC finds every kind of root the code keeps references in, and updates them if it moves the
+// objects: locals and arguments, value types holding references, byrefs into the middle of an array, statics of
+// value types holding references, and thread statics, which each thread has its own copy of.
+public class BringUpTest
+{
+    const int Pass = 100;
+    const int Fail = -1;
+
+    const int Collections = 5;
+
+    // Enough garbage in between the live objects for a compacting collection to move them
+    const int GarbagePerObject = 100;
+
+    const int TimeoutMilliseconds = 10000;
+
+    struct Holder
+    {
+        public int Tag;
+        public string Text;
+        public int[] Numbers;
+    }
+
+    static Holder s_holder;
+
+    [ThreadStatic]
+    static string t_text;
+
+    static ManualResetEvent s_finalizerDone = new ManualResetEvent(false);
+    static bool s_finalizerSawOwnCopy;
+
+    class ThreadStaticChecker
+    {
+        ~ThreadStaticChecker()
+        {
+            s_finalizerSawOwnCopy = (t_text == null);
+            t_text = MakeText(7);
+            Churn();
+            s_finalizerSawOwnCopy &= (t_text == MakeText(7));
+            s_finalizerDone.Set();
+        }
+    }
+
+    [MethodImpl(MethodImplOptions.NoInlining)]
+    static string MakeText(int n)
+    {
+        return "text" + n.ToString();
+    }
+
+    [MethodImpl(MethodImplOptions.NoInlining)]
+    static int[] MakeNumbers(int length)
+    {
+        int[] numbers = new int[length];
+        for (int i = 0; i < length; i++)
+        {
+            numbers[i] = i;
+            for (int j = 0; j < GarbagePerObject; j++)
+                new object();
+        }
+        return numbers;
+    }
+
+    [MethodImpl(MethodImplOptions.NoInlining)]
+    static void Churn()
+    {
+        for (int i = 0; i < Collections; i++)
+        {
+            for (int j = 0; j < GarbagePerObject; j++)
+                new int[j];
+            GC.Collect();
+        }
+    }
+
+    static bool CheckNumbers(int[] numbers, int length)
+    {
+        if (numbers.Length != length)
+            return false;
+        for (int i = 0; i < length; i++)
+        {
+            if (numbers[i] != i)
+                return false;
+        }
+        return true;
+    }
+
+    [MethodImpl(MethodImplOptions.NoInlining)]
+    static void CollectAndIncrement(ref int element)
+    {
+        Churn();
+        element++;
+    }
+
+    [MethodImpl(MethodImplOptions.NoInlining)]
+    static bool TestLocals(string argument)
+    {
+        string text = MakeText(1);
+        int[] numbers = MakeNumbers(10);
+        Holder holder = new Holder() { Tag = 3, Text = MakeText(3), Numbers = MakeNumbers(20) };
+
+        Churn();
+
+        if (argument != MakeText(0) || text != MakeText(1))
+        {
+            Console.WriteLine("Strings in locals or arguments didn't survive");
+            return false;
+        }
+
+        if (!CheckNumbers(numbers, 10))
+        {
+            Console.WriteLine("Array in a local didn't survive");
+            return false;
+        }
+
+        if (holder.Tag != 3 || holder.Text != MakeText(3) || !CheckNumbers(holder.Numbers, 20))
+        {
+            Console.WriteLine("References in a struct local didn't survive");
+            return false;
+        }
+
+        return true;
+    }
+
+    static bool TestByRef()
+    {
+        int[] numbers = MakeNumbers(30);
+
+        CollectAndIncrement(ref numbers[15]);
+
+        if (numbers[15] != 16)
+        {
+            Console.WriteLine("Store through a byref into an array went astray");
+            return false;
+        }
+
+        numbers[15] = 15;
+        if (!CheckNumbers(numbers, 30))
+        {
+            Console.WriteLine("Array behind a byref didn't survive");
+            return false;
+        }
+
+        return true;
+    }
+
+    static bool TestStatics()
+    {
+        s_holder.Tag = 4;
+        s_holder.Text = MakeText(4);
+        s_holder.Numbers = MakeNumbers(40);
+
+        Churn();
+
+        if (s_holder.Tag != 4 || s_holder.Text != MakeText(4) || !CheckNumbers(s_holder.Numbers, 40))
+        {
+            Console.WriteLine("References in a struct static didn't survive");
+            return false;
+        }
+
+        return true;
+    }
+
+    [MethodImpl(MethodImplOptions.NoInlining)]
+    static void StartThreadStaticChecker()
+    {
+        new ThreadStaticChecker();
+    }
+
+    static bool TestThreadStatics()
+    {
+        t_text = MakeText(5);
+
+        StartThreadStaticChecker();
+        GC.Collect();
+        if (!s_finalizerDone.WaitOne(TimeoutMilliseconds))
+        {
+            Console.WriteLine("Finalizer didn't run");
+            return false;
+        }
+
+        if (!s_finalizerSawOwnCopy)
+        {
+            Console.WriteLine("Another thread didn't get its own copy of a thread static");
+            return false;
+        }
+
+        Churn();
+
+        if (t_text != MakeText(5))
+        {
+            Console.WriteLine("Thread static didn't survive");
+            return false;
+        }
+
+        return true;
+    }
+
+    public static int Main()
+    {
+        if (!TestLocals(MakeText(0)))
+            return Fail;
+
+        if (!TestByRef())
+            return Fail;
+
+        if (!TestStatics())
+            return Fail;
+
+        if (!TestThreadStatics())
+            return Fail;
+
+        return Pass;
+    }
+}
@@ -0,0 +1,177 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+//
+
+
+using System;
+using System.Runtime.CompilerServices;
+
+// Times casts and calls on instances of generic types created at runtime with MakeGenericType, which are the
+// types the runtime lays out itself instead of getting them from the compiler: casts to a generic interface,
+// interface dispatch and virtual dispatch. The timings are printed; the test only fails if a result is wrong.
+public class BringUpTest
+{
+    const int Pass = 100;
+    const int Fail = -1;
+
+    const int ObjectCount = 1024;
+    const int Iterations = 5000;
+
+    class A { }
+    class B { }
+    class C { }
+    class D { }
+
+    interface ITagged
+    {
+        int Tag();
+    }
+
+    interface IValue<T>
+    {
+        int Value();
+    }
+
+    abstract class Node
+    {
+        public abstract int Weight();
+    }
+
+    class Box<T> : Node, ITagged, IValue<T>
+    {
+        public override int Weight() { return 1; }
+        public virtual int Tag() { return 1; }
+        public int Value() { return 10; }
+    }
+
+    class DerivedBox<T> : Box<T>
+    {
+        public override int Weight() { return 2; }
+        public override int Tag() { return 2; }
+    }
+
+    static Type[] s_typeArguments = new Type[] { typeof(A), typeof(B), typeof(C), typeof(D) };
+    static Type[] s_genericTypes = new Type[] { typeof(Box<>), typeof(DerivedBox<>) };
+
+    // Instantiates each generic type over each type argument, and fills the objects with instances of them in turn
+    static bool CreateObjects(object[] objects)
+    {
+        Type[] types = new Type[s_genericTypes.Length * s_typeArguments.Length];
+        for (int i = 0; i < s_genericTypes.Length; i++)
+        {
+            for (int j = 0; j < s_typeArguments.Length; j++)
+                types[i * s_typeArguments.Length + j] = s_genericTypes[i].MakeGenericType(s_typeArguments[j]);
+        }
+
+        for (int i = 0; i < objects.Length; i++)
+        {
+            Type type = types[i % types.Length];
+            objects[i] = Activator.CreateInstance(type);
+            if (objects[i].GetType() != type)
+            {
+                Console.WriteLine("Instance of " + type + " has type " + objects[i].GetType());
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    [MethodImpl(MethodImplOptions.NoInlining)]
+    static int CountCasts<T>(object[] objects)
+    {
+        int count = 0;
+        for (int i = 0; i < Iterations; i++)
+        {
+            for (int j = 0; j < objects.Length; j++)
+            {
+                if (objects[j] is IValue<T>)
+                    count++;
+            }
+        }
+        return count;
+    }
+
+    [MethodImpl(MethodImplOptions.NoInlining)]
+    static int SumGenericInterfaceCalls<T>(object[] objects)
+    {
+        int sum = 0;
+        for (int i = 0; i < Iterations; i++)
+        {
+            for (int j = 0; j < objects.Length; j++)
+            {
+                IValue<T> value = objects[j] as IValue<T>;
+                if (value != null)
+                    sum += value.Value();
+            }
+        }
+        return sum;
+    }
+
+    [MethodImpl(MethodImplOptions.NoInlining)]
+    static int SumInterfaceCalls(object[] objects)
+    {
+        int sum = 0;
+        for (int i = 0; i < Iterations; i++)
+        {
+            for (int j = 0; j < objects.Length; j++)
+                sum += ((ITagged)objects[j]).Tag();
+        }
+        return sum;
+    }
+
+    [MethodImpl(MethodImplOptions.NoInlining)]
+    static int SumVirtualCalls(object[] objects)
+    {
+        int sum = 0;
+        for (int i = 0; i < Iterations; i++)
+        {
+            for (int j = 0; j < objects.Length; j++)
+                sum += ((Node)objects[j]).Weight();
+        }
+        return sum;
+    }
+
+    static bool Check(string name, int result, int expected, int startTicks)
+    {
+        int elapsed = Environment.TickCount - startTicks;
+
+        if (result != expected)
+        {
+            Console.WriteLine(name + ": got " + result + ", expected " + expected);
+            return false;
+        }
+
+        Console.WriteLine(name + ": " + elapsed + " ms");
+        return true;
+    }
+
+    public static int Main()
+    {
+        object[] objects = new object[ObjectCount];
+        if (!CreateObjects(objects))
+            return Fail;
+
+        // Every type argument gets the same number of Box and DerivedBox instances
+        int perTypeArgument = ObjectCount / s_typeArguments.Length;
+        int calls = ObjectCount * Iterations;
+
+        int start = Environment.TickCount;
+        if (!Check("Casts to IValue<A>", CountCasts<A>(objects), perTypeArgument * Iterations, start))
+            return Fail;
+
+        start = Environment.TickCount;
+        if (!Check("Calls through IValue<B>", SumGenericInterfaceCalls<B>(objects), perTypeArgument * Iterations * 10, start))
+            return Fail;
+
+        start = Environment.TickCount;
+        if (!Check("Calls through ITagged", SumInterfaceCalls(objects), calls / 2 * 1 + calls / 2 * 2, start))
+            return Fail;
+
+        start = Environment.TickCount;
+        if (!Check("Virtual calls", SumVirtualCalls(objects), calls / 2 * 1 + calls / 2 * 2, start))
+            return Fail;
+
+        return Pass;
+    }
+}
@@ -0,0 +1,189 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+//
+
+
+using System;
+
+// Calls interface methods on classes, on a class that inherits its implementation and on boxed structs, whose
+// methods expect the unboxed value as this, also from a single call site that sees the types in turn. Then makes
+// virtual calls whose likely target is guessed from the static type, both on an object of exactly that type and
+// on a derived one that overrides the method, and calls on objects whose type depends on the branch they come
+// from, which mustn't be devirtualized.
+public class BringUpTest
+{
+    const int Pass = 100;
+    const int Fail = -1;
+
+    interface IValue
+    {
+        int GetValue();
+        int Add(int x, long y);
+        void Increment();
+    }
+
+    class Holder : IValue
+    {
+        public int Value;
+
+        public Holder(int value) { Value = value; }
+        public int GetValue() { return Value; }
+        public int Add(int x, long y) { return Value + x + (int)y; }
+        public void Increment() { Value++; }
+    }
+
+    class DerivedHolder : Holder
+    {
+        public DerivedHolder(int value) : base(value) { }
+    }
+
+    struct StructHolder : IValue
+    {
+        public long Padding;
+        public int Value;
+
+        public StructHolder(int value) { Padding = -1; Value = value; }
+        public int GetValue() { return Value; }
+        public int Add(int x, long y) { return Value + x + (int)y; }
+        public void Increment() { Value++; }
+    }
+
+    class Shape
+    {
+        public virtual int Sides() { return 0; }
+    }
+
+    class Square : Shape
+    {
+        public override int Sides() { return 4; }
+    }
+
+    class Triangle : Square
+    {
+        public override int Sides() { return 3; }
+    }
+
+    sealed class Circle : Shape
+    {
+        public override int Sides() { return 1; }
+    }
+
+    static bool Check(IValue value, int expected, string what)
+    {
+        if (value.GetValue() != expected || value.Add(10, 100) != expected + 110)
+        {
+            Console.WriteLine(what + ": interface call returned " + value.GetValue());
+            return false;
+        }
+
+        // The increment has to change the value in the box, not a copy of it
+        value.Increment();
+        if (value.GetValue() != expected + 1)
+        {
+            Console.WriteLine(what + ": interface call didn't update the object");
+            return false;
+        }
+
+        return true;
+    }
+
+    static bool TestInterfaceCalls()
+    {
+        if (!Check(new Holder(1), 1, "Holder"))
+            return false;
+
+        if (!Check(new DerivedHolder(2), 2, "DerivedHolder"))
+            return false;
+
+        IValue boxed = new StructHolder(3);
+        if (!Check(boxed, 3, "StructHolder"))
+            return false;
+
+        if (((StructHolder)boxed).Padding != -1)
+        {
+            Console.WriteLine("StructHolder: interface call overwrote the box");
+            return false;
+        }
+
+        return true;
+    }
+
+    static bool TestMixedInterfaceCalls()
+    {
+        IValue[] values = new IValue[] { new Holder(1), new StructHolder(2), new DerivedHolder(3), new Holder(4), new StructHolder(5) };
+
+        // One call site, so its dispatch cell has to notice every time the type changes
+        for (int round = 0; round < 3; round++)
+        {
+            for (int i = 0; i < values.Length; i++)
+            {
+                if (values[i].GetValue() != i + 1)
+                {
+                    Console.WriteLine("Interface call from a shared call site went to the wrong method");
+                    return false;
+                }
+            }
+        }
+
+        return true;
+    }
+
+    static int CallSides(Square square)
+    {
+        // The static type isn't sealed, so this guesses Square::Sides and checks the type of the object
+        return square.Sides();
+    }
+
+    static bool TestGuardedDevirtualization()
+    {
+        if (CallSides(new Square()) != 4 || CallSides(new Triangle()) != 3)
+        {
+            Console.WriteLine("Guarded virtual call went to the wrong method");
+            return false;
+        }
+
+        Shape shape = new Triangle();
+        return shape.Sides() == 3;
+    }
+
+    // The object comes out of the conditional through a spill slot, which takes its type from whichever branch is
+    // imported first. Either order has to end in a virtual call.
+    static int SidesOfCircleOrSquare(bool circle)
+    {
+        return (circle ? (Shape)new Circle() : new Square()).Sides();
+    }
+
+    static int SidesOfSquareOrCircle(bool square)
+    {
+        return (square ? (Shape)new Square() : new Circle()).Sides();
+    }
+
+    static bool TestMergedTypes()
+    {
+        if (SidesOfCircleOrSquare(true) != 1 || SidesOfCircleOrSquare(false) != 4 ||
+            SidesOfSquareOrCircle(true) != 4 || SidesOfSquareOrCircle(false) != 1)
+        {
+            Console.WriteLine("Virtual call on an object from a merge point went to the wrong method");
+            return false;
+        }
+
+        return true;
+    }
+
+    public static int Main()
+    {
+        if (!TestInterfaceCalls())
+            return Fail;
+
+        if (!TestMixedInterfaceCalls())
+            return Fail;
+
+        if (!TestGuardedDevirtualization())
+            return Fail;
+
+        if (!TestMergedTypes())
+            return Fail;
+
+        return Pass;
+    }
+}
@@ -0,0 +1,164 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+//
+
+
+using System;
+using System.Runtime.CompilerServices;
+using System.Threading;
+
+// Contends on a Lock for long enough that the waiter stops spinning and blocks on the lock's state word, then
+// checks that releasing the lock wakes it up. There's no way to start a thread here, so the finalizer thread
+// plays the other side: once as the waiter while Main holds the lock, once as the holder while Main waits.
+// Then Main releases and immediately retakes the lock over and over while the finalizer waits, so that some
+// releases land between the waiter counting itself and going to sleep. A lost wake-up shows up as a timeout
+// instead of a hang.
+public class BringUpTest
+{
+    const int Pass = 100;
+    const int Fail = -1;
+
+    const int Rounds = 10;
+
+    // Well past what a contended acquire spins before it blocks
+    const int HoldMilliseconds = 100;
+
+    const int TimeoutMilliseconds = 10000;
+
+    // How long Main keeps releasing and retaking the lock in front of the waiter
+    const int BargeMilliseconds = 200;
+
+    static object s_lock = new object();
+    static ManualResetEvent s_acquired = new ManualResetEvent(false);
+    static ManualResetEvent s_held = new ManualResetEvent(false);
+    static bool s_finalizerHolds;
+
+    class Contender
+    {
+        ~Contender()
+        {
+            if (s_finalizerHolds)
+            {
+                lock (s_lock)
+                {
+                    s_held.Set();
+                    Hold(HoldMilliseconds);
+                }
+            }
+            else
+            {
+                lock (s_lock)
+                {
+                    s_acquired.Set();
+                }
+            }
+        }
+    }
+
+    static void Hold(int milliseconds)
+    {
+        int start = Environment.TickCount;
+        while (Environment.TickCount - start < milliseconds)
+        {
+        }
+    }
+
+    [MethodImpl(MethodImplOptions.NoInlining)]
+    static void StartContender()
+    {
+        new Contender();
+        GC.Collect();
+    }
+
+    static bool TestFinalizerWaits()
+    {
+        s_finalizerHolds = false;
+        s_acquired.Reset();
+
+        Monitor.Enter(s_lock);
+        StartContender();
+        Hold(HoldMilliseconds);
+        Monitor.Exit(s_lock);
+
+        if (!s_acquired.WaitOne(TimeoutMilliseconds))
+        {
+            Console.WriteLine("Releasing the lock didn't wake the finalizer thread");
+            return false;
+        }
+
+        return true;
+    }
+
+    static bool TestMainWaits()
+    {
+        s_finalizerHolds = true;
+        s_held.Reset();
+
+        StartContender();
+        if (!s_held.WaitOne(TimeoutMilliseconds))
+        {
+            Console.WriteLine("Finalizer didn't run");
+            return false;
+        }
+
+        if (!Monitor.TryEnter(s_lock, TimeoutMilliseconds))
+        {
+            Console.WriteLine("Releasing the lock didn't wake the main thread");
+            return false;
+        }
+        Monitor.Exit(s_lock);
+
+        GC.WaitForPendingFinalizers();
+        return true;
+    }
+
+    static bool TestReleaseRacesWaiter()
+    {
+        s_finalizerHolds = false;
+        s_acquired.Reset();
+
+        Monitor.Enter(s_lock);
+        StartContender();
+
+        // Each release wakes the waiter (if it's asleep yet) and each Enter takes the lock back before the waiter
+        // gets to it. The waiter has to notice that it was woken and not sleep through the final release.
+        int start = Environment.TickCount;
+        while (Environment.TickCount - start < BargeMilliseconds && !s_acquired.WaitOne(0))
+        {
+            Monitor.Exit(s_lock);
+            Monitor.Enter(s_lock);
+        }
+
+        Hold(HoldMilliseconds);
+        Monitor.Exit(s_lock);
+
+        if (!s_acquired.WaitOne(TimeoutMilliseconds))
+        {
+            Console.WriteLine("A release that raced with the waiter going to sleep got lost");
+            return false;
+        }
+
+        GC.WaitForPendingFinalizers();
+        return true;
+    }
+
+    public static int Main()
+    {
+        // An object with a hash code gets a Lock of its own as soon as it's locked, rather than a thin lock
+        s_lock.GetHashCode();
+
+        for (int i = 0; i < Rounds; i++)
+        {
+            if (!TestFinalizerWaits())
+                return Fail;
+
+            if (!TestMainWaits())
+                return Fail;
+
+            if (!TestReleaseRacesWaiter())
+                return Fail;
+        }
+
+        return Pass;
+    }
+}
@@ -0,0 +1,143 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+//
+
+
+using System;
+
+// Checks Buffer.BlockCopy (Buffer.Memmove) against a byte-by-byte copy for all the size classes the runtime
+// dispatches on, unaligned offsets and overlapping ranges in both directions, then prints the throughput.
+public class BringUpTest
+{
+    const int Pass = 100;
+    const int Fail = -1;
+
+    static readonly int[] s_lengths =
+    {
+        0, 1, 2, 3, 7, 8, 15, 16, 17, 31, 32, 33, 63, 64, 65, 199, 200, 201, 255, 256, 257,
+        2047, 2048, 2049, 4095, 4097, 65535, 65536, 65537, 1024 * 1024 + 3, 17 * 1024 * 1024 + 5
+    };
+
+    static void Fill(byte[] buffer)
+    {
+        for (int i = 0; i < buffer.Length; i++)
+            buffer[i] = (byte)(i * 7 + (i >> 8));
+    }
+
+    static void ReferenceCopy(byte[] src, int srcOffset, byte[] dst, int dstOffset, int count)
+    {
+        if (src == dst && srcOffset < dstOffset)
+        {
+            for (int i = count - 1; i >= 0; i--)
+                dst[dstOffset + i] = src[srcOffset + i];
+        }
+        else
+        {
+            for (int i = 0; i < count; i++)
+                dst[dstOffset + i] = src[srcOffset + i];
+        }
+    }
+
+    static bool Same(byte[] a, byte[] b)
+    {
+        for (int i = 0; i < a.Length; i++)
+        {
+            if (a[i] != b[i])
+                return false;
+        }
+        return true;
+    }
+
+    static bool TestCopy(int length, int srcOffset, int dstOffset)
+    {
+        int size = length + 128;
+        byte[] src = new byte[size];
+        byte[] dst = new byte[size];
+        byte[] expected = new byte[size];
+        Fill(src);
+
+        Buffer.BlockCopy(src, srcOffset, dst, dstOffset, length);
+        ReferenceCopy(src, srcOffset, expected, dstOffset, length);
+        if (!Same(dst, expected))
+        {
+            Console.WriteLine("Copy of " + length + " bytes from offset " + srcOffset + " to " + dstOffset + " failed");
+            return false;
+        }
+
+        return true;
+    }
+
+    static bool TestOverlap(int length, int srcOffset, int dstOffset)
+    {
+        int size = length + 128;
+        byte[] buffer = new byte[size];
+        byte[] expected = new byte[size];
+        Fill(buffer);
+        Fill(expected);
+
+        Buffer.BlockCopy(buffer, srcOffset, buffer, dstOffset, length);
+        ReferenceCopy(expected, srcOffset, expected, dstOffset, length);
+        if (!Same(buffer, expected))
+        {
+            Console.WriteLine("Overlapping copy of " + length + " bytes from offset " + srcOffset + " to " + dstOffset + " failed");
+            return false;
+        }
+
+        return true;
+    }
+
+    static bool TestCorrectness()
+    {
+        foreach (int length in s_lengths)
+        {
+            // Fewer combinations for the large sizes, they take a while
+            int step = (length > 65536) ? 31 : 1;
+
+            for (int srcOffset = 0; srcOffset < 64; srcOffset += step)
+            {
+                for (int dstOffset = 0; dstOffset < 64; dstOffset += (length > 256) ? 13 : 1)
+                {
+                    if (!TestCopy(length, srcOffset, dstOffset))
+                        return false;
+
+                    if (!TestOverlap(length, srcOffset, dstOffset))
+                        return false;
+                }
+            }
+        }
+
+        return true;
+    }
+
+    static void PrintThroughput()
+    {
+        const long bytesPerSize = 256L * 1024 * 1024;
+
+        byte[] src = new byte[16 * 1024 * 1024];
+        byte[] dst = new byte[16 * 1024 * 1024];
+
+        Console.WriteLine("Size (bytes)    MB/s");
+        for (int length = 16; length <= src.Length; length *= 4)
+        {
+            long iterations = bytesPerSize / length;
+
+            int start = Environment.TickCount;
+            for (long i = 0; i < iterations; i++)
+                Buffer.BlockCopy(src, 0, dst, 0, length);
+            int elapsed = Environment.TickCount - start;
+
+            long megabytesPerSecond = (elapsed > 0) ? (bytesPerSize / (1024 * 1024)) * 1000 / elapsed : 0;
+            Console.WriteLine(length.ToString().PadLeft(12) + megabytesPerSecond.ToString().PadLeft(8));
+        }
+    }
+
+    public static int Main()
+    {
+        if (!TestCorrectness())
+            return Fail;
+
+        PrintThroughput();
+
+        return Pass;
+    }
+}
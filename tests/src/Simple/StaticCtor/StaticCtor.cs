@@ -0,0 +1,162 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+//
+
+
+using System;
+
+// Checks that class constructors run once, before the first access: a class constructor that throws keeps
+// failing on every later access instead of running again, class constructors that trigger each other in a
+// cycle see each other partially initialized instead of deadlocking, and one that collects the heap finishes.
+public class BringUpTest
+{
+    const int Pass = 100;
+    const int Fail = -1;
+
+    class Counted
+    {
+        public static int Runs;
+        public static int Value;
+
+        static Counted()
+        {
+            Runs++;
+            Value = 42;
+        }
+    }
+
+    // Counts the runs of Throws' class constructor. It can't live in Throws itself: once the class constructor
+    // has failed, every access to Throws throws, so the count couldn't be read back.
+    class ThrowsRuns
+    {
+        public static int Runs;
+    }
+
+    class Throws
+    {
+        public static int Value;
+
+        static Throws()
+        {
+            ThrowsRuns.Runs++;
+            if (ThrowsRuns.Runs > 0)
+                throw new Exception("Throws");
+            Value = 1;
+        }
+    }
+
+    class CycleA
+    {
+        public static int Value;
+        public static int SeenFromB;
+
+        static CycleA()
+        {
+            Value = 1;
+            SeenFromB = CycleB.SeenFromA;
+        }
+    }
+
+    class CycleB
+    {
+        public static int Value;
+        public static int SeenFromA;
+
+        static CycleB()
+        {
+            // CycleA's class constructor is running on this thread, so this sees its statics as they are now
+            SeenFromA = CycleA.Value + 10;
+            Value = 2;
+        }
+    }
+
+    class Collects
+    {
+        public static object Value;
+
+        static Collects()
+        {
+            Value = new object();
+            GC.Collect();
+        }
+    }
+
+    static bool TestRunsOnce()
+    {
+        if (Counted.Value != 42 || Counted.Value != 42 || Counted.Runs != 1)
+        {
+            Console.WriteLine("Class constructor ran " + Counted.Runs + " times");
+            return false;
+        }
+        return true;
+    }
+
+    static bool AccessThrows()
+    {
+        try
+        {
+            int value = Throws.Value;
+        }
+        catch (Exception)
+        {
+            return true;
+        }
+        return false;
+    }
+
+    static bool TestFailureIsSticky()
+    {
+        for (int i = 0; i < 3; i++)
+        {
+            if (!AccessThrows())
+            {
+                Console.WriteLine("Access " + i + " to a type whose class constructor failed didn't throw");
+                return false;
+            }
+        }
+
+        if (ThrowsRuns.Runs != 1)
+        {
+            Console.WriteLine("Failed class constructor ran " + ThrowsRuns.Runs + " times");
+            return false;
+        }
+        return true;
+    }
+
+    static bool TestCycle()
+    {
+        if (CycleA.Value != 1 || CycleA.SeenFromB != 11 || CycleB.Value != 2 || CycleB.SeenFromA != 11)
+        {
+            Console.WriteLine("Class constructors in a cycle saw the wrong values");
+            return false;
+        }
+        return true;
+    }
+
+    static bool TestCollect()
+    {
+        if (Collects.Value == null)
+        {
+            Console.WriteLine("Class constructor that collects the heap lost its statics");
+            return false;
+        }
+        return true;
+    }
+
+    public static int Main()
+    {
+        if (!TestRunsOnce())
+            return Fail;
+
+        if (!TestFailureIsSticky())
+            return Fail;
+
+        if (!TestCycle())
+            return Fail;
+
+        if (!TestCollect())
+            return Fail;
+
+        return Pass;
+    }
+}
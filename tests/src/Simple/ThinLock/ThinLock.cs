@@ -0,0 +1,207 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+//
+
+
+using System;
+using System.Threading;
+
+// Exercises the transitions between the thin lock in the object header and an inflated SyncTable entry:
+// recursion past what the header can count, hash codes taken while the thin lock is held, Wait/Pulse on a
+// thin-locked object, Exit of a lock that isn't held and reuse of the entries of dead objects.
+public class BringUpTest
+{
+    const int Pass = 100;
+    const int Fail = -1;
+
+    // The header counts up to 1023 recursive acquisitions, go well past that
+    const int DeepRecursion = 3000;
+
+    static bool ExitThrows(object obj)
+    {
+        try
+        {
+            Monitor.Exit(obj);
+        }
+        catch (SynchronizationLockException)
+        {
+            return true;
+        }
+
+        Console.WriteLine("Exit of a lock that isn't held didn't throw");
+        return false;
+    }
+
+    static bool TestRecursion()
+    {
+        object obj = new object();
+
+        for (int i = 0; i < DeepRecursion; i++)
+            Monitor.Enter(obj);
+
+        for (int i = 0; i < DeepRecursion; i++)
+        {
+            if (!Monitor.IsEntered(obj))
+            {
+                Console.WriteLine("Lock released after " + i + " of " + DeepRecursion + " exits");
+                return false;
+            }
+            Monitor.Exit(obj);
+        }
+
+        if (Monitor.IsEntered(obj))
+        {
+            Console.WriteLine("Lock still held after " + DeepRecursion + " exits");
+            return false;
+        }
+
+        return ExitThrows(obj);
+    }
+
+    static bool TestHashCodeWhileLocked()
+    {
+        // Thin lock first, the hash code moves both into a SyncTable entry
+        object obj = new object();
+        Monitor.Enter(obj);
+        Monitor.Enter(obj);
+        Monitor.Enter(obj);
+
+        int hashCode = obj.GetHashCode();
+        if (!Monitor.IsEntered(obj) || obj.GetHashCode() != hashCode)
+        {
+            Console.WriteLine("Taking the hash code of a thin-locked object lost the lock or the hash code");
+            return false;
+        }
+
+        Monitor.Exit(obj);
+        Monitor.Exit(obj);
+        if (!Monitor.IsEntered(obj))
+        {
+            Console.WriteLine("Inflation lost the recursion count");
+            return false;
+        }
+        Monitor.Exit(obj);
+
+        if (Monitor.IsEntered(obj) || obj.GetHashCode() != hashCode || !ExitThrows(obj))
+            return false;
+
+        // Hash code first, then the lock
+        object other = new object();
+        int otherHashCode = other.GetHashCode();
+        lock (other)
+        {
+            if (other.GetHashCode() != otherHashCode)
+            {
+                Console.WriteLine("Locking an object changed its hash code");
+                return false;
+            }
+        }
+
+        return other.GetHashCode() == otherHashCode;
+    }
+
+    static bool TestWaitPulse()
+    {
+        object obj = new object();
+        Monitor.Enter(obj);
+        Monitor.Enter(obj);
+
+        // Nobody pulses, so this times out and has to give the lock back with both levels
+        if (Monitor.Wait(obj, 0))
+        {
+            Console.WriteLine("Wait without a Pulse succeeded");
+            return false;
+        }
+
+        Monitor.Pulse(obj);
+        Monitor.PulseAll(obj);
+
+        Monitor.Exit(obj);
+        if (!Monitor.IsEntered(obj))
+        {
+            Console.WriteLine("Wait lost the recursion count");
+            return false;
+        }
+        Monitor.Exit(obj);
+
+        if (!ExitThrows(obj))
+            return false;
+
+        try
+        {
+            Monitor.Pulse(obj);
+        }
+        catch (SynchronizationLockException)
+        {
+            return true;
+        }
+
+        Console.WriteLine("Pulse of a lock that isn't held didn't throw");
+        return false;
+    }
+
+    static void InflateAndAbandon(int count)
+    {
+        // Leaves the objects locked so that a reused entry that kept its Lock would look held
+        for (int i = 0; i < count; i++)
+        {
+            object obj = new object();
+            Monitor.Enter(obj);
+            obj.GetHashCode();
+        }
+    }
+
+    static bool TestEntryReuse()
+    {
+        InflateAndAbandon(200);
+
+        GC.Collect();
+        GC.WaitForPendingFinalizers();
+        GC.Collect();
+
+        // Locking an object with a hash code inflates it. Use up the free entries so that the dead ones above
+        // get reclaimed and handed out again.
+        object[] objects = new object[1000];
+        for (int i = 0; i < objects.Length; i++)
+        {
+            object obj = new object();
+            int hashCode = obj.GetHashCode();
+
+            lock (obj)
+            {
+                if (obj.GetHashCode() != hashCode)
+                {
+                    Console.WriteLine("Reused SyncTable entry changed the hash code");
+                    return false;
+                }
+            }
+
+            if (Monitor.IsEntered(obj))
+            {
+                Console.WriteLine("Reused SyncTable entry was still locked");
+                return false;
+            }
+
+            objects[i] = obj;
+        }
+
+        return true;
+    }
+
+    public static int Main()
+    {
+        if (!TestRecursion())
+            return Fail;
+
+        if (!TestHashCodeWhileLocked())
+            return Fail;
+
+        if (!TestWaitPulse())
+            return Fail;
+
+        if (!TestEntryReuse())
+            return Fail;
+
+        return Pass;
+    }
+}